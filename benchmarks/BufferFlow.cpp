@@ -0,0 +1,126 @@
+#include "Mycelia.h"
+#include "dsp/BufferArena.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numBands = 4;
+    constexpr int numChannels = 2;
+
+    void fillWithNoise(juce::AudioBuffer<float> &buffer, juce::Random &random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+    }
+
+    // One block of noise per measured run, generated before the clock starts
+    std::vector<juce::AudioBuffer<float>> makeInputs(int numRuns, int numBufferChannels, int blockSize, juce::Random &random)
+    {
+        std::vector<juce::AudioBuffer<float>> inputs(static_cast<size_t>(numRuns), juce::AudioBuffer<float>(numBufferChannels, blockSize));
+        for (auto &input : inputs)
+        {
+            fillWithNoise(input, random);
+        }
+        return inputs;
+    }
+}
+
+// The band flow between the diffusion, the delay network and the output, with a copy at every
+// stage as before, and with each stage reading the previous one's buffers in place
+TEST_CASE ("Buffer flow")
+{
+    constexpr int blockSize = 512;
+
+    BufferArena arena;
+    arena.prepare(2 * numBands, numChannels, blockSize);
+    auto diffusionBuffers = arena.getBuffers(0, numBands);
+    auto delayBuffers = arena.getBuffers(numBands, numBands);
+
+    juce::Random random(1234);
+    juce::AudioBuffer<float> input(numChannels, blockSize);
+    juce::AudioBuffer<float> output(numChannels, blockSize);
+    fillWithNoise(input, random);
+
+    // Bytes read plus written per sample and band: a copy or in-place scale moves 2 floats, an add 3
+    constexpr auto copyBytesPerSample = (2 + 2 + 2 + 3) * sizeof(float);
+    constexpr auto zeroCopyBytesPerSample = (2 + 3) * sizeof(float);
+    WARN ("Bytes moved per sample frame: copy path " << copyBytesPerSample * numBands * numChannels
+          << ", zero-copy path " << zeroCopyBytesPerSample * numBands * numChannels);
+
+    // Input copied into every band, band copied into the delay stage, then scaled and added
+    BENCHMARK ("Copy path")
+    {
+        juce::dsp::AudioBlock<const float> inputBlock(input);
+        juce::dsp::AudioBlock<float> outputBlock(output);
+        outputBlock.clear();
+
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            juce::dsp::AudioBlock<float>(diffusionBuffers[band]).copyFrom(inputBlock);
+            juce::dsp::AudioBlock<float>(delayBuffers[band]).copyFrom(juce::dsp::AudioBlock<float>(diffusionBuffers[band]));
+            outputBlock.add(juce::dsp::AudioBlock<float>(delayBuffers[band]).multiplyBy(0.5f));
+        }
+        return output.getSample(0, 0);
+    };
+
+    // The delay stage reads the input in place, and the output accumulates from it
+    BENCHMARK ("Zero-copy path")
+    {
+        juce::dsp::AudioBlock<const float> inputBlock(input);
+        juce::dsp::AudioBlock<float> outputBlock(output);
+        outputBlock.clear();
+
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            juce::dsp::AudioBlock<float>(delayBuffers[band]).replaceWithProductOf(inputBlock, 0.5f);
+            outputBlock.add(juce::dsp::AudioBlock<float>(delayBuffers[band]));
+        }
+        return output.getSample(0, 0);
+    };
+}
+
+// The real path of a block through the plugin (MyceliaModel, the diffusion, the delay network and
+// the output node), at block sizes from mostly per-block overhead to mostly per-sample buffer flow
+TEST_CASE ("Process block performance")
+{
+    for (const auto blockSize : {32, 128, 512, 2048})
+    {
+        BENCHMARK_ADVANCED ("Process block (" + std::to_string(blockSize) + " samples)")
+        (Catch::Benchmark::Chronometer meter)
+        {
+            Mycelia plugin;
+            plugin.prepareToPlay(sampleRate, blockSize);
+
+            const auto numPluginChannels = plugin.getTotalNumOutputChannels();
+            juce::Random random(1234);
+            juce::AudioBuffer<float> buffer(numPluginChannels, blockSize);
+            juce::MidiBuffer midi;
+
+            // Run the network up to a steady state first, so every stage carries signal
+            for (int i = 0; i < static_cast<int>(sampleRate) / blockSize; ++i)
+            {
+                fillWithNoise(buffer, random);
+                plugin.processBlock(buffer, midi);
+            }
+
+            // Each run processes its own input in place
+            auto inputs = makeInputs(meter.runs(), numPluginChannels, blockSize, random);
+            meter.measure ([&] (int i) {
+                auto &input = inputs[static_cast<size_t>(i)];
+                plugin.processBlock(input, midi);
+                return input.getSample(0, 0);
+            });
+
+            plugin.releaseResources();
+        };
+    }
+}
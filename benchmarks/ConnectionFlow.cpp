@@ -0,0 +1,137 @@
+#include "dsp/ConnectionMatrix.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int nodesPerBand = 8;
+    constexpr float connectionDensity = 0.1f;
+
+    // The nested [band][proc][srcBand][srcProc] layout the connections were kept in before
+    using NestedConnections = std::vector<std::vector<std::vector<std::vector<float>>>>;
+
+    struct Network
+    {
+        int numBands = 0;
+        NestedConnections nested;
+        std::vector<std::vector<float>> nestedLevels;   // [band][proc]
+        ConnectionMatrix matrix;
+        std::vector<float> levels;                      // [node]
+        std::vector<float> flows;                       // [node]
+    };
+
+    Network makeNetwork(int numNodes, juce::Random &random)
+    {
+        Network network;
+        network.numBands = numNodes / nodesPerBand;
+        const auto numBands = static_cast<size_t>(network.numBands);
+
+        network.nested.assign(numBands, std::vector<std::vector<std::vector<float>>>(nodesPerBand,
+                              std::vector<std::vector<float>>(numBands, std::vector<float>(nodesPerBand, 0.0f))));
+        network.nestedLevels.assign(numBands, std::vector<float>(nodesPerBand, 0.0f));
+        network.matrix.resize(numNodes);
+        network.levels.assign(static_cast<size_t>(numNodes), 0.0f);
+        network.flows.assign(static_cast<size_t>(numNodes), 0.0f);
+
+        for (int target = 0; target < numNodes; ++target)
+        {
+            network.levels[static_cast<size_t>(target)] = random.nextFloat();
+            network.nestedLevels[static_cast<size_t>(target / nodesPerBand)][static_cast<size_t>(target % nodesPerBand)] = network.levels[static_cast<size_t>(target)];
+
+            for (int source = 0; source < numNodes; ++source)
+            {
+                const auto weight = (random.nextFloat() < connectionDensity) ? 0.1f * random.nextFloat() : 0.0f;
+                network.matrix.set(target, source, weight);
+                network.nested[static_cast<size_t>(target / nodesPerBand)][static_cast<size_t>(target % nodesPerBand)]
+                              [static_cast<size_t>(source / nodesPerBand)][static_cast<size_t>(source % nodesPerBand)] = weight;
+            }
+        }
+        return network;
+    }
+
+    // One full scan of the tensor per target node
+    float nestedSiblingFlow(const Network &network, int targetBand, int targetProc)
+    {
+        float flow = 0.0f;
+        for (int sourceBand = 0; sourceBand < network.numBands; ++sourceBand)
+        {
+            for (int sourceProc = 0; sourceProc < nodesPerBand; ++sourceProc)
+            {
+                const auto weight = network.nested[static_cast<size_t>(targetBand)][static_cast<size_t>(targetProc)]
+                                                  [static_cast<size_t>(sourceBand)][static_cast<size_t>(sourceProc)];
+                if (weight > 0.0f)
+                {
+                    flow += weight * network.nestedLevels[static_cast<size_t>(sourceBand)][static_cast<size_t>(sourceProc)];
+                }
+            }
+        }
+        return flow;
+    }
+
+    // Sum the outgoing connections of a node, then scale them
+    void nestedNormalise(Network &network, int band, int proc)
+    {
+        float sum = 0.0f;
+        for (auto &target : network.nested)
+        {
+            for (auto &targetProc : target)
+            {
+                sum += targetProc[static_cast<size_t>(band)][static_cast<size_t>(proc)];
+            }
+        }
+        for (auto &target : network.nested)
+        {
+            for (auto &targetProc : target)
+            {
+                targetProc[static_cast<size_t>(band)][static_cast<size_t>(proc)] /= (sum + 0.1f);
+            }
+        }
+    }
+}
+
+TEST_CASE ("Connection flow scaling")
+{
+    juce::Random random(1234);
+
+    for (const auto numNodes : {32, 64, 128, 256, 512, 1024})
+    {
+        auto network = makeNetwork(numNodes, random);
+        const auto suffix = " (" + std::to_string(numNodes) + " nodes)";
+
+        BENCHMARK ("Sibling flows, nested scan" + suffix)
+        {
+            float total = 0.0f;
+            for (int band = 0; band < network.numBands; ++band)
+            {
+                for (int proc = 0; proc < nodesPerBand; ++proc)
+                {
+                    total += nestedSiblingFlow(network, band, proc);
+                }
+            }
+            return total;
+        };
+
+        BENCHMARK ("Sibling flows, matrix-vector product" + suffix)
+        {
+            network.matrix.multiply(network.levels.data(), network.flows.data(), numNodes);
+            return network.flows[0];
+        };
+
+        // Normalise both nodes of a touched pair, as the growth timer does
+        BENCHMARK ("Normalise a pair, nested scan" + suffix)
+        {
+            nestedNormalise(network, 0, 1);
+            nestedNormalise(network, network.numBands - 1, 2);
+            return network.nested[0][0][0][1];
+        };
+
+        BENCHMARK ("Normalise a pair, contiguous outgoing connections" + suffix)
+        {
+            network.matrix.normaliseOutgoing(1, 0.1f);
+            network.matrix.normaliseOutgoing(numNodes - nodesPerBand + 2, 0.1f);
+            return network.matrix.get(0, 1);
+        };
+    }
+}
@@ -0,0 +1,77 @@
+#include "dsp/PartitionedConvolver.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int numBands = 4;
+    constexpr int numChannels = 2;
+    constexpr int responseLength = 48000;
+
+    // Dense decaying noise for every band pair, the worst case for the direct-form taps
+    std::vector<juce::AudioBuffer<float>> makeResponses(juce::Random &random)
+    {
+        std::vector<juce::AudioBuffer<float>> responses;
+        for (int in = 0; in < numBands; ++in)
+        {
+            juce::AudioBuffer<float> response(numBands, responseLength);
+            for (int out = 0; out < numBands; ++out)
+            {
+                for (int i = 0; i < responseLength; ++i)
+                {
+                    response.setSample(out, i, (random.nextFloat() - 0.5f) * std::exp(-4.0f * static_cast<float>(i) / responseLength));
+                }
+            }
+            responses.push_back(std::move(response));
+        }
+        return responses;
+    }
+}
+
+// The frozen network's convolution, one second of dense responses between all 4 bands
+TEST_CASE ("Freeze convolver")
+{
+    juce::Random random(1234);
+    const auto responses = makeResponses(random);
+
+    WARN ("Direct-form taps per band pair: at most " << PartitionedConvolver::headSize
+          << ", then " << PartitionedConvolver::partitionSize / PartitionedConvolver::headSize - 1 << " head partitions of "
+          << PartitionedConvolver::headSize << " samples");
+
+    for (const auto blockSize : {64, 512})
+    {
+        BENCHMARK_ADVANCED ("Convolve (" + std::to_string(blockSize) + " samples)")
+        (Catch::Benchmark::Chronometer meter)
+        {
+            PartitionedConvolver convolver;
+            convolver.prepare(numChannels);
+            convolver.setImpulseResponses(responses, numBands, responseLength);
+
+            // One block of noise per band and run, generated before the clock starts
+            std::vector<std::vector<juce::AudioBuffer<float>>> inputs(static_cast<size_t>(meter.runs()));
+            for (auto &bands : inputs)
+            {
+                for (int band = 0; band < numBands; ++band)
+                {
+                    bands.emplace_back(numChannels, blockSize);
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            bands.back().setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                        }
+                    }
+                }
+            }
+
+            meter.measure ([&] (int run) {
+                auto &bands = inputs[static_cast<size_t>(run)];
+                convolver.process(BufferSpan(bands), numBands);
+                return bands[0].getSample(0, 0);
+            });
+        };
+    }
+}
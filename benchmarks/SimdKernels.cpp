@@ -0,0 +1,144 @@
+#include "dsp/SimdKernels.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Fits in L1, so the loops are bound by the arithmetic rather than memory
+    constexpr int numSamples = 4096;
+    constexpr int numRepeats = 2000;
+
+    std::vector<float> makeNoise()
+    {
+        juce::Random random(1234);
+        std::vector<float> data(static_cast<size_t>(numSamples));
+        for (auto &sample : data)
+        {
+            sample = random.nextFloat() * 2.0f - 1.0f;
+        }
+        return data;
+    }
+
+    std::vector<const SimdKernels::Table *> getAvailableTables()
+    {
+        std::vector<const SimdKernels::Table *> tables;
+        for (size_t level = 0; level < SimdKernels::numLevels; ++level)
+        {
+            if (auto *table = SimdKernels::getTable(static_cast<SimdKernels::Level>(level)))
+            {
+                tables.push_back(table);
+            }
+        }
+        return tables;
+    }
+
+    // The loops the kernels would be if they were not vectorised
+    float getScalarPeak(const float *data, int n)
+    {
+        auto peak = 0.0f;
+        for (int i = 0; i < n; ++i)
+        {
+            const auto level = data[i] < 0.0f ? -data[i] : data[i];
+            peak = level > peak ? level : peak;
+        }
+        return peak;
+    }
+
+    float getScalarLevelRange(const float *data, int n)
+    {
+        auto low = data[0] < 0.0f ? -data[0] : data[0];
+        auto high = low;
+        for (int i = 1; i < n; ++i)
+        {
+            const auto level = data[i] < 0.0f ? -data[i] : data[i];
+            low = level < low ? level : low;
+            high = level > high ? level : high;
+        }
+        return low + high;
+    }
+
+    // Best of a few runs of numRepeats calls, in seconds
+    template <typename Function>
+    double timeBest(Function &&function)
+    {
+        auto best = std::numeric_limits<double>::max();
+        for (int run = 0; run < 5; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            auto sink = 0.0f;
+            for (int i = 0; i < numRepeats; ++i)
+            {
+                sink += function();
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed + (sink == -1.0f ? 1.0 : 0.0));
+        }
+        return best;
+    }
+}
+
+TEST_CASE ("SIMD kernel levels")
+{
+    const auto data = makeNoise();
+    auto destination = makeNoise();
+
+    BENCHMARK ("Peak, scalar loop")
+    {
+        return getScalarPeak(data.data(), numSamples);
+    };
+
+    BENCHMARK ("Level range, scalar loop")
+    {
+        return getScalarLevelRange(data.data(), numSamples);
+    };
+
+    for (auto *table : getAvailableTables())
+    {
+        const std::string name = SimdKernels::getLevelName(table->level);
+
+        BENCHMARK ("Peak, " + name)
+        {
+            return table->getPeak(data.data(), numSamples);
+        };
+
+        BENCHMARK ("Level range, " + name)
+        {
+            float min = 0.0f, max = 0.0f;
+            table->getLevelRange(data.data(), numSamples, true, min, max);
+            return min + max;
+        };
+
+        BENCHMARK ("Routing mix, " + name)
+        {
+            table->addWithGain(destination.data(), data.data(), 0.5f, numSamples);
+            return destination[0];
+        };
+    }
+}
+
+// The speed-up of every level over the plain loops, reported rather than checked: timings are
+// too noisy on shared machines, and tests/SimdKernels.cpp checks the results of every level
+TEST_CASE ("SIMD kernel speed-ups")
+{
+    const auto data = makeNoise();
+    const auto scalarPeak = timeBest([&] { return getScalarPeak(data.data(), numSamples); });
+    const auto scalarRange = timeBest([&] { return getScalarLevelRange(data.data(), numSamples); });
+
+    for (auto *table : getAvailableTables())
+    {
+        const auto peak = timeBest([&] { return table->getPeak(data.data(), numSamples); });
+        const auto range = timeBest([&] {
+            float min = 0.0f, max = 0.0f;
+            table->getLevelRange(data.data(), numSamples, false, min, max);
+            return min + max;
+        });
+
+        WARN ("Level " << SimdKernels::getLevelName(table->level) << ": peak " << scalarPeak / peak
+              << "x, level range " << scalarRange / range << "x the scalar loops");
+    }
+}
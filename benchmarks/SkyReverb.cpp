@@ -0,0 +1,77 @@
+#include "dsp/ControlScheduler.h"
+#include "dsp/Sky.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <vector>
+
+namespace
+{
+    constexpr int blockSize = 512;
+
+    void benchmarkSky(Catch::Benchmark::Chronometer meter, Sky::Engine engine, bool fineBlocks)
+    {
+        ControlScheduler scheduler;
+        Sky sky(scheduler);
+
+        ProcessingQuality quality;
+        quality.fineReverbBlocks = fineBlocks;
+        sky.setQuality(quality);
+        sky.setEngine(engine);
+        sky.setBlocksAligned(true);
+        sky.prepare({48000.0, static_cast<juce::uint32>(blockSize), 2});
+
+        // One block of noise per run, generated before the clock starts and processed in place
+        juce::Random random(1234);
+        std::vector<juce::AudioBuffer<float>> inputs(static_cast<size_t>(meter.runs()), juce::AudioBuffer<float>(2, blockSize));
+        for (auto &input : inputs)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                }
+            }
+        }
+
+        meter.measure ([&] (int run) {
+            auto &input = inputs[static_cast<size_t>(run)];
+            juce::dsp::AudioBlock<float> block(input);
+            sky.process(juce::dsp::ProcessContextReplacing<float>(block));
+            return input.getSample(0, 0);
+        });
+    }
+}
+
+TEST_CASE ("Sky reverb engines")
+{
+    BENCHMARK_ADVANCED ("LiftedReverb2, 16-sample blocks")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        benchmarkSky(meter, Sky::Engine::lifted, true);
+    };
+
+    BENCHMARK_ADVANCED ("LiftedReverb2, 32-sample blocks")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        benchmarkSky(meter, Sky::Engine::lifted, false);
+    };
+
+    BENCHMARK_ADVANCED ("FDN, 4 lines")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        benchmarkSky(meter, Sky::Engine::fdn4, false);
+    };
+
+    BENCHMARK_ADVANCED ("FDN, 8 lines")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        benchmarkSky(meter, Sky::Engine::fdn8, false);
+    };
+
+    BENCHMARK_ADVANCED ("FDN, 16 lines")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        benchmarkSky(meter, Sky::Engine::fdn16, false);
+    };
+}
@@ -18,20 +18,8 @@ Mycelia::Mycelia()
 {
     FOLEYS_SET_SOURCE_PATH(RES_FOLDER_PATH);
 
-    myceliaModel.addParamListener(IDs::treeSize, this);
-    myceliaModel.addParamListener(IDs::treeDensity, this);
-    //
-    myceliaModel.addParamListener(IDs::stretch, this);
+    // The model polls the parameters itself, the GUI only follows a manual scarcity/abundance override
     myceliaModel.addParamListener(IDs::scarcityAbundance, this);
-    myceliaModel.addParamListener(IDs::foldPosition, this);
-    myceliaModel.addParamListener(IDs::foldWindowShape, this);
-    myceliaModel.addParamListener(IDs::foldWindowSize, this);
-    //
-    myceliaModel.addParamListener(IDs::entanglement, this);
-    myceliaModel.addParamListener(IDs::growthRate, this);
-    //
-    myceliaModel.addParamListener(IDs::skyHumidity, this);
-    myceliaModel.addParamListener(IDs::skyHeight, this);
 
     // Create analyzers and meters
     oscilloscope = magicState.createAndAddObject<foleys::MagicOscilloscope>(IDs::oscilloscope);
@@ -49,6 +37,9 @@ Mycelia::Mycelia()
     scarAbundAutoVisibility.referTo(magicState.getPropertyAsValue("scarcityAbundanceAutoVisibility"));
     scarAbundAutoVisibility.addListener(this);
 
+    qualityLevelVal.referTo(magicState.getPropertyAsValue("cpuQualityLevel"));
+    overrunCountVal.referTo(magicState.getPropertyAsValue("cpuOverruns"));
+
     delayDuckLevel.addListener(this);
     dryWetLevel.addListener(this);
 
@@ -81,8 +72,7 @@ Mycelia::~Mycelia()
 
 void Mycelia::parameterChanged(const juce::String &param, float value)
 {
-    // Pass the parameter change to the model
-    myceliaModel.parameterChanged(param, value);
+    juce::ignoreUnused(value);
     if (param == IDs::scarcityAbundance)
     {
         scarAbundAuto.setValue("Overridden");
@@ -186,8 +176,13 @@ void Mycelia::prepareToPlay(double sampleRate, int samplesPerBlock)
 
     inputMeter->setNumChannels(numChannels);
     outputMeter->setNumChannels(numChannels);
+    outputBuffer.setSize(numChannels, samplesPerBlock);
+    myceliaModel.setRealtime(!isNonRealtime());
     myceliaModel.prepareToPlay(spec);
 
+    // Report the latency of the internal rate conversion (if any)
+    setLatencySamples(myceliaModel.getLatencySamples());
+
     // MAGIC GUI: this will setup all internals like MagicPlotSources etc.
     oscilloscope->prepareToPlay(sampleRate, samplesPerBlock);
     inputAnalyser->prepareToPlay(sampleRate, samplesPerBlock);
@@ -203,6 +198,14 @@ void Mycelia::releaseResources()
     myceliaModel.releaseResources();
 }
 
+void Mycelia::setNonRealtime(bool isNonRealtime) noexcept
+{
+    foleys::MagicProcessor::setNonRealtime(isNonRealtime);
+
+    // Bounces switch to the High tier (applied when the host prepares again, or by the GUI timer)
+    myceliaModel.setRealtime(!isNonRealtime);
+}
+
 bool Mycelia::isBusesLayoutSupported(const BusesLayout &layouts) const
 {
 #if JucePlugin_IsMidiEffect
@@ -227,7 +230,7 @@ bool Mycelia::isBusesLayoutSupported(const BusesLayout &layouts) const
 void Mycelia::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages)
 {
     // Process MIDI messages
-    processMidiMessages(midiMessages);
+    processMidiMessages(midiMessages, buffer.getNumSamples());
 
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
@@ -247,21 +250,19 @@ void Mycelia::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &m
     juce::dsp::AudioBlock<float> attBlock(buffer);
     attBlock.multiplyBy(0.5f);
 
-    // Copy the samples to the input buffer
-    inputBuffer = buffer;
+    // GUI Magic: update the input meter and analyzer before the block is processed in place
+    inputAnalyser->pushSamples(buffer);
+    inputMeter->pushSamples(buffer);
 
     // Process audio block
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
     myceliaModel.process(context);
 
-    // Copy the processed samples to the output buffer
-    outputBuffer = buffer;
-
-    // GUI Magic: update the input/output meters and analyzers
-    inputAnalyser->pushSamples(inputBuffer);
-    inputMeter->pushSamples(inputBuffer);
+    // Copy the processed samples to the output buffer (sized in prepareToPlay, never reallocated here)
+    outputBuffer.makeCopyOf(buffer, true);
 
+    // GUI Magic: update the output meter and analyzer
     outputMeter->pushSamples(outputBuffer);
     outputAnalyser->pushSamples(outputBuffer);
 }
@@ -285,17 +286,18 @@ void Mycelia::setStateInformation(const void *data, int sizeInBytes)
 
 //==============================================================================
 
-void Mycelia::processMidiMessages(const juce::MidiBuffer &midiMessages)
+void Mycelia::processMidiMessages(const juce::MidiBuffer &midiMessages, int numSamples)
 {
-    // Get the current time in seconds
-    const double currentTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    // MIDI timing comes from the sample clock, so it stays exact whatever the thread scheduling
+    const auto sampleRate = juce::jmax(1.0, getSampleRate());
+    const double blockStartTime = static_cast<double>(midiSamplePosition) / sampleRate;
 
     // Check for MIDI clock timeout
-    if (isMidiClockSyncActive() && (currentTime - lastMidiClockTime) > kMidiClockTimeout)
+    if (isMidiClockSyncActive() && (blockStartTime - lastMidiClockTime) > kMidiClockTimeout)
     {
-        midiClockDetected = false;
+        midiClockActive = false;
         midiClockCounter = 0;
-        myceliaModel.setParameterExplicitly(IDs::tempoValue, kDefaultTempo);
+        queueMidiParameterChange(MyceliaModel::ParamIndex::tempoValue, static_cast<float>(kDefaultTempo), 0);
     }
 
     // Forward MIDI messages to the DelayNetwork for MIDI clock sync processing
@@ -308,7 +310,7 @@ void Mycelia::processMidiMessages(const juce::MidiBuffer &midiMessages)
             // Check for MIDI clock messages
             if (message.isMidiClock())
             {
-                processMidiClockMessage(message, currentTime);
+                processMidiClockMessage(message, blockStartTime + metadata.samplePosition / sampleRate);
             }
             // Also handle MIDI start/stop messages for transport control
             else if (message.isMidiStart() || message.isMidiContinue())
@@ -319,16 +321,18 @@ void Mycelia::processMidiMessages(const juce::MidiBuffer &midiMessages)
             else if (message.isMidiStop())
             {
                 // Stop tracking when transport stops
-                midiClockDetected.setValue(false);
+                midiClockActive = false;
                 midiClockCounter = 0;
             }
             // Handle MIDI CC messages
             else if (message.isController())
             {
-                processMidiCcMessage(message);
+                processMidiCcMessage(message, metadata.samplePosition);
             }
         }
     }
+
+    midiSamplePosition += numSamples;
 }
 
 void Mycelia::processMidiClockMessage(const juce::MidiMessage &midiMessage, double currentTime)
@@ -340,7 +344,7 @@ void Mycelia::processMidiClockMessage(const juce::MidiMessage &midiMessage, doub
     {
         if (!isMidiClockSyncActive())
         {
-            midiClockDetected.setValue(true);
+            midiClockActive = true;
             // First complete set of clock messages received, start tracking from here
         }
         else
@@ -353,7 +357,70 @@ void Mycelia::processMidiClockMessage(const juce::MidiMessage &midiMessage, doub
     }
 }
 
-void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
+void Mycelia::queueMidiParameterChange(MyceliaModel::ParamIndex index, float value, int sampleOffset)
+{
+    // The DSP follows within this block, the parameter (and with it the host and the GUI) on the message thread
+    myceliaModel.addParameterEvent(index, value, sampleOffset);
+    midiParameterQueue.push({static_cast<int>(index), value, sampleOffset});
+}
+
+void Mycelia::applyMidiParameterChanges()
+{
+    // Only the latest value of each parameter matters, the DSP has followed every step already
+    std::array<float, MyceliaModel::numParams> latestValues {};
+    std::array<bool, MyceliaModel::numParams> changed {};
+
+    ParameterEvent event;
+    while (midiParameterQueue.pop(event))
+    {
+        latestValues[static_cast<size_t>(event.paramIndex)] = event.value;
+        changed[static_cast<size_t>(event.paramIndex)] = true;
+    }
+
+    for (size_t i = 0; i < MyceliaModel::numParams; ++i)
+    {
+        if (!changed[i])
+        {
+            continue;
+        }
+
+        const auto index = static_cast<MyceliaModel::ParamIndex>(i);
+        myceliaModel.setParameterFromEvent(index, latestValues[i]);
+
+        if (const auto *property = getMidiPropertyName(index))
+        {
+            magicState.getPropertyAsValue(property).setValue(latestValues[i]);
+        }
+    }
+}
+
+const char *Mycelia::getMidiPropertyName(MyceliaModel::ParamIndex index)
+{
+    // GUI properties that mirror the parameters controlled by MIDI CCs
+    switch (index)
+    {
+        case MyceliaModel::ParamIndex::bandpassFreq:      return "bandpassFreq";
+        case MyceliaModel::ParamIndex::bandpassWidth:     return "bandpassWidth";
+        case MyceliaModel::ParamIndex::preampLevel:       return "preampLevel";
+        case MyceliaModel::ParamIndex::reverbMix:         return "reverbMix";
+        case MyceliaModel::ParamIndex::skyHumidity:       return "skyHumidity";
+        case MyceliaModel::ParamIndex::skyHeight:         return "skyHeight";
+        case MyceliaModel::ParamIndex::treeSize:          return "treeSize";
+        case MyceliaModel::ParamIndex::treeDensity:       return "treeDensity";
+        case MyceliaModel::ParamIndex::stretch:           return "stretch";
+        case MyceliaModel::ParamIndex::scarcityAbundance: return "scarcityAbundance";
+        case MyceliaModel::ParamIndex::entanglement:      return "entanglement";
+        case MyceliaModel::ParamIndex::growthRate:        return "growthRate";
+        case MyceliaModel::ParamIndex::dryWet:            return "dryWetMix";
+        case MyceliaModel::ParamIndex::delayDuck:         return "delayDuck";
+        case MyceliaModel::ParamIndex::foldPosition:      return "foldPosition";
+        case MyceliaModel::ParamIndex::foldWindowShape:   return "foldWindowShape";
+        case MyceliaModel::ParamIndex::foldWindowSize:    return "foldWindowSize";
+        default:                                          return nullptr;
+    }
+}
+
+void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage, int sampleOffset)
 {
     // Get the controller number and value
     int ccNumber = midiMessage.getControllerNumber();
@@ -368,8 +435,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc0Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc0Value);
             auto bandpassFreqVal = ParameterRanges::denormalizeParameter(ParameterRanges::bandpassFrequencyRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::bandpassFreq, bandpassFreqVal);
-            magicState.getPropertyAsValue("bandpassFreq").setValue(bandpassFreqVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::bandpassFreq, bandpassFreqVal, sampleOffset);
             break;
         }
         case 1:
@@ -378,8 +444,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc1Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc1Value);
             auto bandpassWidthVal = ParameterRanges::denormalizeParameter(ParameterRanges::bandpassWidthRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::bandpassWidth, bandpassWidthVal);
-            magicState.getPropertyAsValue("bandpassWidth").setValue(bandpassWidthVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::bandpassWidth, bandpassWidthVal, sampleOffset);
             break;
         }
         case 2:
@@ -388,8 +453,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc2Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc2Value);
             auto preampLevelVal = ParameterRanges::denormalizeParameter(ParameterRanges::preampLevelRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::preampLevel, preampLevelVal);
-            magicState.getPropertyAsValue("preampLevel").setValue(preampLevelVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::preampLevel, preampLevelVal, sampleOffset);
             break;
         }
         case 3:
@@ -398,12 +462,9 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc3Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc3Value);
             auto reverbMixVal = ParameterRanges::denormalizeParameter(ParameterRanges::reverbMixRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::reverbMix, reverbMixVal);
-            magicState.getPropertyAsValue("reverbMix").setValue(reverbMixVal);
-            myceliaModel.setParameterExplicitly(IDs::skyHumidity, reverbMixVal);
-            magicState.getPropertyAsValue("skyHumidity").setValue(reverbMixVal);
-            myceliaModel.setParameterExplicitly(IDs::skyHeight, (1.0f - reverbMixVal));
-            magicState.getPropertyAsValue("skyHeight").setValue((1.0f - reverbMixVal));
+            queueMidiParameterChange(MyceliaModel::ParamIndex::reverbMix, reverbMixVal, sampleOffset);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::skyHumidity, reverbMixVal, sampleOffset);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::skyHeight, (1.0f - reverbMixVal), sampleOffset);
             break;
         }
         case 4:
@@ -412,8 +473,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc4Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc4Value);
             auto treeSizeVal = ParameterRanges::denormalizeParameter(ParameterRanges::treeSizeRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::treeSize, treeSizeVal);
-            magicState.getPropertyAsValue("treeSize").setValue(treeSizeVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::treeSize, treeSizeVal, sampleOffset);
             break;
         }
         case 5:
@@ -422,8 +482,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc5Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc5Value);
             auto treeDensityVal = ParameterRanges::denormalizeParameter(ParameterRanges::treeDensityRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::treeDensity, treeDensityVal);
-            magicState.getPropertyAsValue("treeDensity").setValue(treeDensityVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::treeDensity, treeDensityVal, sampleOffset);
             break;
         }
         case 6:
@@ -432,8 +491,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc6Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc6Value);
             auto stretchVal = ParameterRanges::denormalizeParameter(ParameterRanges::stretchRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::stretch, stretchVal);
-            magicState.getPropertyAsValue("stretch").setValue(stretchVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::stretch, stretchVal, sampleOffset);
             break;
         }
         case 7:
@@ -442,9 +500,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc7Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc7Value);
             auto scarcityAbundanceVal = ParameterRanges::denormalizeParameter(ParameterRanges::scarcityAbundanceRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::scarcityAbundance, scarcityAbundanceVal);
-            scarAbundAuto.setValue("Overridden");
-            magicState.getPropertyAsValue("scarcityAbundance").setValue(scarcityAbundanceVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::scarcityAbundance, scarcityAbundanceVal, sampleOffset);
             break;
         }
         case 8:
@@ -453,8 +509,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc8Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc8Value);
             auto entanglementVal = ParameterRanges::denormalizeParameter(ParameterRanges::entanglementRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::entanglement, entanglementVal);
-            magicState.getPropertyAsValue("entanglement").setValue(entanglementVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::entanglement, entanglementVal, sampleOffset);
             break;
         }
         case 9:
@@ -463,8 +518,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc9Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc9Value);
             auto growthRateVal = ParameterRanges::denormalizeParameter(ParameterRanges::growthRateRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::growthRate, growthRateVal);
-            magicState.getPropertyAsValue("growthRate").setValue(growthRateVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::growthRate, growthRateVal, sampleOffset);
             break;
         }
         case 10:
@@ -473,8 +527,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc10Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc10Value);
             auto skyHumidityVal = ParameterRanges::denormalizeParameter(ParameterRanges::skyHumidityRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::skyHumidity, skyHumidityVal);
-            magicState.getPropertyAsValue("skyHumidity").setValue(skyHumidityVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::skyHumidity, skyHumidityVal, sampleOffset);
             break;
         }
         //
@@ -484,8 +537,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc11Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc11Value);
             auto skyHumidityVal = ParameterRanges::denormalizeParameter(ParameterRanges::skyHumidityRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::skyHumidity, skyHumidityVal);
-            magicState.getPropertyAsValue("skyHumidity").setValue(skyHumidityVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::skyHumidity, skyHumidityVal, sampleOffset);
             break;
         }
         //
@@ -495,8 +547,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc12Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc12Value);
             auto dryWetMixVal = ParameterRanges::denormalizeParameter(ParameterRanges::dryWetRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::dryWet, dryWetMixVal);
-            magicState.getPropertyAsValue("dryWetMix").setValue(dryWetMixVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::dryWet, dryWetMixVal, sampleOffset);
             break;
         }
         //
@@ -507,8 +558,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc13Value);
             auto delayDuckVal = ParameterRanges::denormalizeParameter(ParameterRanges::delayDuckRange, normCcValue);
             // Save the current delay duck level for GUI updates
-            myceliaModel.setParameterExplicitly(IDs::delayDuck, delayDuckVal);
-            magicState.getPropertyAsValue("delayDuck").setValue(delayDuckVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::delayDuck, delayDuckVal, sampleOffset);
             break;
         }
         //
@@ -518,8 +568,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc16Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc16Value);
             auto foldPositionVal = ParameterRanges::denormalizeParameter(ParameterRanges::foldPositionRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::foldPosition, foldPositionVal);
-            magicState.getPropertyAsValue("foldPosition").setValue(foldPositionVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::foldPosition, foldPositionVal, sampleOffset);
             break;
         }
         //
@@ -529,8 +578,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             midiCc17Value = ParameterRanges::midiCcValueRange.snapToLegalValue(ccValue);
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc17Value);
             auto windowShapeVal = ParameterRanges::denormalizeParameter(ParameterRanges::foldWindowShapeRange, normCcValue);
-            myceliaModel.setParameterExplicitly(IDs::foldWindowShape, windowShapeVal);
-            magicState.getPropertyAsValue("foldWindowShape").setValue(windowShapeVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::foldWindowShape, windowShapeVal, sampleOffset);
             break;
         }
         //
@@ -541,8 +589,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
             auto normCcValue = ParameterRanges::normalizeParameter(ParameterRanges::midiCcValueRange, midiCc18Value);
             // Map the normalized value in opposite direction
             auto windowSizeVal = ParameterRanges::denormalizeParameter(ParameterRanges::foldPositionRange, (1.0f - normCcValue));
-            myceliaModel.setParameterExplicitly(IDs::foldWindowSize, windowSizeVal);
-            magicState.getPropertyAsValue("foldWindowSize").setValue(windowSizeVal);
+            queueMidiParameterChange(MyceliaModel::ParamIndex::foldWindowSize, windowSizeVal, sampleOffset);
             break;
         }
         case 19:
@@ -562,7 +609,7 @@ void Mycelia::processMidiCcMessage(const juce::MidiMessage &midiMessage)
 bool Mycelia::isMidiClockSyncActive() const
 {
     // Forward the request to the DelayNetwork
-    return static_cast<bool>(midiClockDetected.getValue());
+    return midiClockActive.load();
 }
 
 bool Mycelia::isScarcityAbundanceOverridden() const
@@ -713,6 +760,19 @@ void Mycelia::timerCallback(const int timerID)
 {
     if (timerID == kGuiTimerId)
     {
+        // Re-prepare the model if an engine option changed the processing rate or quality
+        if (myceliaModel.isReconfigurationPending())
+        {
+            reconfigureEngine();
+        }
+
+        // Catch the parameters and the GUI up with the MIDI received by the audio thread
+        applyMidiParameterChanges();
+        if (static_cast<bool>(midiClockDetected.getValue()) != isMidiClockSyncActive())
+        {
+            midiClockDetected.setValue(isMidiClockSyncActive());
+        }
+
         // Get the current delay duck and dry/wet level (valueChanged() will trigger updating the GUI)
         delayDuckLevel.setValue(myceliaModel.getParameterValue(IDs::delayDuck));
         dryWetLevel.setValue(myceliaModel.getParameterValue(IDs::dryWet));
@@ -722,6 +782,10 @@ void Mycelia::timerCallback(const int timerID)
         windowShapeVal.setValue(myceliaModel.getParameterValue(IDs::foldWindowShape));
         windowPosVal.setValue(myceliaModel.getParameterValue(IDs::foldPosition));
 
+        // Publish the CPU governor state
+        qualityLevelVal.setValue(myceliaModel.getQualityLevel());
+        overrunCountVal.setValue(myceliaModel.getOverrunCount());
+
         //////////////
         // Get the current band states
         auto& bandStates = myceliaModel.getBandStates();
@@ -743,7 +807,7 @@ void Mycelia::timerCallback(const int timerID)
 
                     networkGraph->setStretch(stretchLevel);
                     networkGraph->setNumActiveBands(numActiveBands);
-                    networkGraph->setBandStates(bandStates);
+                    networkGraph->setBandStates(bandStates, myceliaModel.getConnections());
                     networkGraph->setTreePositions(treePositions);
                 }
             }
@@ -837,6 +901,19 @@ void Mycelia::timerCallback(const int timerID)
     }
 }
 
+void Mycelia::reconfigureEngine()
+{
+    if (getSampleRate() <= 0.0)
+    {
+        return;
+    }
+
+    // Hold the audio callback while the model is prepared again with the new engine options
+    suspendProcessing(true);
+    prepareToPlay(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
+}
+
 void Mycelia::updateTreePositionInfo()
 {
     // Update the GUI to reflect the tree positions and size
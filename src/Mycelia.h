@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MyceliaModel.h"
+#include "util/ParameterEventQueue.h"
 
 #include <juce_audio_plugin_client/juce_audio_plugin_client.h>
 #include <juce_audio_processors/juce_audio_processors.h>
@@ -34,6 +35,7 @@ class Mycelia :
         void initialiseBuilder(foleys::MagicGUIBuilder &builder) override;
         void prepareToPlay(double sampleRate, int samplesPerBlock) override;
         void releaseResources() override;
+        void setNonRealtime(bool isNonRealtime) noexcept override;
 
         void parameterChanged(const juce::String &param, float value) override;
 
@@ -95,14 +97,27 @@ class Mycelia :
         juce::Value treeSizeVal{0.5f};           // Initial tree size
         juce::Value treeStretchVal{0.5f};       // Initial tree stretch value
 
+        // CPU governor state
+        juce::Value qualityLevelVal{0};
+        juce::Value overrunCountVal{0};
+
         void valueChanged(juce::Value &value) override;
 
         // Process MIDI messages
-        void processMidiMessages(const juce::MidiBuffer &midiMessages);
+        void processMidiMessages(const juce::MidiBuffer &midiMessages, int numSamples);
         // Process MIDI messages for MIDI clock sync
         void processMidiClockMessage(const juce::MidiMessage &midiMessage, double currentTime);
         // Process MIDI CC messages
-        void processMidiCcMessage(const juce::MidiMessage &midiMessage);
+        void processMidiCcMessage(const juce::MidiMessage &midiMessage, int sampleOffset);
+
+        // Audio thread: apply a MIDI parameter change to the DSP and queue it for the message thread
+        void queueMidiParameterChange(MyceliaModel::ParamIndex index, float value, int sampleOffset);
+        // Message thread: update the parameters (notifying the host) and the GUI from the queued MIDI changes
+        void applyMidiParameterChanges();
+        static const char *getMidiPropertyName(MyceliaModel::ParamIndex index);
+
+        // MIDI parameter changes on their way from the audio thread to the message thread
+        ParameterEventQueue<1024> midiParameterQueue;
 
         // Check if MIDI clock sync is active
         bool isMidiClockSyncActive() const;
@@ -110,7 +125,9 @@ class Mycelia :
         // Check if scarcity/abundance is overridden
         bool isScarcityAbundanceOverridden() const;
 
-        // MIDI Clock sync variables
+        // MIDI Clock sync variables (times in seconds on the sample clock)
+        std::atomic<bool> midiClockActive {false};
+        juce::int64 midiSamplePosition = 0;
         double midiClockTempo = 0.0;
         double lastMidiClockTime = 0.0;
         int midiClockCounter = 0;
@@ -140,12 +157,14 @@ class Mycelia :
 
         //////////////////////////////////////////////
         // GUI variables
-        juce::AudioBuffer<float> inputBuffer;
         juce::AudioBuffer<float> outputBuffer;
         void updateScarcityAbundanceLabel();
         void updateTreePositionInfo();
         void updateMidiClockSyncStatus();
 
+        // Prepare the model again after an engine option changed (e.g. the internal rate)
+        void reconfigureEngine();
+
         //////////////////////////////////////////////
         // The underlying model used to perform the DSP processing
         MyceliaModel myceliaModel;
@@ -4,105 +4,55 @@
 #include "dsp/InputNode.h"
 #include "dsp/OutputNode.h"
 #include "util/ParameterRanges.h"
+#include "util/Utils.h"
 
 MyceliaModel::MyceliaModel(Mycelia &p)
-    : treeState(p, nullptr, "PARAMETERS", MyceliaModel::createParameterLayout())
+    : treeState(p, nullptr, "PARAMETERS", MyceliaModel::createParameterLayout()),
+      inputNode(controlScheduler),
+      sky(controlScheduler),
+      skyWorker(sky),
+      edgeTree(controlScheduler),
+      delayNetwork(controlScheduler),
+      outputNode(controlScheduler)
 {
-    preampLevel = treeState.getRawParameterValue(IDs::preampLevel);
-    jassert(preampLevel != nullptr);
-    reverbMix = treeState.getRawParameterValue(IDs::reverbMix);
-    jassert(reverbMix != nullptr);
-    //
-    bandpassFreq = treeState.getRawParameterValue(IDs::bandpassFreq);
-    jassert(bandpassFreq != nullptr);
-    bandpassWidth = treeState.getRawParameterValue(IDs::bandpassWidth);
-    jassert(bandpassWidth != nullptr);
-    //
-    treeSize = treeState.getRawParameterValue(IDs::treeSize);
-    jassert(treeSize != nullptr);
-    treeDensity = treeState.getRawParameterValue(IDs::treeDensity);
-    jassert(treeDensity != nullptr);
-    //
-    stretch = treeState.getRawParameterValue(IDs::stretch);
-    jassert(stretch != nullptr);
-    scarcityAbundance = treeState.getRawParameterValue(IDs::scarcityAbundance);
-    jassert(scarcityAbundance != nullptr);
-    foldPosition = treeState.getRawParameterValue(IDs::foldPosition);
-    jassert(foldPosition != nullptr);
-    foldWindowShape = treeState.getRawParameterValue(IDs::foldWindowShape);
-    jassert(foldWindowShape != nullptr);
-    foldWindowSize = treeState.getRawParameterValue(IDs::foldWindowSize);
-    jassert(foldWindowSize != nullptr);
-    //
-    entanglement = treeState.getRawParameterValue(IDs::entanglement);
-    jassert(entanglement != nullptr);
-    growthRate = treeState.getRawParameterValue(IDs::growthRate);
-    jassert(growthRate != nullptr);
-    //
-    skyHumidity = treeState.getRawParameterValue(IDs::skyHumidity);
-    jassert(skyHumidity != nullptr);
-    skyHeight = treeState.getRawParameterValue(IDs::skyHeight);
-    jassert(skyHeight != nullptr);
-    //
-    dryWet = treeState.getRawParameterValue(IDs::dryWet);
-    jassert(dryWet != nullptr);
-    delayDuck = treeState.getRawParameterValue(IDs::delayDuck);
-    jassert(delayDuck != nullptr);
-
-    // Add listeners to parameters that are not processed by the Controller
-    addParamListener(IDs::preampLevel, this);
-    addParamListener(IDs::reverbMix, this);
-    addParamListener(IDs::bandpassFreq, this);
-    addParamListener(IDs::bandpassWidth, this);
-    //
-    addParamListener(IDs::tempoValue, this);
-    //
-    addParamListener(IDs::entanglement, this);
-    addParamListener(IDs::growthRate, this);
-    //
-    addParamListener(IDs::dryWet, this);
-    addParamListener(IDs::delayDuck, this);
+    // Resolve the parameters once, the audio thread then polls them by index
+    for (size_t index = 0; index < numParams; ++index)
+    {
+        paramValues[index] = treeState.getRawParameterValue(*paramDispatch[index].id);
+        jassert(paramValues[index] != nullptr);
+        polledParamValues[index] = paramValues[index]->load();
+        eventEchoValues[index] = std::numeric_limits<float>::quiet_NaN();
+    }
 
     // Initialize current parameter values
-    currentInputParams.gainLevel = *preampLevel;
-    currentInputParams.bandpassFreq = *bandpassFreq;
-    currentInputParams.bandpassWidth = *bandpassWidth;
+    currentInputParams.gainLevel = getRawParameterValue(ParamIndex::preampLevel);
+    currentInputParams.bandpassFreq = getRawParameterValue(ParamIndex::bandpassFreq);
+    currentInputParams.bandpassWidth = getRawParameterValue(ParamIndex::bandpassWidth);
 
     // Initialize Sky parameters
-    currentSkyParams.humidity = *skyHumidity;
-    currentSkyParams.height = *skyHeight;
+    currentSkyParams.humidity = getRawParameterValue(ParamIndex::skyHumidity);
+    currentSkyParams.height = getRawParameterValue(ParamIndex::skyHeight);
 
     // Initialize DelayNetwork parameters
-    currentDelayNetworkParams.entanglement = *entanglement;
-    currentDelayNetworkParams.growthRate = *growthRate;
+    currentDelayNetworkParams.entanglement = getRawParameterValue(ParamIndex::entanglement);
+    currentDelayNetworkParams.growthRate = getRawParameterValue(ParamIndex::growthRate);
+    currentDelayNetworkParams.freezeWhenStill = (getRawParameterValue(ParamIndex::networkFreeze) > 0.5f);
 
     // Initialize Output parameters
-    currentOutputParams.dryWetMixLevel = *dryWet;
-    currentOutputParams.delayDuckLevel = *delayDuck;
+    currentOutputParams.dryWetMixLevel = getRawParameterValue(ParamIndex::dryWet);
+    currentOutputParams.delayDuckLevel = getRawParameterValue(ParamIndex::delayDuck);
+
+    // Initialize engine options
+    useFixedInternalRate = (getRawParameterValue(ParamIndex::fixedInternalRate) > 0.5f);
+    useFixedBlockSize = (getRawParameterValue(ParamIndex::fixedBlockSize) > 0.5f);
+    selectedTier = static_cast<QualityTier>(juce::roundToInt(getRawParameterValue(ParamIndex::qualityTier)));
+    selectedSkyEngine = static_cast<Sky::Engine>(juce::roundToInt(getRawParameterValue(ParamIndex::skyEngine)));
 }
 
 MyceliaModel::~MyceliaModel()
 {
-    treeState.removeParameterListener(IDs::preampLevel, this);
-    treeState.removeParameterListener(IDs::reverbMix, this);
-    treeState.removeParameterListener(IDs::bandpassFreq, this);
-    treeState.removeParameterListener(IDs::bandpassWidth, this);
-    treeState.removeParameterListener(IDs::tempoValue, this);
-    treeState.removeParameterListener(IDs::entanglement, this);
-    treeState.removeParameterListener(IDs::growthRate, this);
-    treeState.removeParameterListener(IDs::dryWet, this);
-    treeState.removeParameterListener(IDs::delayDuck, this);
-
-    for (auto& buffer : diffusionBandBuffers)
-    {
-        buffer.reset();
-    }
-    diffusionBandBuffers.clear();
-    for (auto& buffer : delayBandBuffers)
-    {
-        buffer.reset();
-    }
-    delayBandBuffers.clear();
+    // No timer may fire while the processors are destroyed
+    controlScheduler.stop();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout MyceliaModel::createParameterLayout()
@@ -196,7 +146,8 @@ juce::AudioProcessorValueTreeState::ParameterLayout MyceliaModel::createParamete
     auto mycelia = std::make_unique<juce::AudioProcessorParameterGroup>("Mycelia", juce::translate("Mycelia"), "|");
     mycelia->addChild(
         std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::entanglement, 1), "Entanglement", ParameterRanges::entanglementRange, 50.0f),
-        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::growthRate, 1), "Growth Rate", ParameterRanges::growthRateRange, 50.0f));
+        std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::growthRate, 1), "Growth Rate", ParameterRanges::growthRateRange, 50.0f),
+        std::make_unique<juce::AudioParameterBool>(juce::ParameterID(IDs::networkFreeze, 1), "Freeze When Still", false));
     //
     auto sky = std::make_unique<juce::AudioProcessorParameterGroup>("Sky", juce::translate("Sky"), "|");
     sky->addChild(
@@ -207,9 +158,23 @@ juce::AudioProcessorValueTreeState::ParameterLayout MyceliaModel::createParamete
     outputSculpt->addChild(
         std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::dryWet, 1), "Dry/Wet", ParameterRanges::dryWetRange, 0.0f),
         std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::delayDuck, 1), "Delay Duck", ParameterRanges::delayDuckRange, 33.33f));
+    //
+    auto engine = std::make_unique<juce::AudioProcessorParameterGroup>("Engine", juce::translate("Engine"), "|");
+    // These need the model to be prepared again, so they are not exposed to automation
+    engine->addChild(
+        std::make_unique<juce::AudioParameterBool>(juce::ParameterID(IDs::fixedInternalRate, 1), "Fixed Internal Rate", false,
+                                                   juce::AudioParameterBoolAttributes().withAutomatable(false)),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID(IDs::qualityTier, 1), "Quality",
+                                                     juce::StringArray {"Eco", "Standard", "High"}, 2,
+                                                     juce::AudioParameterChoiceAttributes().withAutomatable(false)),
+        std::make_unique<juce::AudioParameterBool>(juce::ParameterID(IDs::fixedBlockSize, 1), "Fixed Block Size", false,
+                                                   juce::AudioParameterBoolAttributes().withAutomatable(false)),
+        std::make_unique<juce::AudioParameterChoice>(juce::ParameterID(IDs::skyEngine, 1), "Sky Engine",
+                                                     juce::StringArray {"Lifted Reverb", "FDN 4", "FDN 8", "FDN 16"}, 0,
+                                                     juce::AudioParameterChoiceAttributes().withAutomatable(false)));
 
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    layout.add(std::move(inputLevels), std::move(inputSculpt), std::move(trees), std::move(universeCtrls), std::move(mycelia), std::move(sky), std::move(outputSculpt));
+    layout.add(std::move(inputLevels), std::move(inputSculpt), std::move(trees), std::move(universeCtrls), std::move(mycelia), std::move(sky), std::move(outputSculpt), std::move(engine));
 
     return layout;
 }
@@ -231,118 +196,267 @@ void MyceliaModel::addParamListener(juce::String id, juce::AudioProcessorValueTr
     treeState.addParameterListener(id, listener);
 }
 
-void MyceliaModel::parameterChanged(const juce::String &parameterID, float newValue)
-{
-    // Handle parameter changes here
-    if (parameterID == IDs::preampLevel)
-    {
-        currentInputParams.gainLevel = newValue;
-        inputNode.setParameters(currentInputParams);
-    }
-    else if (parameterID == IDs::reverbMix)
-    {
-        currentInputParams.reverbMix = newValue;
-        currentSkyParams.humidity = newValue;
-        currentSkyParams.height = (1.0f - newValue);
-        inputNode.setParameters(currentInputParams);
-    }
-    else if (parameterID == IDs::bandpassFreq)
-    {
-        currentInputParams.bandpassFreq = newValue;
-        inputNode.setParameters(currentInputParams);
-    }
-    else if (parameterID == IDs::bandpassWidth)
-    {
-        currentInputParams.bandpassWidth = newValue;
-        inputNode.setParameters(currentInputParams);
-    }
+// Handlers in ParamIndex order
+const std::array<MyceliaModel::ParamDispatch, MyceliaModel::numParams> MyceliaModel::paramDispatch {{
+    {&IDs::preampLevel, [](MyceliaModel &m, float value)
+        {
+            m.currentInputParams.gainLevel = value;
+            m.inputNode.setParameters(m.currentInputParams);
+        }},
+    {&IDs::reverbMix, [](MyceliaModel &m, float value)
+        {
+            m.currentInputParams.reverbMix = value;
+            m.currentSkyParams.humidity = value;
+            m.currentSkyParams.height = (1.0f - value);
+            m.inputNode.setParameters(m.currentInputParams);
+        }},
+    {&IDs::bandpassFreq, [](MyceliaModel &m, float value)
+        {
+            m.currentInputParams.bandpassFreq = value;
+            m.inputNode.setParameters(m.currentInputParams);
+        }},
+    {&IDs::bandpassWidth, [](MyceliaModel &m, float value)
+        {
+            m.currentInputParams.bandpassWidth = value;
+            m.inputNode.setParameters(m.currentInputParams);
+        }},
     //
-    else if (parameterID == IDs::treeSize)
-    {
-        currentEdgeTreeParams.treeSize = newValue;
-        edgeTree.setParameters(currentEdgeTreeParams);
-    }
+    {&IDs::treeSize, [](MyceliaModel &m, float value)
+        {
+            m.currentEdgeTreeParams.treeSize = value;
+            m.edgeTree.setParameters(m.currentEdgeTreeParams);
+        }},
+    {&IDs::treeDensity, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.treeDensity = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
     //
-    else if (parameterID == IDs::treeDensity)
-    {
-        currentDelayNetworkParams.treeDensity = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
-    }
-    else if (parameterID == IDs::stretch)
-    {
-        currentDelayNetworkParams.stretch = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
-    }
-    else if (parameterID == IDs::tempoValue)
-    {
-        currentDelayNetworkParams.tempoValue = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
-    }
-    else if (parameterID == IDs::scarcityAbundance)
+    {&IDs::stretch, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.stretch = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::tempoValue, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.tempoValue = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::scarcityAbundance, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.scarcityAbundance = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::foldPosition, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.foldPosition = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::foldWindowShape, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.foldWindowShape = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::foldWindowSize, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.foldWindowSize = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    //
+    {&IDs::entanglement, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.entanglement = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::growthRate, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.growthRate = value;
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    {&IDs::networkFreeze, [](MyceliaModel &m, float value)
+        {
+            m.currentDelayNetworkParams.freezeWhenStill = (value > 0.5f);
+            m.delayNetwork.setParameters(m.currentDelayNetworkParams);
+        }},
+    //
+    {&IDs::skyHumidity, [](MyceliaModel &m, float value)
+        {
+            m.currentSkyParams.humidity = value;
+            m.sky.setParameters(m.currentSkyParams);
+        }},
+    {&IDs::skyHeight, [](MyceliaModel &m, float value)
+        {
+            m.currentSkyParams.height = value;
+            m.sky.setParameters(m.currentSkyParams);
+        }},
+    //
+    {&IDs::dryWet, [](MyceliaModel &m, float value)
+        {
+            m.currentOutputParams.dryWetMixLevel = value;
+            m.outputNode.setParameters(m.currentOutputParams);
+        }},
+    {&IDs::delayDuck, [](MyceliaModel &m, float value)
+        {
+            m.currentOutputParams.delayDuckLevel = value;
+            m.outputNode.setParameters(m.currentOutputParams);
+        }},
+    //
+    {&IDs::fixedInternalRate, [](MyceliaModel &m, float value)
+        {
+            // Applied on the next prepareToPlay, as the latency reported to the host changes
+            m.useFixedInternalRate = (value > 0.5f);
+            m.engineConfigChanged = true;
+        }},
+    {&IDs::qualityTier, [](MyceliaModel &m, float value)
+        {
+            // Applied on the next prepareToPlay, as the reverb and the filters are rebuilt
+            const auto previousTier = m.getEffectiveTier();
+            m.selectedTier = static_cast<QualityTier>(juce::roundToInt(value));
+            if (m.getEffectiveTier() != previousTier)
+            {
+                m.engineConfigChanged = true;
+            }
+        }},
+    {&IDs::fixedBlockSize, [](MyceliaModel &m, float value)
+        {
+            // Applied on the next prepareToPlay, as the latency reported to the host changes
+            m.useFixedBlockSize = (value > 0.5f);
+            m.engineConfigChanged = true;
+        }},
+    {&IDs::skyEngine, [](MyceliaModel &m, float value)
+        {
+            // Applied on the next prepareToPlay, as the reverb is rebuilt
+            m.selectedSkyEngine = static_cast<Sky::Engine>(juce::roundToInt(value));
+            m.engineConfigChanged = true;
+        }},
+}};
+
+void MyceliaModel::pollParameters()
+{
+    for (size_t index = 0; index < numParams; ++index)
     {
-        currentDelayNetworkParams.scarcityAbundance = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        const auto value = paramValues[index]->load(std::memory_order_relaxed);
+        if (value != polledParamValues[index])
+        {
+            polledParamValues[index] = value;
+
+            // A parameter catching up with events already applied is not dispatched again
+            auto echo = value;
+            if (!eventEchoValues[index].compare_exchange_strong(echo, std::numeric_limits<float>::quiet_NaN()))
+            {
+                paramDispatch[index].handler(*this, value);
+            }
+        }
     }
+}
 
-    else if (parameterID == IDs::skyHumidity)
+void MyceliaModel::setRealtime(bool realtime)
+{
+    qualityGovernor.setEnabled(realtime);
+    controlScheduler.setRealtime(realtime);
+    skyWorker.setRealtime(realtime);
+
+    const auto previousTier = getEffectiveTier();
+    isRealtime = realtime;
+    if (getEffectiveTier() != previousTier)
     {
-        currentSkyParams.humidity = newValue;
-        sky.setParameters(currentSkyParams);
+        engineConfigChanged = true;
     }
-    else if (parameterID == IDs::skyHeight)
+}
+
+void MyceliaModel::setParameterExplicitly(const juce::String& paramId, float newValue)
+{
+    // Get the parameter and update its value
+    auto* param = treeState.getParameter(paramId);
+    if (param != nullptr)
     {
-        currentSkyParams.height = newValue;
-        sky.setParameters(currentSkyParams);
+        // Convert normalized value if needed
+        float normValue = param->convertTo0to1(newValue);
+        param->setValueNotifyingHost(normValue);
     }
+}
 
-    else if (parameterID == IDs::foldPosition)
+void MyceliaModel::setParameterExplicitly(ParamIndex index, float newValue)
+{
+    setParameterExplicitly(*paramDispatch[static_cast<size_t>(index)].id, newValue);
+}
+
+void MyceliaModel::setParameterFromEvent(ParamIndex index, float newValue)
+{
+    if (auto *param = treeState.getParameter(*paramDispatch[static_cast<size_t>(index)].id))
     {
-        currentDelayNetworkParams.foldPosition = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        // The raw value is stored the same way, before the poll can see it
+        eventEchoValues[static_cast<size_t>(index)] = param->convertFrom0to1(param->convertTo0to1(newValue));
+        param->setValueNotifyingHost(param->convertTo0to1(newValue));
     }
-    else if (parameterID == IDs::foldWindowShape)
+}
+
+bool MyceliaModel::addParameterEvent(ParamIndex index, float value, int sampleOffset)
+{
+    if (numParameterEvents >= maxParameterEvents)
     {
-        currentDelayNetworkParams.foldWindowShape = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        return false;
     }
-    else if (parameterID == IDs::foldWindowSize)
+
+    // Keep the events in sample order
+    if (numParameterEvents > 0)
     {
-        currentDelayNetworkParams.foldWindowSize = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        sampleOffset = juce::jmax(sampleOffset, parameterEvents[static_cast<size_t>(numParameterEvents - 1)].sampleOffset);
     }
-    else if (parameterID == IDs::entanglement)
+
+    parameterEvents[static_cast<size_t>(numParameterEvents++)] = {static_cast<int>(index), value, juce::jmax(0, sampleOffset)};
+    return true;
+}
+
+void MyceliaModel::applyParameterEvents(size_t samplePosition)
+{
+    for (; nextParameterEvent < numParameterEvents; ++nextParameterEvent)
     {
-        currentDelayNetworkParams.entanglement = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        const auto &event = parameterEvents[static_cast<size_t>(nextParameterEvent)];
+        if (static_cast<size_t>(event.sampleOffset) > samplePosition)
+        {
+            break;
+        }
+        paramDispatch[static_cast<size_t>(event.paramIndex)].handler(*this, event.value);
     }
-    else if (parameterID == IDs::growthRate)
+}
+
+size_t MyceliaModel::getControlTickAfter(size_t position) const
+{
+    // Ticks fall at firstTick + k * interval in this block
+    const auto interval = static_cast<size_t>(eventClock.getInterval());
+    const auto firstTick = static_cast<size_t>(eventClock.getSamplesToNextTick()) % interval;
+    if (position < firstTick)
     {
-        currentDelayNetworkParams.growthRate = newValue;
-        delayNetwork.setParameters(currentDelayNetworkParams);
+        return firstTick;
     }
-    //
-    else if (parameterID == IDs::dryWet)
+    return firstTick + ((position - firstTick) / interval + 1) * interval;
+}
+
+size_t MyceliaModel::getControlTickAtOrBefore(size_t offset, size_t numSamples) const
+{
+    if (offset >= numSamples)
     {
-        currentOutputParams.dryWetMixLevel = newValue;
-        outputNode.setParameters(currentOutputParams);
+        return numSamples;
     }
-    else if (parameterID == IDs::delayDuck)
+
+    // Events before the first tick apply at the start of the block
+    const auto interval = static_cast<size_t>(eventClock.getInterval());
+    const auto firstTick = static_cast<size_t>(eventClock.getSamplesToNextTick()) % interval;
+    if (offset < firstTick)
     {
-        currentOutputParams.delayDuckLevel = newValue;
-        outputNode.setParameters(currentOutputParams);
+        return 0;
     }
+    return firstTick + ((offset - firstTick) / interval) * interval;
 }
 
-void MyceliaModel::setParameterExplicitly(const juce::String& paramId, float newValue)
+size_t MyceliaModel::getNextParameterEventOffset(size_t numSamples) const
 {
-    // Get the parameter and update its value
-    auto* param = treeState.getParameter(paramId);
-    if (param != nullptr)
+    if (nextParameterEvent < numParameterEvents)
     {
-        // Convert normalized value if needed
-        float normValue = param->convertTo0to1(newValue);
-        param->setValueNotifyingHost(normValue);
+        return juce::jmin(numSamples, static_cast<size_t>(parameterEvents[static_cast<size_t>(nextParameterEvent)].sampleOffset));
     }
+    return numSamples;
 }
 
 float MyceliaModel::getParameterValue(const juce::String &paramId)
@@ -358,64 +472,72 @@ float MyceliaModel::getParameterValue(const juce::String &paramId)
 void MyceliaModel::prepareToPlay(juce::dsp::ProcessSpec spec)
 {
     numChannels = spec.numChannels;
-    blockSize = spec.maximumBlockSize;
-
-    // Prepare all processors
-    inputNode.prepare(spec);
-    sky.prepare(spec);
-    edgeTree.prepare(spec);
-    delayNetwork.prepare(spec);
-    outputNode.prepare(spec);
+    engineConfigChanged = false;
 
-    // Initialize buffers
-    dryBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
-    skyBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
-    allocateBandBuffers(currentDelayNetworkParams.numActiveFilterBands);
-}
+    // The reverb is rebuilt below, so the block it may still be processing is finished first
+    skyWorker.stop();
 
-void MyceliaModel::allocateBandBuffers(int numBands)
-{
-    if (numBands < 1 || numBands > ParameterRanges::maxNutrientBands)
+    // Re-block to a fixed size if requested: everything below then sees blocks of that size
+    reBlocker.prepare(spec, useFixedBlockSize ? reBlockSize : 0);
+    if (reBlocker.isActive())
     {
-        return;
+        spec.maximumBlockSize = static_cast<juce::uint32>(reBlockSize);
     }
 
-    // Check if we need to resize the buffers
-    if (numBands == diffusionBandBuffers.size() &&
-        numBands == delayBandBuffers.size())
+    // Run the core network at a fixed internal rate if requested and the host rate allows it
+    const auto rateFactor = useFixedInternalRate ? RateConverter::getDecimationFactor(spec.sampleRate) : 1;
+    rateConverter.prepare(spec, rateFactor);
+
+    auto coreSpec = spec;
+    if (rateConverter.isActive())
     {
-        // No need to resize, just return
-        return;
+        coreSpec.sampleRate = spec.sampleRate / rateFactor;
+        coreSpec.maximumBlockSize = static_cast<juce::uint32>(rateConverter.getMaxInternalBlockSize(static_cast<int>(spec.maximumBlockSize)));
     }
+    blockSize = coreSpec.maximumBlockSize;
 
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> newDiffusionBandBuffers;
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> newDelayBandBuffers;
+    // Restart the silence detection from scratch
+    silentSamples = 0;
+    silenceHoldSamples = static_cast<int>(silenceHoldSeconds * spec.sampleRate);
+    lastSkyPeak = 0.0f;
 
-    // Clear the current buffers
-    for (auto &buffer : diffusionBandBuffers)
-    {
-        buffer->clear();
-    }
-    for (auto &buffer : delayBandBuffers)
-    {
-        buffer->clear();
-    }
+    // Control timers count host samples
+    controlScheduler.prepare(spec.sampleRate);
+    eventClock.reset();
 
-    // Allocate new buffers for each band
-    for (int band = 0; band < numBands; ++band)
-    {
-        auto newDiffusionBuffer = std::make_unique<juce::AudioBuffer<float>>(numChannels, blockSize);
-        newDiffusionBandBuffers.push_back(std::move(newDiffusionBuffer));
+    // The deadline is the duration of the audio processed in a host block
+    qualityGovernor.prepare(spec.sampleRate);
+    appliedQualityLevel = -1;
 
-        auto newDelayBuffer = std::make_unique<juce::AudioBuffer<float>>(numChannels, blockSize);
-        newDelayBandBuffers.push_back(std::move(newDelayBuffer));
-    }
+    // The tier sets what is built below, the governor can only lower it further
+    tierQuality = ProcessingQuality::forTier(getEffectiveTier());
+    sky.setQuality(tierQuality);
+    sky.setEngine(selectedSkyEngine);
 
-    // Swap the new buffers with the old ones
-    diffusionBandBuffers.swap(newDiffusionBandBuffers);
-    delayBandBuffers.swap(newDelayBandBuffers);
-}
+    // Fixed blocks are a multiple of the effect block sizes, so the effects can run on them directly
+    inputNode.setBlocksAligned(reBlocker.isActive());
+    sky.setBlocksAligned(reBlocker.isActive() && !rateConverter.isActive());
+    delayNetwork.setQuality(tierQuality);
+
+    // Prepare all processors (the input conditioning and the dry path stay at host rate)
+    inputNode.prepare(spec);
+    sky.prepare(coreSpec);
+    skyWorker.prepare(coreSpec);
+    edgeTree.prepare(coreSpec);
+    delayNetwork.prepare(coreSpec);
+    outputNode.prepare(coreSpec, spec);
 
+    // Initialize buffers
+    dryBuffer.setSize(coreSpec.numChannels, coreSpec.maximumBlockSize);
+    coreBuffer.setSize(coreSpec.numChannels, coreSpec.maximumBlockSize);
+    hostDryBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
+
+    // Band buffers follow the core block size, one for every band the network can switch on
+    constexpr auto numBands = static_cast<size_t>(ParameterRanges::maxNutrientBands);
+    bandBufferArena.prepare(2 * static_cast<int>(numBands), static_cast<int>(numChannels), static_cast<int>(blockSize));
+    diffusionBandBuffers = bandBufferArena.getBuffers(0, numBands);
+    delayBandBuffers = bandBufferArena.getBuffers(numBands, numBands);
+}
 
 void MyceliaModel::releaseResources()
 {
@@ -424,33 +546,11 @@ void MyceliaModel::releaseResources()
     // host's settings)
 
     inputNode.reset();
+    skyWorker.stop();
+    skyWorker.reset();
     sky.reset();
     edgeTree.reset();
     outputNode.reset();
-
-    preampLevel = nullptr;
-    reverbMix = nullptr;
-    //
-    bandpassFreq = nullptr;
-    bandpassWidth = nullptr;
-    //
-    treeSize = nullptr;
-    treeDensity = nullptr;
-    //
-    stretch = nullptr;
-    scarcityAbundance = nullptr;
-    foldPosition = nullptr;
-    foldWindowShape = nullptr;
-    foldWindowSize = nullptr;
-    //
-    entanglement = nullptr;
-    growthRate = nullptr;
-    //
-    skyHumidity = nullptr;
-    skyHeight = nullptr;
-    //
-    dryWet = nullptr;
-    delayDuck = nullptr;
 }
 
 //==============================================================================
@@ -473,35 +573,153 @@ void MyceliaModel::process(const ProcessContext &context)
         outputBlock.copyFrom(inputBlock);
     }
 
+    // Parameter changes still reach the processors while bypassed
+    pollParameters();
+    controlScheduler.advance(static_cast<int>(numSamples));
+
     // Skip processing if bypassed
     if (context.isBypassed)
     {
+        applyParameterEvents(numSamples);
+        numParameterEvents = nextParameterEvent = 0;
+        eventClock.advance(static_cast<int>(numSamples));
         return;
     }
 
-    // Set up processing contexts
-    juce::dsp::AudioBlock<float> dryBlock(dryBuffer);
-    juce::dsp::AudioBlock<float> skyBlock(skyBuffer);
-    juce::dsp::AudioBlock<float> wetBlock(context.getOutputBlock());
+    const auto startTicks = juce::Time::getHighResolutionTicks();
 
-    juce::dsp::ProcessContextReplacing<float> dryContext(dryBlock);
-    juce::dsp::ProcessContextReplacing<float> skyContext(skyBlock);
-    juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
+    // Apply the quality chosen by the governor from the previous blocks
+    if (const auto qualityLevel = qualityGovernor.getQualityLevel(); qualityLevel != appliedQualityLevel)
+    {
+        delayNetwork.setQuality(QualityGovernor::getQualityForLevel(qualityLevel, tierQuality));
+        appliedQualityLevel = qualityLevel;
+    }
 
-    // Allocate buffers if needed
-    allocateBandBuffers(currentDelayNetworkParams.numActiveFilterBands);
+    // The deadline is the duration of the audio the chain actually ran on: with the ReBlocker a short
+    // host block may complete a whole fixed block, or run none at all
+    size_t numProcessedSamples = numSamples;
+
+    if (!reBlocker.isActive())
+    {
+        // Split the block at the control ticks that have parameter events before the next tick.
+        // Every event up to the next tick applies at the start of a segment
+        for (size_t pos = 0; pos < numSamples;)
+        {
+            const auto nextTick = juce::jmin(numSamples, getControlTickAfter(pos));
+            applyParameterEvents(nextTick - 1);
+
+            const auto end = juce::jmax(nextTick, getControlTickAtOrBefore(getNextParameterEventOffset(numSamples), numSamples));
+            auto segment = outputBlock.getSubBlock(pos, end - pos);
+            processChain(segment);
+            pos = end;
+        }
+    }
+    else
+    {
+        // Run the chain on fixed-size blocks, whatever the host block size
+        // (parameter events apply at the start of the next fixed block)
+        numProcessedSamples = 0;
+        for (size_t pos = 0; pos < numSamples;)
+        {
+            pos += reBlocker.exchange(outputBlock, pos);
+            if (reBlocker.isBlockReady())
+            {
+                applyParameterEvents(pos);
+                auto fixedBlock = reBlocker.getBlock();
+                processChain(fixedBlock);
+                numProcessedSamples += fixedBlock.getNumSamples();
+            }
+        }
+    }
+
+    // Events after the last fixed block still reach the processors in this block
+    applyParameterEvents(numSamples);
+    numParameterEvents = nextParameterEvent = 0;
+    eventClock.advance(static_cast<int>(numSamples));
+
+    qualityGovernor.blockProcessed(startTicks, static_cast<int>(numProcessedSamples));
+}
+
+void MyceliaModel::processChain(juce::dsp::AudioBlock<float> &block)
+{
+    const auto numSamples = block.getNumSamples();
+
+    // Short-circuit the whole chain while the input is silent and nothing is left ringing,
+    // resuming on the first block with signal
+    const auto inputSilent = Utils::getPeakLevel(block) <= silenceThreshold;
+    if (inputSilent && silentSamples >= silenceHoldSamples)
+    {
+        block.clear();
+        return;
+    }
 
     // Process through input node
+    juce::dsp::ProcessContextReplacing<float> context(block);
     inputNode.process(context);
 
+    if (!rateConverter.isActive())
+    {
+        processCore(block);
+    }
+    else
+    {
+        // Keep the conditioned "dry" signal at host rate, delayed to line up with the resampled core
+        auto hostDryBlock = juce::dsp::AudioBlock<float>(hostDryBuffer).getSubBlock(0, numSamples);
+        hostDryBlock.copyFrom(block);
+        rateConverter.compensateLatency(hostDryBlock);
+
+        // Run the core network at the internal rate
+        juce::dsp::AudioBlock<float> coreFullBlock(coreBuffer);
+        const auto numCoreSamples = rateConverter.downsample(block, coreFullBlock);
+        auto coreBlock = coreFullBlock.getSubBlock(0, numCoreSamples);
+        if (numCoreSamples > 0)
+        {
+            processCore(coreBlock);
+        }
+        rateConverter.upsample(coreBlock, block);
+
+        // Mix the dry signal back in at host rate
+        juce::dsp::ProcessContextReplacing<float> hostWetContext(block);
+        juce::dsp::ProcessContextReplacing<float> hostDryContext(hostDryBlock);
+        outputNode.mixDry(hostWetContext, hostDryContext);
+    }
+
+    // Count how long the input, the output and every internal tail have been silent
+    if (inputSilent &&
+        Utils::getPeakLevel(block) <= silenceThreshold &&
+        lastSkyPeak <= silenceThreshold &&
+        delayNetwork.isSilent())
+    {
+        silentSamples = juce::jmin(silentSamples + static_cast<int>(numSamples), silenceHoldSamples);
+    }
+    else
+    {
+        silentSamples = 0;
+    }
+}
+
+void MyceliaModel::processCore(juce::dsp::AudioBlock<float> &wetBlock)
+{
+    const auto numSamples = wetBlock.getNumSamples();
+
+    // Set up processing contexts (views of the buffers sized in prepareToPlay)
+    auto dryBlock = juce::dsp::AudioBlock<float>(dryBuffer).getSubBlock(0, numSamples);
+
+    juce::dsp::ProcessContextReplacing<float> dryContext(dryBlock);
+    juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
+
+    // The band buffers follow the length of the block
+    bandBufferArena.setNumSamples(static_cast<int>(numSamples));
+
     // Keep "dry" signal - post input conditioning
-    dryBuffer.setSize(numChannels, numSamples, false, false, true);
-    dryBlock.copyFrom(outputBlock);
+    dryBlock.copyFrom(wetBlock);
 
-    // Mix in the reverb signal (with gain of 0.45f * the reverb mix parameter)
+    // Mix in the reverb of the previous block (with gain of 0.45f * the reverb mix parameter),
+    // waiting for the sky thread if it is still on it
     auto reverbMix = ParameterRanges::normalizeParameter(ParameterRanges::reverbMixRange, currentInputParams.reverbMix);
-    skyBlock.multiplyBy(0.45f * reverbMix);
-    wetBlock.replaceWithSumOf(skyBlock, dryBlock);
+    const auto skyBlock = skyWorker.join(numSamples);
+    lastSkyPeak = skyWorker.getLastPeak();
+    wetBlock.addProductOf(skyBlock, 0.45f * reverbMix);
 
     // Process "dry" (+ reverb) signal through EdgeTree
     edgeTree.process(wetContext);
@@ -509,15 +727,19 @@ void MyceliaModel::process(const ProcessContext &context)
     // Process through the DelayNetwork
     delayNetwork.process(wetContext, diffusionBandBuffers, delayBandBuffers);
 
-    // Make another copy for sky processing
-    skyBuffer.setSize(numChannels, numSamples, false, false, true);
-    skyBlock.copyFrom(wetBlock);
-
-    // Process through the Sky processor
-    sky.process(skyContext);
+    // Hand a copy to the Sky processor, which runs while the output stage and the next block are processed
+    skyWorker.launch(wetBlock, reverbMix <= 0.0f);
 
     // Output mixing stage
-    outputNode.process(wetContext, dryContext, diffusionBandBuffers, delayBandBuffers);
+    if (rateConverter.isActive())
+    {
+        // The dry signal is mixed back in at host rate
+        outputNode.processBands(wetContext, diffusionBandBuffers, delayBandBuffers);
+    }
+    else
+    {
+        outputNode.process(wetContext, dryContext, diffusionBandBuffers, delayBandBuffers);
+    }
 }
 
 //==================================================
@@ -4,12 +4,21 @@
 #include "dsp/InputNode.h"
 #include "dsp/EdgeTree.h"
 #include "dsp/Sky.h"
+#include "dsp/SkyWorker.h"
 #include "dsp/OutputNode.h"
 #include "dsp/DelayNetwork.h"
 #include "dsp/DelayNodes.h"
+#include "dsp/RateConverter.h"
+#include "dsp/ReBlocker.h"
+#include "dsp/QualityGovernor.h"
+#include "dsp/ControlScheduler.h"
+#include "dsp/ControlClock.h"
+#include "dsp/BufferArena.h"
+#include "util/ParameterEventQueue.h"
 
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
 
 //==============================================================================
 
@@ -36,12 +45,18 @@ namespace IDs
     //
     static juce::String entanglement{"entanglement"};
     static juce::String growthRate{"growthrate"};
+    static juce::String networkFreeze{"networkfreeze"};
     //
     static juce::String skyHumidity{"skyhumidity"};
     static juce::String skyHeight{"skyheight"};
     //
     static juce::String dryWet{"drywet"};
     static juce::String delayDuck{"delayduck"};
+    //
+    static juce::String fixedInternalRate{"fixedinternalrate"};
+    static juce::String qualityTier{"qualitytier"};
+    static juce::String fixedBlockSize{"fixedblocksize"};
+    static juce::String skyEngine{"skyengine"};
 
     static juce::Identifier oscilloscope{"oscilloscope"};
     static juce::Identifier inputAnalyser{"input"};
@@ -51,8 +66,7 @@ namespace IDs
     static juce::Identifier midiClockStatus{"midiClockStatus"};
 } // namespace IDs
 
-class MyceliaModel :
-    private juce::AudioProcessorValueTreeState::Listener
+class MyceliaModel
 {
     public:
         explicit MyceliaModel(Mycelia &);
@@ -78,7 +92,35 @@ class MyceliaModel :
         //==============================================================================
         void addParamListener(juce::String id, juce::AudioProcessorValueTreeState::Listener *listener);
 
-        void parameterChanged(const juce::String &parameterID, float newValue);
+        // Dense indices of the parameters the model applies to the processors
+        enum class ParamIndex
+        {
+            preampLevel,
+            reverbMix,
+            bandpassFreq,
+            bandpassWidth,
+            treeSize,
+            treeDensity,
+            stretch,
+            tempoValue,
+            scarcityAbundance,
+            foldPosition,
+            foldWindowShape,
+            foldWindowSize,
+            entanglement,
+            growthRate,
+            networkFreeze,
+            skyHumidity,
+            skyHeight,
+            dryWet,
+            delayDuck,
+            fixedInternalRate,
+            qualityTier,
+            fixedBlockSize,
+            skyEngine,
+            numParams
+        };
+        static constexpr size_t numParams = static_cast<size_t>(ParamIndex::numParams);
 
         void prepareToPlay(juce::dsp::ProcessSpec spec);
 
@@ -89,6 +131,15 @@ class MyceliaModel :
 
         // Change parameters programmatically, ensuring listeners are notified
         void setParameterExplicitly(const juce::String& paramId, float newValue);
+        void setParameterExplicitly(ParamIndex index, float newValue);
+
+        // Message thread: set a parameter to a value its DSP already follows (from a parameter event),
+        // without the change being dispatched to the DSP again
+        void setParameterFromEvent(ParamIndex index, float newValue);
+
+        // Audio thread, before process(): apply a parameter change at a sample position of the next block.
+        // The DSP follows straight away, the parameter itself is only updated by setParameterExplicitly().
+        bool addParameterEvent(ParamIndex index, float value, int sampleOffset);
 
         float getParameterValue(const juce::String &paramId);
 
@@ -100,52 +151,127 @@ class MyceliaModel :
         // Get the band states from the delay network
         std::vector<DelayNodes::BandResources>& getBandStates() { return delayNetwork.getBandStates(); }
 
+        // Get the connection strengths between the delay nodes
+        const ConnectionMatrix& getConnections() const { return delayNetwork.getConnections(); }
+
         // Get the position of the trees in the network
         std::vector<int>& getTreePositions() { return delayNetwork.getTreePositions(); }
 
+        // Latency added by the re-blocking, the waveshaper blocks and the internal rate conversion, in host samples
+        int getLatencySamples() const { return reBlocker.getLatencySamples() + inputNode.getLatencySamples() + rateConverter.getLatencySamples(); }
+
+        // True when an engine option (the internal rate or the quality tier) changed and the model needs to be prepared again
+        bool isReconfigurationPending() const { return engineConfigChanged.load(); }
+
+        // CPU governor state (quality level 0 is full quality)
+        int getQualityLevel() const { return qualityGovernor.getQualityLevel(); }
+        int getOverrunCount() const { return qualityGovernor.getOverrunCount(); }
+
+        // Offline renders use the High tier and keep full quality, whatever they cost
+        void setRealtime(bool isRealtime);
+
     private:
         size_t numChannels = 2;
         size_t blockSize = 512;
 
-        void allocateBandBuffers(int numBands);
+        // Process the input node, the core network and the dry mix in place on a host-rate block
+        void processChain(juce::dsp::AudioBlock<float> &block);
+
+        // Process the core network (EdgeTree -> DelayNetwork -> Sky -> output bands) on a conditioned block
+        // (Sky runs on its own thread, its output is mixed into the next block)
+        void processCore(juce::dsp::AudioBlock<float> &wetBlock);
+
+        // Silence gating: the whole chain is skipped while the input is silent and every tail has decayed
+        static constexpr float silenceThreshold = 1.0e-6f; // -120 dB
+        static constexpr float silenceHoldSeconds = 0.5f;  // Time the chain must stay silent before gating
+        int silentSamples = 0;
+        int silenceHoldSamples = 0;
+        float lastSkyPeak = 0.0f;
+
+        // Quality tier chosen by the user, and the one the model is prepared with
+        std::atomic<QualityTier> selectedTier {QualityTier::high};
+        std::atomic<bool> isRealtime {true};
+        QualityTier getEffectiveTier() const { return isRealtime ? selectedTier.load() : QualityTier::high; }
+        ProcessingQuality tierQuality;
+
+        // Lowers the processing quality further while blocks get close to their deadline
+        QualityGovernor qualityGovernor;
+        int appliedQualityLevel = -1;
 
         // Parameters
         juce::AudioProcessorValueTreeState treeState;
 
-        std::atomic<float>* preampLevel = nullptr;
-        std::atomic<float>* reverbMix = nullptr;
-        //
-        std::atomic<float>* bandpassFreq = nullptr;
-        std::atomic<float>* bandpassWidth = nullptr;
-        //
-        std::atomic<float>* treeSize = nullptr;
-        std::atomic<float>* treeDensity = nullptr;
-        //
-        std::atomic<float>* stretch = nullptr;
-        std::atomic<float>* scarcityAbundance = nullptr;
-        std::atomic<float>* foldPosition = nullptr;
-        std::atomic<float>* foldWindowShape = nullptr;
-        std::atomic<float>* foldWindowSize = nullptr;
-        //
-        std::atomic<float>* entanglement = nullptr;
-        std::atomic<float>* growthRate = nullptr;
-        //
-        std::atomic<float>* skyHumidity = nullptr;
-        std::atomic<float>* skyHeight = nullptr;
-        //
-        std::atomic<float>* dryWet = nullptr;
-        std::atomic<float>* delayDuck = nullptr;
+        // Applies a new parameter value to the processors
+        using ParamHandler = void (*)(MyceliaModel &, float);
+
+        // Parameter ID and handler for each ParamIndex, so changes are dispatched without string compares
+        struct ParamDispatch
+        {
+            const juce::String *id;
+            ParamHandler handler;
+        };
+        static const std::array<ParamDispatch, numParams> paramDispatch;
+
+        // Raw parameter values, polled once per block, and the values seen by the last poll
+        std::array<std::atomic<float> *, numParams> paramValues {};
+        std::array<float, numParams> polledParamValues {};
+
+        // Raw value each parameter takes when set by setParameterFromEvent() (NaN when none is on its way).
+        // The poll skips it, as the DSP already moved on with the events
+        std::array<std::atomic<float>, numParams> eventEchoValues;
+
+        float getRawParameterValue(ParamIndex index) const { return paramValues[static_cast<size_t>(index)]->load(); }
+
+        // Dispatch the parameters that changed since the last block
+        void pollParameters();
+
+        // Parameter events of the current block (from MIDI), in sample order
+        static constexpr int maxParameterEvents = 128;
+        std::array<ParameterEvent, maxParameterEvents> parameterEvents;
+        int numParameterEvents = 0;
+        int nextParameterEvent = 0;
+
+        // Dispatch the events up to samplePosition, and find where the next one falls
+        void applyParameterEvents(size_t samplePosition);
+        size_t getNextParameterEventOffset(size_t numSamples) const;
+
+        // Events apply on the control-tick grid of the host clock (where the processors pick up their
+        // parameters), so the chain is split at most once per control period rather than at every event
+        ControlClock eventClock;
+        size_t getControlTickAfter(size_t position) const;
+        size_t getControlTickAtOrBefore(size_t offset, size_t numSamples) const;
+
+        // Internal rate conversion: the core network runs at 48 kHz (or 44.1 kHz)
+        // for high-rate sessions, while the dry path stays at host rate
+        std::atomic<bool> useFixedInternalRate {false};
+        std::atomic<bool> engineConfigChanged {false};
+        RateConverter rateConverter;
+
+        // Optional re-blocking, so small or irregular host blocks cost the same per sample as large ones
+        static constexpr int reBlockSize = 256;
+        std::atomic<bool> useFixedBlockSize {false};
+
+        // Reverb engine of the Sky, chosen per instance
+        std::atomic<Sky::Engine> selectedSkyEngine {Sky::Engine::lifted};
+        ReBlocker reBlocker;
 
         // Buffers for processing
         juce::AudioBuffer<float> dryBuffer;
-        juce::AudioBuffer<float> skyBuffer;
+        juce::AudioBuffer<float> hostDryBuffer;
+        juce::AudioBuffer<float> coreBuffer;
+
+        // Diffusion and delay outputs of every band, laid out in one arena
+        BufferArena bandBufferArena;
+        BufferSpan diffusionBandBuffers;
+        BufferSpan delayBandBuffers;
 
-        std::vector<std::unique_ptr<juce::AudioBuffer<float>>> diffusionBandBuffers;
-        std::vector<std::unique_ptr<juce::AudioBuffer<float>>> delayBandBuffers;
+        // Runs the control-rate timers of the processors below on the audio clock
+        ControlScheduler controlScheduler;
 
         // Audio Processors: Input, Sky, EdgeTree, DelayNetwork, Output
         InputNode inputNode;
         Sky sky;
+        SkyWorker skyWorker;
         EdgeTree edgeTree;
         DelayNetwork delayNetwork;
         OutputNode outputNode;
@@ -166,7 +292,8 @@ class MyceliaModel :
             .foldWindowShape = 1.0f,
             .foldWindowSize = 1.0f,
             .entanglement = 50.0f,
-            .growthRate = 50.0f
+            .growthRate = 50.0f,
+            .freezeWhenStill = false
         };
         // Parameters for OutputNode
         OutputNode::Parameters currentOutputParams =
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+
+/**
+ * Backing memory for the checkoutBlock()/returnBlock() hooks of the sst effects.
+ *
+ * One block is reserved up front and handed out in 16-byte aligned slices;
+ * returned slices are kept on a short free list and reused for requests
+ * that fit. Only requests made before any reservation, or that no longer
+ * fit, fall back to the heap.
+ */
+class BlockPool
+{
+    public:
+        BlockPool() = default;
+
+        // Reserve the pool (allocates, and only while nothing is checked out)
+        void reserve(size_t numBytes)
+        {
+            if (used > 0 || numBytes <= capacity)
+            {
+                return;
+            }
+
+            storage.allocate(numBytes + alignment, true);
+            base = juce::snapPointerToAlignment(storage.get(), alignment);
+            capacity = numBytes;
+        }
+
+        uint8_t *checkout(size_t numBytes)
+        {
+            // Reuse the smallest returned slice that fits
+            auto best = -1;
+            for (auto i = 0; i < numFreeSlices; ++i)
+            {
+                if (freeSlices[i].size >= numBytes && (best < 0 || freeSlices[i].size < freeSlices[best].size))
+                {
+                    best = i;
+                }
+            }
+            if (best >= 0)
+            {
+                auto *ptr = freeSlices[best].ptr;
+                freeSlices[best] = freeSlices[--numFreeSlices];
+                return ptr;
+            }
+
+            const auto size = (numBytes + alignment - 1) / alignment * alignment;
+            if (base != nullptr && used + size <= capacity)
+            {
+                auto *ptr = base + used;
+                used += size;
+                return ptr;
+            }
+
+            return new uint8_t[numBytes];
+        }
+
+        void giveBack(uint8_t *ptr, size_t numBytes)
+        {
+            if (ptr == nullptr)
+            {
+                return;
+            }
+
+            if (base == nullptr || ptr < base || ptr >= base + capacity)
+            {
+                delete[] ptr;
+                return;
+            }
+
+            // A slice that doesn't fit the free list stays unused until the pool is dropped
+            if (numFreeSlices < maxFreeSlices)
+            {
+                freeSlices[numFreeSlices++] = {ptr, (numBytes + alignment - 1) / alignment * alignment};
+            }
+        }
+
+    private:
+        static constexpr size_t alignment = 16;
+        static constexpr int maxFreeSlices = 32;
+
+        struct Slice
+        {
+            uint8_t *ptr = nullptr;
+            size_t size = 0;
+        };
+
+        juce::HeapBlock<uint8_t> storage;
+        uint8_t *base = nullptr;
+        size_t capacity = 0;
+        size_t used = 0;
+
+        std::array<Slice, maxFreeSlices> freeSlices;
+        int numFreeSlices = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockPool)
+};
@@ -0,0 +1,53 @@
+#include "BufferArena.h"
+
+void BufferArena::prepare(int newNumBuffers, int newNumChannels, int newMaxNumSamples)
+{
+    numChannels = juce::jmax(1, newNumChannels);
+    maxNumSamples = juce::jmax(1, newMaxNumSamples);
+    numSamples = maxNumSamples;
+
+    // Round every channel up to whole cache lines, so the next one starts aligned too
+    constexpr auto floatsPerLine = alignmentBytes / sizeof(float);
+    const auto channelStride = (static_cast<size_t>(maxNumSamples) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+    const auto numBuffers = static_cast<size_t>(juce::jmax(0, newNumBuffers));
+    const auto numChannelsTotal = numBuffers * static_cast<size_t>(numChannels);
+
+    buffers.clear();
+    storage.allocate(numChannelsTotal * channelStride * sizeof(float) + alignmentBytes, true);
+    auto *data = reinterpret_cast<float *>(juce::snapPointerToAlignment(storage.get(), alignmentBytes));
+
+    channelPointers.resize(numChannelsTotal);
+    for (size_t ch = 0; ch < numChannelsTotal; ++ch)
+    {
+        channelPointers[ch] = data + ch * channelStride;
+    }
+
+    buffers.reserve(numBuffers);
+    for (size_t buffer = 0; buffer < numBuffers; ++buffer)
+    {
+        buffers.emplace_back(&channelPointers[buffer * static_cast<size_t>(numChannels)], numChannels, maxNumSamples);
+    }
+}
+
+void BufferArena::setNumSamples(int newNumSamples)
+{
+    newNumSamples = juce::jlimit(0, maxNumSamples, newNumSamples);
+    if (newNumSamples == numSamples)
+    {
+        return;
+    }
+
+    numSamples = newNumSamples;
+    for (size_t buffer = 0; buffer < buffers.size(); ++buffer)
+    {
+        buffers[buffer].setDataToReferTo(&channelPointers[buffer * static_cast<size_t>(numChannels)], numChannels, numSamples);
+    }
+}
+
+void BufferArena::clear()
+{
+    for (auto &buffer : buffers)
+    {
+        buffer.clear();
+    }
+}
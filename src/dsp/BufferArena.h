@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <span>
+#include <vector>
+
+// A run of buffers handed out by a BufferArena (or any contiguous array of buffers)
+using BufferSpan = std::span<juce::AudioBuffer<float>>;
+
+/**
+ * A set of equally sized multichannel buffers laid out in one contiguous,
+ * 64-byte aligned block. Every channel starts on its own cache line.
+ *
+ * The buffers are AudioBuffer views that refer to the arena's memory: they
+ * are only (re)built by prepare(), and setNumSamples() re-points them at the
+ * length of the current block without allocating. Don't call setSize() or
+ * makeCopyOf() on them, which would give them storage of their own.
+ */
+class BufferArena
+{
+    public:
+        BufferArena() = default;
+
+        // Lay out the buffers (allocates, call from prepare)
+        void prepare(int numBuffers, int numChannels, int maxNumSamples);
+
+        // Make every buffer numSamples long (audio thread, never allocates)
+        void setNumSamples(int numSamples);
+
+        // Clear the samples of every buffer
+        void clear();
+
+        BufferSpan getBuffers() { return buffers; }
+        BufferSpan getBuffers(size_t first, size_t count) { return BufferSpan(buffers).subspan(first, count); }
+        juce::AudioBuffer<float> &getBuffer(size_t index) { return buffers[index]; }
+
+        size_t getNumBuffers() const { return buffers.size(); }
+        int getNumSamples() const { return numSamples; }
+
+    private:
+        static constexpr size_t alignmentBytes = 64;
+
+        juce::HeapBlock<char> storage;
+        std::vector<float *> channelPointers;          // [buffer * numChannels + channel]
+        std::vector<juce::AudioBuffer<float>> buffers;
+
+        int numChannels = 0;
+        int maxNumSamples = 0;
+        int numSamples = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BufferArena)
+};
@@ -0,0 +1,118 @@
+#include "ConnectionMatrix.h"
+#include "sst/basic-blocks/simd/setup.h"
+
+void ConnectionMatrix::resize(int newNumNodes)
+{
+    numNodes = juce::jmax(0, newNumNodes);
+    numActiveNodes = numNodes;
+    stride = (static_cast<size_t>(numNodes) + 3) / 4 * 4;
+
+    weights.assign(static_cast<size_t>(numNodes) * stride, 0.0f);
+    outgoingSums.assign(static_cast<size_t>(numNodes), 0.0f);
+    numSumUpdates.assign(static_cast<size_t>(numNodes), 0);
+}
+
+void ConnectionMatrix::clear()
+{
+    std::fill(weights.begin(), weights.end(), 0.0f);
+    std::fill(outgoingSums.begin(), outgoingSums.end(), 0.0f);
+    std::fill(numSumUpdates.begin(), numSumUpdates.end(), 0);
+}
+
+void ConnectionMatrix::setNumActiveNodes(int newNumActiveNodes)
+{
+    newNumActiveNodes = juce::jlimit(0, numNodes, newNumActiveNodes);
+    if (newNumActiveNodes == numActiveNodes)
+    {
+        return;
+    }
+
+    numActiveNodes = newNumActiveNodes;
+    updateOutgoingSums();
+}
+
+void ConnectionMatrix::set(int target, int source, float weight)
+{
+    auto &current = weights[index(target, source)];
+    const auto change = weight - current;
+    current = weight;
+
+    if (target < numActiveNodes)
+    {
+        if (++numSumUpdates[static_cast<size_t>(source)] >= resyncInterval)
+        {
+            updateOutgoingSum(source);
+        }
+        else
+        {
+            outgoingSums[static_cast<size_t>(source)] += change;
+        }
+    }
+}
+
+void ConnectionMatrix::normaliseOutgoing(int source, float headroom)
+{
+    // The connections are scanned to scale them anyway, so start from the exact sum
+    updateOutgoingSum(source);
+    auto &sum = outgoingSums[static_cast<size_t>(source)];
+
+    const auto scale = 1.0f / (sum + headroom);
+    auto *outgoing = weights.data() + static_cast<size_t>(source) * stride;
+    for (int target = 0; target < numActiveNodes; ++target)
+    {
+        outgoing[target] *= scale;
+    }
+    sum *= scale;
+}
+
+void ConnectionMatrix::multiply(const float *levels, float *flows, int numNodesToMix) const
+{
+    const auto n = static_cast<size_t>(juce::jlimit(0, numNodes, numNodesToMix));
+    const auto numVectorTargets = n / 4 * 4;
+
+    std::fill(flows, flows + n, 0.0f);
+
+    // Add the outgoing connections of every source, scaled by its level. Silent sources are skipped
+    for (size_t source = 0; source < n; ++source)
+    {
+        const auto level = levels[source];
+        if (level == 0.0f)
+        {
+            continue;
+        }
+
+        const auto *outgoing = weights.data() + source * stride;
+        const auto levelVector = SIMD_MM(set1_ps)(level);
+        for (size_t target = 0; target < numVectorTargets; target += 4)
+        {
+            const auto flow = SIMD_MM(add_ps)(SIMD_MM(loadu_ps)(flows + target), SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(outgoing + target), levelVector));
+            SIMD_MM(storeu_ps)(flows + target, flow);
+        }
+        for (size_t target = numVectorTargets; target < n; ++target)
+        {
+            flows[target] += outgoing[target] * level;
+        }
+    }
+}
+
+void ConnectionMatrix::updateOutgoingSum(int source)
+{
+    const auto *outgoing = weights.data() + static_cast<size_t>(source) * stride;
+    float sum = 0.0f;
+    for (int target = 0; target < numActiveNodes; ++target)
+    {
+        sum += outgoing[target];
+    }
+
+    // Weights are never negative, rounding aside
+    outgoingSums[static_cast<size_t>(source)] = juce::jmax(0.0f, sum);
+    numSumUpdates[static_cast<size_t>(source)] = 0;
+}
+
+void ConnectionMatrix::updateOutgoingSums()
+{
+    for (int source = 0; source < numNodes; ++source)
+    {
+        updateOutgoingSum(source);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * Connection strengths between the delay nodes of every colony, as one flat matrix
+ * stored source-major: the outgoing connections of a node are contiguous.
+ *
+ * The outgoing sum of every node is kept up to date as weights are set. To stop rounding
+ * from piling up, a node's sum is recomputed exactly every resyncInterval changes, when the
+ * node is normalised and when the active nodes change. Only the first numActiveNodes targets
+ * count towards the sums and are normalised, as colonies are switched on and off from the end.
+ * The incoming flow of every node is one matrix-vector product.
+ */
+class ConnectionMatrix
+{
+    public:
+        ConnectionMatrix() = default;
+
+        // Allocates: every weight is cleared and every node is active
+        void resize(int numNodes);
+        void clear();
+
+        int getNumNodes() const { return numNodes; }
+
+        // Rows from numActiveNodes on are left out of the column sums and normalisation
+        void setNumActiveNodes(int newNumActiveNodes);
+        int getNumActiveNodes() const { return numActiveNodes; }
+
+        float get(int target, int source) const { return weights[index(target, source)]; }
+        void set(int target, int source, float weight);
+
+        // Sum of the connections from a node to the active nodes
+        float getOutgoingSum(int source) const { return outgoingSums[static_cast<size_t>(source)]; }
+
+        // Divide the connections from a node to the active nodes by their sum plus headroom
+        void normaliseOutgoing(int source, float headroom);
+
+        // flows[target] = sum of weight * levels[source] over the first numNodesToMix targets and sources
+        void multiply(const float *levels, float *flows, int numNodesToMix) const;
+
+    private:
+        static constexpr int resyncInterval = 64;
+
+        size_t index(int target, int source) const { return static_cast<size_t>(source) * stride + static_cast<size_t>(target); }
+        void updateOutgoingSum(int source);
+        void updateOutgoingSums();
+
+        int numNodes = 0;
+        int numActiveNodes = 0;
+        size_t stride = 0;                  // Length of a node's outgoing connections, padded to whole SIMD registers
+        std::vector<float> weights;         // [source][target]
+        std::vector<float> outgoingSums;    // [source], over the active targets
+        std::vector<int> numSumUpdates;     // [source], changes since the sum was last recomputed
+
+        JUCE_LEAK_DETECTOR(ConnectionMatrix)
+};
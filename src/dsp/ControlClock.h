@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * Sample clock for control-rate work. Ticks fall every interval samples
+ * regardless of how the audio is split into blocks, so control updates
+ * happen at the same points in time for any host block size.
+ */
+class ControlClock
+{
+    public:
+        static constexpr int defaultInterval = 64;
+
+        explicit ControlClock(int intervalSamples = defaultInterval) : interval(juce::jmax(1, intervalSamples)) {}
+
+        void reset() { position = 0; }
+
+        int getInterval() const { return interval; }
+
+        // True when the next sample starts a control period
+        bool isTick() const { return position == 0; }
+
+        // Samples left in the current control period
+        int getSamplesToNextTick() const { return interval - position; }
+
+        // Number of ticks that fall within the next numSamples samples
+        int countTicks(int numSamples) const
+        {
+            const auto firstTick = (interval - position) % interval;
+            return (numSamples > firstTick) ? 1 + (numSamples - 1 - firstTick) / interval : 0;
+        }
+
+        // Move the clock on, returns true when a tick fell within these samples
+        bool advance(int numSamples)
+        {
+            const auto ticked = (position == 0) || (position + numSamples > interval);
+            position = (position + numSamples) % interval;
+            return ticked;
+        }
+
+    private:
+        int interval;
+        int position = 0;
+};
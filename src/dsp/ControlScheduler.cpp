@@ -0,0 +1,200 @@
+#include "ControlScheduler.h"
+
+namespace
+{
+    // The timer whose callback the calling thread is in, which may stop itself without waiting
+    thread_local const ControlTimer *timerInCallback = nullptr;
+}
+
+ControlTimer::ControlTimer(ControlScheduler *scheduler) :
+    scheduler(scheduler)
+{
+    if (scheduler != nullptr)
+    {
+        scheduler->addTimer(this);
+    }
+}
+
+ControlTimer::~ControlTimer()
+{
+    // The derived destructor has to stop the timer while the members its callback uses still exist
+    jassert(!isTimerRunning());
+
+    if (scheduler != nullptr)
+    {
+        scheduler->removeTimer(this);
+    }
+}
+
+void ControlTimer::startTimer(int newIntervalMs)
+{
+    // The restart flag must be visible before the interval
+    restartPending = true;
+    intervalMs = juce::jmax(1, newIntervalMs);
+}
+
+void ControlTimer::startTimerHz(int rateHz)
+{
+    if (rateHz > 0)
+    {
+        startTimer(1000 / rateHz);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void ControlTimer::stopTimer()
+{
+    intervalMs = 0;
+
+    // A callback that was running may have restarted the timer, stop it again once it is done
+    if (scheduler != nullptr && timerInCallback != this)
+    {
+        scheduler->waitForCallback(this);
+        while (isTimerRunning())
+        {
+            intervalMs = 0;
+            scheduler->waitForCallback(this);
+        }
+    }
+}
+
+//==============================================================================
+ControlScheduler::ControlScheduler() :
+    juce::Thread("Mycelia control scheduler")
+{
+}
+
+ControlScheduler::~ControlScheduler()
+{
+    stop();
+}
+
+void ControlScheduler::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    if (!isThreadRunning())
+    {
+        startThread(juce::Thread::Priority::normal);
+    }
+}
+
+void ControlScheduler::stop()
+{
+    stopThread(2000);
+}
+
+void ControlScheduler::setRealtime(bool isRealtime)
+{
+    runOnAudioThread = !isRealtime;
+}
+
+void ControlScheduler::advance(int numSamples)
+{
+    // Offline, the timers due at the start of this block run before it is processed
+    if (runOnAudioThread)
+    {
+        runDueTimers();
+    }
+
+    clockSamples += numSamples;
+}
+
+void ControlScheduler::addTimer(ControlTimer *timer)
+{
+    for (auto &slot : timers)
+    {
+        ControlTimer *empty = nullptr;
+        if (slot.compare_exchange_strong(empty, timer))
+        {
+            return;
+        }
+    }
+
+    // Raise maxNumTimers
+    jassertfalse;
+}
+
+void ControlScheduler::removeTimer(ControlTimer *timer)
+{
+    for (auto &slot : timers)
+    {
+        auto *registered = timer;
+        slot.compare_exchange_strong(registered, nullptr);
+    }
+    waitForCallback(timer);
+}
+
+void ControlScheduler::waitForCallback(const ControlTimer *timer) const
+{
+    // The runner publishes the timer before it checks the slot and interval, so one of the two sees the other
+    while (currentTimer.load() == timer)
+    {
+        juce::Thread::yield();
+    }
+}
+
+void ControlScheduler::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(pollIntervalMs);
+
+        if (!runOnAudioThread)
+        {
+            runDueTimers();
+        }
+    }
+}
+
+void ControlScheduler::runDueTimers()
+{
+    if (runningTimers.exchange(true))
+    {
+        return;
+    }
+
+    const auto now = clockSamples.load();
+    const auto samplesPerMs = sampleRate.load() / 1000.0;
+
+    for (auto &slot : timers)
+    {
+        // Claim the timer before touching it, then make sure it was not removed or stopped in the meantime
+        auto *timer = slot.load();
+        currentTimer = timer;
+        if (timer == nullptr || slot.load() != timer)
+        {
+            continue;
+        }
+
+        const auto intervalMs = timer->intervalMs.load();
+        if (intervalMs <= 0)
+        {
+            continue;
+        }
+
+        const auto intervalSamples = juce::jmax(static_cast<juce::int64>(1), static_cast<juce::int64>(intervalMs * samplesPerMs));
+
+        // A (re)started timer first fires one interval from now
+        if (timer->restartPending.exchange(false))
+        {
+            timer->nextDueSample = now + intervalSamples;
+            continue;
+        }
+
+        // Late timers fire once and do not try to catch up, like juce::Timer
+        if (now >= timer->nextDueSample)
+        {
+            timer->nextDueSample = now + intervalSamples;
+            timerInCallback = timer;
+            timer->timerCallback();
+            timerInCallback = nullptr;
+        }
+    }
+
+    currentTimer = nullptr;
+    runningTimers = false;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+class ControlScheduler;
+
+/**
+ * Stand-in for juce::Timer whose callbacks are run by a ControlScheduler
+ * rather than the message thread. Intervals are counted on the audio clock.
+ * Without a scheduler the timer never fires.
+ *
+ * Derived classes must call stopTimer() first thing in their destructor: it
+ * waits for a callback that is still running on another thread, while the
+ * members the callback uses are alive.
+ */
+class ControlTimer
+{
+    public:
+        explicit ControlTimer(ControlScheduler *scheduler);
+        virtual ~ControlTimer();
+
+        void startTimer(int intervalMs);
+        void startTimerHz(int rateHz);
+
+        // Once this returns the callback is not running, unless it is called from the callback itself
+        void stopTimer();
+        bool isTimerRunning() const { return intervalMs.load() > 0; }
+
+    private:
+        friend class ControlScheduler;
+
+        virtual void timerCallback() = 0;
+
+        ControlScheduler *scheduler = nullptr;
+        std::atomic<int> intervalMs {0};
+        std::atomic<bool> restartPending {false};
+        juce::int64 nextDueSample = 0; // Only touched by the scheduler
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControlTimer)
+};
+
+/**
+ * Runs the control-rate tasks of the engine (parameter application, topology
+ * growth, ...) at their configured intervals, measured in processed samples.
+ *
+ * In realtime the due timers run on the scheduler's own thread, so a busy or
+ * missing message loop does not hold them up. Offline they run inline on the
+ * audio thread at the start of the block they fall due in, so renders get the
+ * same control updates at the same sample positions however fast they run.
+ * Neither takes a lock: the timers sit in atomic slots, and the thread that
+ * runs them claims each one before touching it, which is what removal and
+ * stopTimer() wait on.
+ */
+class ControlScheduler :
+    private juce::Thread
+{
+    public:
+        ControlScheduler();
+        ~ControlScheduler() override;
+
+        void prepare(double sampleRate);
+
+        // Stop running timers, before the objects that own them are destroyed
+        void stop();
+
+        void setRealtime(bool isRealtime);
+
+        // Audio thread: account for a block that is about to be processed
+        void advance(int numSamples);
+
+    private:
+        friend class ControlTimer;
+
+        // Poll period of the scheduler thread, the audio thread never waits on it
+        static constexpr int pollIntervalMs = 5;
+
+        static constexpr int maxNumTimers = 16;
+
+        // Registration happens off the audio thread, removal waits for a callback of the timer that is running
+        void addTimer(ControlTimer *timer);
+        void removeTimer(ControlTimer *timer);
+        void waitForCallback(const ControlTimer *timer) const;
+
+        void run() override;
+
+        // Never waits: returns straight away if the other thread is running the timers
+        void runDueTimers();
+
+        // Slots of the registered timers, read by the thread that runs them without taking a lock
+        std::array<std::atomic<ControlTimer *>, maxNumTimers> timers {};
+
+        // Only one thread runs the timers at a time, while switching between realtime and offline
+        std::atomic<bool> runningTimers {false};
+        std::atomic<ControlTimer *> currentTimer {nullptr};
+
+        std::atomic<juce::int64> clockSamples {0};
+        std::atomic<double> sampleRate {44100.0};
+        std::atomic<bool> runOnAudioThread {false};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ControlScheduler)
+};
@@ -1,24 +1,16 @@
 #include "DelayNetwork.h"
 #include "util/Utils.h"
 
-DelayNetwork::DelayNetwork()
+DelayNetwork::DelayNetwork(ControlScheduler &scheduler) :
+    ControlTimer(&scheduler),
+    delayNodes(ParameterRanges::maxNutrientBands, &scheduler)
 {
-    diffusionBandFrequencies.resize(ParameterRanges::maxNutrientBands);
     startTimerHz(4); // Start the timer for parameter updates
 }
 
 DelayNetwork::~DelayNetwork()
 {
-    // Clean up any resources
-    for (auto &buffer : diffusionBandBuffers)
-    {
-        buffer->clear();
-    }
-    for (auto &buffer : delayBandBuffers)
-    {
-        buffer->clear();
-    }
-    diffusionBandFrequencies.clear();
+    stopTimer();
 }
 
 void DelayNetwork::prepare(const juce::dsp::ProcessSpec &spec)
@@ -27,40 +19,34 @@ void DelayNetwork::prepare(const juce::dsp::ProcessSpec &spec)
     // numChannels = spec.numChannels;
     // blockSize = spec.maximumBlockSize;
 
-    diffusionBandFrequencies.resize(ParameterRanges::maxNutrientBands);
-
     // Prepare the diffusion control
     diffusionControl.prepare(spec);
 
     // Prepare the delay nodes
     delayNodes.prepare(spec);
+    networkFreeze.prepare(spec, delayNodes);
 
     updateDiffusionDelayNodesParams();
 }
 
+void DelayNetwork::setQuality(const ProcessingQuality &quality)
+{
+    diffusionControl.setQuality(quality);
+    delayNodes.setQuality(quality);
+}
+
 void DelayNetwork::reset()
 {
     // Reset all internal states
     diffusionControl.reset();
     delayNodes.reset();
-
-    // Clear the diffusion band buffers
-    for (auto &buffer : diffusionBandBuffers)
-    {
-        buffer->clear();
-    }
-
-    // Clear the delay band buffers
-    for (auto &buffer : delayBandBuffers)
-    {
-        buffer->clear();
-    }
+    networkFreeze.reset();
 }
 
 template <typename ProcessContext>
 void DelayNetwork::process(const ProcessContext &context,
-                           std::vector<std::unique_ptr<juce::AudioBuffer<float>>>  &diffusionBandBuffers,
-                           std::vector<std::unique_ptr<juce::AudioBuffer<float>>>  &delayBandBuffers)
+                           BufferSpan diffusionBandBuffers,
+                           BufferSpan delayBandBuffers)
 {
     // Manage audio context
     const auto &inputBlock = context.getInputBlock();
@@ -86,17 +72,8 @@ void DelayNetwork::process(const ProcessContext &context,
     // Process through diffusion control
     diffusionControl.process(context, diffusionBandBuffers);
 
-    // Copy diffusion band buffers to delay band buffers
-    for (int band = 0; band < inActiveFilterBands; ++band)
-    {
-        juce::dsp::AudioBlock<float> diffusionBlock(*diffusionBandBuffers[band].get());
-        juce::dsp::AudioBlock<float> delayBlock (*delayBandBuffers[band].get());
-
-        delayBlock.copyFrom(diffusionBlock);
-    }
-
-    // Process through delay nodes
-    delayNodes.process(delayBandBuffers);
+    // Process the diffusion bands through delay nodes (or their captured response, while frozen)
+    networkFreeze.process(diffusionBandBuffers, delayBandBuffers, inActiveFilterBands, delayNodes);
 }
 
 void DelayNetwork::setParameters(const Parameters &params)
@@ -156,6 +133,7 @@ void DelayNetwork::setParameters(const Parameters &params)
         inGrowthRate = ParameterRanges::growthRateRange.snapToLegalValue(params.growthRate);
         growthRateChanged = true;
     }
+    inFreezeWhenStill = params.freezeWhenStill;
 }
 
 void DelayNetwork::timerCallback()
@@ -166,7 +144,6 @@ void DelayNetwork::timerCallback()
         foldPositionChanged || foldWindowShapeChanged || foldWindowSizeChanged ||
         entanglementChanged || growthRateChanged)
     {
-        allocateBandBuffers(inActiveFilterBands);
         updateDiffusionDelayNodesParams();
 
         numActiveFilterBandsChanged = false;
@@ -181,12 +158,34 @@ void DelayNetwork::timerCallback()
         entanglementChanged = false;
         growthRateChanged = false;
     }
+
+    updateFreezeState();
 }
 
-// Allocate buffers based on the number of bands
-void DelayNetwork::allocateBandBuffers(int numBands)
+void DelayNetwork::updateFreezeState()
 {
-    diffusionBandFrequencies.resize(numBands);
+    // The network is only (close to) time-invariant while it is not growing
+    const auto canFreeze = inFreezeWhenStill && (inGrowthRate <= ParameterRanges::growthRateRange.start);
+    delayNodes.setGrowthPaused(canFreeze);
+
+    if (!canFreeze)
+    {
+        networkFreeze.requestThaw();
+        return;
+    }
+
+    if (networkFreeze.isFreezeRequested())
+    {
+        // Any change to the topology invalidates the captured response
+        if (networkFreeze.getCapturedVersion() != delayNodes.getTopologyVersion())
+        {
+            networkFreeze.requestThaw();
+        }
+    }
+    else if (networkFreeze.canStartCapture())
+    {
+        networkFreeze.startCapture(delayNodes);
+    }
 }
 
 void DelayNetwork::updateDiffusionDelayNodesParams()
@@ -195,7 +194,7 @@ void DelayNetwork::updateDiffusionDelayNodesParams()
     baseDelayMs = (60.0f / inTempoValue) * 1000.0f;
 
     // Calculate the compression threshold and ratio based on the scarcity/abundance value
-    auto normalizedScarAbundance = ParameterRanges::normalizeParameter(ParameterRanges::scarcityAbundanceRange, inScarcityAbundance);
+    auto normalizedScarAbundance = ParameterRanges::scarcityAbundanceMapping.normalise(inScarcityAbundance);
 
     compressorParams.threshold = -6.0f * (normalizedScarAbundance);
     compressorParams.ratio = 1.0f + (3.0f * normalizedScarAbundance);
@@ -209,7 +208,7 @@ void DelayNetwork::updateDiffusionDelayNodesParams()
 
     // Update delay nodes parameters
     delayNodes.setParameters(DelayNodes::Parameters{.numColonies = inActiveFilterBands,
-                                                    .bandFrequencies = std::vector<float>(dataPtr, dataPtr + inActiveFilterBands),
+                                                    .bandFrequencies = diffusionBandFrequencies,
                                                     .stretch = inStretch,
                                                     .scarcityAbundance = inScarcityAbundance,
                                                     .foldPosition = inFoldPosition,
@@ -225,6 +224,6 @@ void DelayNetwork::updateDiffusionDelayNodesParams()
 
 // Explicitly instantiate the templates for the supported context types
 template void DelayNetwork::process<juce::dsp::ProcessContextReplacing<float>>(const juce::dsp::ProcessContextReplacing<float> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &, std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
+    BufferSpan, BufferSpan);
 template void DelayNetwork::process<juce::dsp::ProcessContextNonReplacing<float>>(const juce::dsp::ProcessContextNonReplacing<float> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &, std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
+    BufferSpan, BufferSpan);
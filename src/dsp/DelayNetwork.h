@@ -1,13 +1,15 @@
 #pragma once
 
+#include "ControlScheduler.h"
 #include "DiffusionControl.h"
 #include "DelayNodes.h"
+#include "NetworkFreeze.h"
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <array>
 
 class DelayNetwork
-    : private juce::Timer
+    : private ControlTimer
 {
     public:
         // Parameters
@@ -24,9 +26,10 @@ class DelayNetwork
             float foldWindowSize;            // Controls the fold window size (0.2-1.0)
             float entanglement;              // Controls the diffusion and cross-feedback (0-100)
             float growthRate;                // Controls the delay network growth (0-100)
+            bool  freezeWhenStill;           // Replaces the node graph with its impulse response while not growing
         };
 
-        DelayNetwork();
+        explicit DelayNetwork(ControlScheduler &scheduler);
         ~DelayNetwork();
 
         // processing functions
@@ -35,8 +38,8 @@ class DelayNetwork
 
         template <typename ProcessContext>
         void process(const ProcessContext &context,
-                     std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &diffusionBandBuffers,
-                     std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &delayBandBuffers);
+                     BufferSpan diffusionBandBuffers,
+                     BufferSpan delayBandBuffers);
 
         void setParameters(const Parameters &params);
 
@@ -45,9 +48,18 @@ class DelayNetwork
         // Get the band states from the delay nodes
         std::vector<DelayNodes::BandResources>& getBandStates() { return delayNodes.getBandState(); }
 
+        // Get the connection strengths between the delay nodes
+        const ConnectionMatrix& getConnections() const { return delayNodes.getConnections(); }
+
         // Get the position of the trees in the network
         std::vector<int>& getTreePositions() { return delayNodes.getTreePositions(); }
 
+        // True when the delay nodes (or their frozen response) hold no energy
+        bool isSilent() const { return networkFreeze.isSilent(delayNodes); }
+
+        // Trade accuracy for CPU time (the diffusion filter slope is applied on the next prepare)
+        void setQuality(const ProcessingQuality &quality);
+
     private:
         float fs = 44100.0f;
 
@@ -63,6 +75,7 @@ class DelayNetwork
         float inFoldWindowSize;
         float inEntanglement;
         float inGrowthRate;
+        bool  inFreezeWhenStill = false;
         // Booleans for parameter changes
         bool  numActiveFilterBandsChanged = false;
         bool  treeDensityChanged = false;
@@ -76,9 +89,6 @@ class DelayNetwork
         bool  entanglementChanged = false;
         bool  growthRateChanged = false;
 
-        // Allocate delay processors and buffers based on the number of colonies and nodes
-        void allocateBandBuffers(int numBands);
-
         // Base delay time in milliseconds (quarter note time)
         float baseDelayMs = 0.0f;
 
@@ -101,14 +111,18 @@ class DelayNetwork
         // Delay nodes processor
         DelayNodes delayNodes;
 
-        // Output buffers
-        std::vector<float>                                     diffusionBandFrequencies;
-        std::vector<std::unique_ptr<juce::AudioBuffer<float>>> diffusionBandBuffers;
-        std::vector<std::unique_ptr<juce::AudioBuffer<float>>> delayBandBuffers;
+        // Convolution stand-in for the delay nodes while the network is not growing
+        NetworkFreeze networkFreeze;
+
+        // Centre frequencies of the diffusion bands
+        std::array<float, ParameterRanges::maxNutrientBands> diffusionBandFrequencies {};
 
         // Update the diffusion and delay nodes parameters
         void updateDiffusionDelayNodesParams();
 
+        // Start or stop freezing the network depending on growth and topology changes
+        void updateFreezeState();
+
         // Timer callback for parameter changes
         void timerCallback();
 
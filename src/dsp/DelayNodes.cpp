@@ -1,15 +1,27 @@
 #include "DelayNodes.h"
 
-DelayNodes::DelayNodes(size_t numBands)
+DelayNodes::DelayNodes(size_t numBands, ControlScheduler *scheduler) :
+    ControlTimer(scheduler)
 {
-    // Ensure we have enough delay processors
-    allocateDelayProcessors(inNumColonies, maxNumDelayProcsPerBand);
+    // Every node is live until the routing is analysed
+    for (auto &table : requiredTreeTables)
+    {
+        for (auto &band : table)
+        {
+            band.fill(1);
+        }
+    }
+
+    // Every colony and node is built up front, the band count only switches colonies on or off
+    allocateMaxTopology();
     updateFoldWindow();
     startTimer(2000); // Start the timer for parameter updates
 }
 
 DelayNodes::~DelayNodes()
 {
+    stopTimer();
+
     for (auto &band : bands)
     {
         band.clear();
@@ -22,9 +34,12 @@ void DelayNodes::prepare(const juce::dsp::ProcessSpec &spec)
     fs = static_cast<float>(spec.sampleRate);
     numChannels = spec.numChannels;
     blockSize = spec.maximumBlockSize;
+    kernels = &SimdKernels::get();
 
     // Prepare the delay processors
-    allocateDelayProcessors(ParameterRanges::maxNutrientBands, maxNumDelayProcsPerBand);
+    allocateBuffers();
+    // The tilt LFOs step once per control tick, so their frequencies are in Hz
+    modLfos.prepare(bands.size() * maxNumDelayProcsPerBand, spec.sampleRate / controlClock.getInterval());
 
     for (auto &band : bands)
     {
@@ -36,6 +51,26 @@ void DelayNodes::prepare(const juce::dsp::ProcessSpec &spec)
 
     // Initialize tree positions
     updateTreePositions();
+    updateReachability();
+    takeReachability();
+    controlClock.reset();
+
+    for (auto &gain : colonyGains)
+    {
+        gain.reset(spec.sampleRate, colonyFadeTimeSec);
+    }
+    reset();
+    randomiseModulationPhases();
+}
+
+// Start every node's LFO at its own phase, so the nodes don't modulate in lockstep
+void DelayNodes::randomiseModulationPhases()
+{
+    auto &random = juce::Random::getSystemRandom();
+    for (size_t lfo = 0; lfo < modLfos.getNumLfos(); ++lfo)
+    {
+        modLfos.setPhase(lfo, random.nextFloat());
+    }
 }
 
 void DelayNodes::reset()
@@ -47,60 +82,124 @@ void DelayNodes::reset()
             proc->reset();
         }
     }
+    controlClock.reset();
+
+    // Start from the current colony count without fading
+    numActiveColonies = numProcessedColonies = inNumColonies.load();
+    for (size_t band = 0; band < colonyGains.size(); ++band)
+    {
+        colonyGains[band].setCurrentAndTargetValue(static_cast<int>(band) < numActiveColonies ? 1.0f : 0.0f);
+    }
 }
 
-void DelayNodes::process(std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &delayBandBuffers)
+void DelayNodes::process(BufferSpan inputs, BufferSpan outputs)
 {
-    for (int band = 0; band < inNumColonies; ++band)
-    {
-        // Get the input buffer for this band
-        auto& inputBuffer = delayBandBuffers[band];
+    // Pick up the routing analysed since the last block
+    takeReachability();
+    const auto numProcessedTrees = getNumProcessedTrees();
+
+    // Pick up colonies switched on or off since the last block
+    updateColonyGains(static_cast<int>(juce::jmin(inputs.size(), outputs.size())));
+
+    // The node and tree buffers follow the length of the block
+    const auto numSamples = inputs[0].getNumSamples();
+    processorArena.setNumSamples(numSamples);
+    treeArena.setNumSamples(numSamples);
 
-        // Copy input to the first processor buffer
+    for (int band = 0; band < numProcessedColonies; ++band)
+    {
+        // The first node of a colony processes its input in place, the others read it through
+        // processNode. Colonies fading out only ring out, their band gets no new input
         auto &firstBuffer = getProcessorBuffer(band, 0);
-        firstBuffer.setSize(inputBuffer->getNumChannels(), inputBuffer->getNumSamples(), false, false, true);
-        firstBuffer.makeCopyOf(*inputBuffer);
+        if (band < numActiveColonies)
+        {
+            juce::dsp::AudioBlock<float>(firstBuffer).copyFrom(inputs[band]);
+        }
+        else
+        {
+            firstBuffer.clear();
+        }
+    }
 
-        // Process through each delay processor with its own persistent context
-        for (size_t i = 0; i < bands[band].delayProcs.size(); ++i)
+    // Clear all active tree output buffers
+    for (int band = 0; band < numProcessedColonies; ++band)
+    {
+        for (int tree = 0; tree < numProcessedTrees; ++tree)
         {
-            // If not the first processor, copy from previous processor's buffer
-            if (i > 0)
-            {
-                auto &currentBuffer = getProcessorBuffer(band, i);
-                currentBuffer.setSize(inputBuffer->getNumChannels(), inputBuffer->getNumSamples(), false, false, true);
-                currentBuffer.makeCopyOf(getProcessorBuffer(band, i - 1));
-            }
+            if (tree < bands[band].treeOutputBuffers.size())
+                bands[band].treeOutputBuffers[tree].clear();
         }
     }
 
-    // Update sidechain levels for all processors based on their positions
-    updateSidechainLevels();
+    // Run the network one control period at a time, so the node LFOs step and the sidechain levels
+    // of every node are refreshed at the sample where each control tick falls
+    for (int start = 0; start < numSamples;)
+    {
+        const auto segmentLength = juce::jmin(numSamples - start, controlClock.getSamplesToNextTick());
 
-    // Clear all active tree output buffers
-    for (int band = 0; band < inNumColonies; ++band)
+        if (controlClock.isTick())
+        {
+            modLfos.process();
+            updateSidechainLevels();
+        }
+
+        processSegment(inputs, start, segmentLength, numProcessedTrees);
+
+        controlClock.advance(segmentLength);
+        start += segmentLength;
+    }
+
+    // Now that all bands have been processed, combine tree outputs into the delay band buffers
+    for (int band = 0; band < numProcessedColonies; ++band)
     {
-        for (int tree = 0; tree < numActiveTrees; ++tree)
+        auto& outputBuffer = outputs[band];
+        outputBuffer.clear();
+
+        for (int treeIdx = 0; treeIdx < numProcessedTrees; ++treeIdx)
+        {
+            auto connectionGain = getTreeConnection(band, treeIdx);
+            if (connectionGain > 0.0f)
+            {
+                // Apply gain according to the tree connections and fold window
+                addWithGain(outputBuffer, getTreeBuffer(band, treeIdx), connectionGain * foldWindow[treeIdx], 0, outputBuffer.getNumSamples());
+            }
+        }
+
+        // Fade colonies that were switched on or off
+        auto &colonyGain = colonyGains[static_cast<size_t>(band)];
+        if (colonyGain.isSmoothing())
         {
-            if (tree < bands[band].treeOutputBuffers.size() && bands[band].treeOutputBuffers[tree])
-                bands[band].treeOutputBuffers[tree]->clear();
+            const auto startGain = colonyGain.getCurrentValue();
+            const auto endGain = colonyGain.skip(outputBuffer.getNumSamples());
+            outputBuffer.applyGainRamp(0, outputBuffer.getNumSamples(), startGain, endGain);
         }
+
+        // Apply normalization gain
+        // juce::dsp::AudioBlock<float> finalBlock(*outputBuffer);
+        // finalBlock.multiplyBy(inNumColonies);
     }
+}
 
+void DelayNodes::processSegment(BufferSpan inputs, int startSample, int numSamples, int numProcessedTrees)
+{
     // Process each band
-    for (int band = 0; band < inNumColonies; ++band)
+    for (int band = 0; band < numProcessedColonies; ++band)
     {
-        // Get the input buffer for this band
-        auto& inputBuffer = delayBandBuffers[band];
-
         // Process through each delay processor with its own persistent context
         for (size_t i = 0; i < bands[band].delayProcs.size(); ++i)
         {
+            // Nodes that cannot affect the output cost nothing (colonies fading out are
+            // no longer in the routing analysis and run in full until they are silent)
+            if (band < numActiveColonies && !isNodeReachable(band, i))
+            {
+                continue;
+            }
+
             // Process the current node
-            processNode(band, i);
+            processNode(band, i, inputs, startSample, numSamples);
 
             // Check if this node position is a tree tap point
-            for (int treeIdx = 0; treeIdx < numActiveTrees; ++treeIdx)
+            for (int treeIdx = 0; treeIdx < numProcessedTrees; ++treeIdx)
             {
                 auto connectionGain = getTreeConnection(band, treeIdx);
                 if (i == static_cast<size_t>(treePositions[treeIdx]) && connectionGain > 0.0f)
@@ -108,53 +207,46 @@ void DelayNodes::process(std::vector<std::unique_ptr<juce::AudioBuffer<float>>>
                     // This node is connected to a tree - route the audio to the tree output buffer
                     auto& procBuffer = getProcessorBuffer(band, i);
                     auto& treeBuffer = getTreeBuffer(band, treeIdx);
-
-                    // Ensure the tree buffer is sized correctly
-                    if (treeBuffer.getNumChannels() != procBuffer.getNumChannels() || 
-                        treeBuffer.getNumSamples() != procBuffer.getNumSamples())
-                    {
-                        treeBuffer.setSize(procBuffer.getNumChannels(), procBuffer.getNumSamples(), false, false, true);
-                    }
-                    treeBuffer.clear();
+                    treeBuffer.clear(startSample, numSamples);
 
                     // Add to the tree buffer with the connection gain
-                    for (int ch = 0; ch < procBuffer.getNumChannels(); ++ch)
-                    {
-                        treeBuffer.addFrom(
-                            ch, 0, procBuffer,
-                            ch, 0, procBuffer.getNumSamples(),
-                            connectionGain);
-                    }
+                    addWithGain(treeBuffer, procBuffer, connectionGain, startSample, numSamples);
                 }
             }
         }
     }
+}
 
-    // Now that all bands have been processed, combine tree outputs into the delay band buffers
-    for (int band = 0; band < inNumColonies; ++band)
+void DelayNodes::updateColonyGains(int numBandBuffers)
+{
+    const auto numColonies = juce::jmin(inNumColonies.load(), numBandBuffers, static_cast<int>(bands.size()));
+
+    numProcessedColonies = numColonies;
+    for (int band = 0; band < static_cast<int>(colonyGains.size()); ++band)
     {
-        auto& outputBuffer = delayBandBuffers[band];
-        outputBuffer->clear();
+        auto &colonyGain = colonyGains[static_cast<size_t>(band)];
+        const auto target = (band < numColonies) ? 1.0f : 0.0f;
 
-        for (int treeIdx = 0; treeIdx < numActiveTrees; ++treeIdx)
+        if (colonyGain.getTargetValue() != target)
         {
-            auto connectionGain = getTreeConnection(band, treeIdx);
-            if (connectionGain > 0.0f)
+            // A colony switched back on starts from silence, not from the tails it held before
+            if (target > 0.0f && colonyGain.getCurrentValue() <= 0.0f)
             {
-                auto& treeBuffer = getTreeBuffer(band, treeIdx);
-                for (int ch = 0; ch < outputBuffer->getNumChannels(); ++ch)
+                for (auto &proc : bands[static_cast<size_t>(band)].delayProcs)
                 {
-                    // Apply gain according to the tree connections and fold window
-                    outputBuffer->addFrom(ch, 0, treeBuffer, ch, 0,
-                                          outputBuffer->getNumSamples(), connectionGain * foldWindow[treeIdx]);
+                    proc->reset();
                 }
             }
+            colonyGain.setTargetValue(target);
         }
 
-        // Apply normalization gain
-        // juce::dsp::AudioBlock<float> finalBlock(*outputBuffer);
-        // finalBlock.multiplyBy(inNumColonies);
+        // Colonies fading out keep running until they are silent
+        if (band < numBandBuffers && (target > 0.0f || colonyGain.isSmoothing()))
+        {
+            numProcessedColonies = juce::jmax(numProcessedColonies, band + 1);
+        }
     }
+    numActiveColonies = numColonies;
 }
 
 void DelayNodes::updateDelayProcParams()
@@ -203,34 +295,39 @@ void DelayNodes::updateDelayProcParams()
             // Apply the variation to the base delay time
             bands[band].nodeDelayTimes[proc] = baseNodeDelayTimeMs * variationFactor;
 
-            // Set parameters for each delay processor in this colony
-            // Configure parameters using the delay time from our matrix
-            DelayProc::Parameters params;
-            params.delayMs = bands[band].nodeDelayTimes[proc];
-            params.feedback = 1.0f;
-            params.growthRate = inGrowthRate;
-            params.baseDelayMs = inBaseDelayMs;
-            if (bands[band].inBandFrequency)
-            {
-                params.filterFreq = bands[band].inBandFrequency;
-            }
-            else
-            {
-                params.filterFreq = 0.0f; // Default to 0.0 if no frequency is set
-            }
-            params.filterGainDb = 0.0f;
-            params.revTimeMs = 0.0f;
-
-            // Set compressor parameters
-            params.compressorParams = inCompressorParams;
-            params.useExternalSidechain = inUseExternalSidechain;
-
             // Set the parameters for this delay processor
-            bands[band].delayProcs[proc]->setParameters(params, false);
+            bands[band].delayProcs[proc]->setParameters(makeDelayProcParams(band, bands[band].nodeDelayTimes[proc]), false);
         }
     }
 }
 
+DelayProc::Parameters DelayNodes::makeDelayProcParams(size_t band, float delayMs) const
+{
+    // Set parameters for each delay processor in this colony
+    // Configure parameters using the delay time from our matrix
+    DelayProc::Parameters params;
+    params.delayMs = delayMs;
+    params.feedback = 1.0f;
+    params.growthRate = inGrowthRate;
+    params.baseDelayMs = inBaseDelayMs;
+    if (bands[band].inBandFrequency)
+    {
+        params.filterFreq = bands[band].inBandFrequency;
+    }
+    else
+    {
+        params.filterFreq = 0.0f; // Default to 0.0 if no frequency is set
+    }
+    params.filterGainDb = 0.0f;
+    params.revTimeMs = 0.0f;
+
+    // Set compressor parameters
+    params.compressorParams = inCompressorParams;
+    params.useExternalSidechain = inUseExternalSidechain;
+
+    return params;
+}
+
 void DelayNodes::setParameters(const Parameters &params)
 {
     // Check if the number of colonies is within the valid range
@@ -239,16 +336,19 @@ void DelayNodes::setParameters(const Parameters &params)
         return;
     }
 
-    allocateDelayProcessors(params.numColonies);
-
-    inNumColonies = params.numColonies;
+    // Only switches colonies on or off, they all exist already
+    const auto numColoniesChanged = (inNumColonies.exchange(params.numColonies) != params.numColonies);
+    if (numColoniesChanged)
+    {
+        topologyChanged();
+    }
 
-    for (size_t band = 0; band < inNumColonies; ++band)
+    for (size_t band = 0; band < static_cast<size_t>(params.numColonies); ++band)
     {
         // If we find a single difference in the band frequencies, we need to update all of them
         if (bands[band].inBandFrequency != params.bandFrequencies[band])
         {
-            for (size_t band = 0; band < inNumColonies; ++band)
+            for (size_t band = 0; band < static_cast<size_t>(params.numColonies); ++band)
             {
                 bands[band].inBandFrequency = params.bandFrequencies[band];
             }
@@ -320,158 +420,420 @@ void DelayNodes::setParameters(const Parameters &params)
     }
 }
 
-// Allocate delay processors and buffers based on the number of colonies
-void DelayNodes::allocateDelayProcessors(int numColonies, int numNodes)
+void DelayNodes::getTopologySnapshot(TopologySnapshot &snapshot) const
 {
-    if (numColonies < 1 || numColonies > ParameterRanges::maxNutrientBands)
+    snapshot.params.numColonies = inNumColonies;
+    snapshot.params.stretch = inStretch;
+    snapshot.params.scarcityAbundance = inScarcityAbundance;
+    snapshot.params.foldPosition = inFoldPosition;
+    snapshot.params.foldWindowShape = inFoldWindowShape;
+    snapshot.params.foldWindowSize = inFoldWindowSize;
+    snapshot.params.entanglement = inEntanglement;
+    snapshot.params.growthRate = inGrowthRate;
+    snapshot.params.baseDelayMs = inBaseDelayMs;
+    snapshot.params.treeDensity = inTreeDensity;
+    snapshot.params.compressorParams = inCompressorParams;
+    snapshot.params.useExternalSidechain = inUseExternalSidechain;
+
+    // Copy assignments reuse the storage of the snapshot when it is large enough
+    snapshot.numActiveTrees = numActiveTrees;
+    snapshot.treePositions = treePositions;
+    snapshot.foldWindow = foldWindow;
+    snapshot.connections = connections;
+
+    snapshot.treeConnections.resize(bands.size());
+    snapshot.nodeDelayTimes.resize(bands.size());
+    snapshot.nodeAges.resize(bands.size());
+    for (size_t bandIdx = 0; bandIdx < bands.size(); ++bandIdx)
     {
-        return;
+        const auto &band = bands[bandIdx];
+        snapshot.params.bandFrequencies[bandIdx] = band.inBandFrequency;
+        snapshot.treeConnections[bandIdx] = band.treeConnections;
+        snapshot.nodeDelayTimes[bandIdx] = band.nodeDelayTimes;
+
+        auto &ages = snapshot.nodeAges[bandIdx];
+        ages.resize(band.delayProcs.size());
+        for (size_t proc = 0; proc < band.delayProcs.size(); ++proc)
+        {
+            ages[proc] = band.delayProcs[proc] ? band.delayProcs[proc]->getAge() : 0.0f;
+        }
     }
+}
 
-    if (numNodes < 1 || numNodes > maxNumDelayProcsPerBand)
+void DelayNodes::reserveTopologySnapshot(TopologySnapshot &snapshot) const
+{
+    snapshot.treePositions.reserve(maxNumDelayProcsPerBand);
+    snapshot.foldWindow.reserve(maxNumDelayProcsPerBand);
+    snapshot.connections = connections;
+
+    snapshot.treeConnections.resize(bands.size());
+    snapshot.nodeDelayTimes.resize(bands.size());
+    snapshot.nodeAges.resize(bands.size());
+    for (size_t band = 0; band < bands.size(); ++band)
     {
-        return;
+        snapshot.treeConnections[band].reserve(maxNumDelayProcsPerBand);
+        snapshot.nodeDelayTimes[band].reserve(maxNumDelayProcsPerBand);
+        snapshot.nodeAges[band].reserve(maxNumDelayProcsPerBand);
     }
+}
 
-    // Check if we need to resize the delay processors and buffers
-    if (bands.size())
+void DelayNodes::applyTopologySnapshot(const TopologySnapshot &snapshot)
+{
+    setParameters(snapshot.params);
+
+    numActiveTrees = snapshot.numActiveTrees;
+    treePositions = snapshot.treePositions;
+    foldWindow = snapshot.foldWindow;
+    connections = snapshot.connections;
+    growthNumColonies = 0; // Find the grown connections again on the next growth tick
+
+    const auto numBands = std::min(bands.size(), snapshot.treeConnections.size());
+    for (size_t band = 0; band < numBands; ++band)
     {
-        if ((numColonies <= bands.size()) || (numNodes <= numActiveProcsPerBand) ||
-            (numNodes <= bands[0].processorBuffers.size()) ||
-            (numNodes <= bands[0].treeOutputBuffers.size()))
+        bands[band].treeConnections = snapshot.treeConnections[band];
+        bands[band].nodeDelayTimes = snapshot.nodeDelayTimes[band];
+
+        // Jump straight to the captured delay times and ages, without smoothing
+        for (size_t proc = 0; proc < bands[band].delayProcs.size(); ++proc)
         {
-            // No need to resize, just return
-            return;
+            auto &delayProc = *bands[band].delayProcs[proc];
+            delayProc.setParameters(makeDelayProcParams(band, bands[band].nodeDelayTimes[proc]), true);
+            delayProc.setAge(snapshot.nodeAges[band][proc]);
         }
     }
 
-    std::vector<BandResources> newBands(numColonies);
+    updateReachability();
+
+    // Everything has been applied already, there is nothing left for the timer to do
+    bandFrequenciesChanged = false;
+    treeDensityChanged = false;
+    stretchChanged = false;
+    scarcityAbundanceChanged = false;
+    foldPositionChanged = false;
+    foldWindowShapeChanged = false;
+    foldWindowSizeChanged = false;
+    growthRateChanged = false;
+    useExternalSidechainChanged = false;
+    compressorParamsChanged = false;
+    baseDelayChanged = false;
+}
+
+// Build every colony and node of the largest topology
+void DelayNodes::allocateMaxTopology()
+{
+    constexpr auto numColonies = static_cast<size_t>(ParameterRanges::maxNutrientBands);
+    constexpr auto numNodes = maxNumDelayProcsPerBand;
 
-    // Copy existing bands to newBands
-    for (int band = 0; band < bands.size(); ++band)
-    {
-        newBands[band] = std::move(bands[band]);
-    }
+    bands.resize(numColonies);
+    connections.resize(static_cast<int>(numColonies * numNodes));
 
-    // Allocate new delay processors for each band
-    for (int band = 0; band < numColonies; ++band)
+    for (size_t band = 0; band < numColonies; ++band)
     {
-        for (size_t proc = numActiveProcsPerBand; proc < numNodes; ++proc)
+        auto &resources = bands[band];
+        for (size_t proc = 0; proc < numNodes; ++proc)
         {
             auto newDelayProc = std::make_unique<DelayProc>();
-            newBands[band].delayProcs.push_back(std::move(newDelayProc));
-            newBands[band].treeConnections.push_back(0.0f); // Initialize tree connections to 0.0
-            auto newBuffer = std::make_unique<juce::AudioBuffer<float>>(numChannels, blockSize);
-            newBands[band].processorBuffers.push_back(std::move(newBuffer));
-            auto newTreeBuffer = std::make_unique<juce::AudioBuffer<float>>(numChannels, blockSize);
-            newBands[band].treeOutputBuffers.push_back(std::move(newTreeBuffer));
-            newBands[band].bufferLevels.push_back(0.0f); // Initialize buffer levels to 0.0
-            newBands[band].nodeDelayTimes.push_back(0.0f); // Initialize delay times to 0.0
-
-            // Initialize inter-node connection matrices if needed
-            auto curProcConnections = std::vector<std::vector<float>>(
-                numColonies,
-                std::vector<float>(numNodes, 0.0f));
-            for (int sourceBand = 0; sourceBand < numColonies; ++sourceBand)
+            newDelayProc->setQuality(currentQuality);
+            newDelayProc->setModulationLfo(&modLfos, band * numNodes + proc);
+            resources.delayProcs.push_back(std::move(newDelayProc));
+            resources.treeConnections.push_back(0.0f); // Initialize tree connections to 0.0
+            resources.bufferLevels.push_back(0.0f); // Initialize buffer levels to 0.0
+            resources.nodeDelayTimes.push_back(0.0f); // Initialize delay times to 0.0
+            resources.quietSamples.push_back(0);
+            resources.outputPeaks.push_back(0.0f);
+
+            // Chain every node to the one before it
+            if (proc > 0)
             {
-                for (int sourceProc = 0; sourceProc < numNodes; ++sourceProc)
-                {
-                    // Initialize inter-node connections to 0.0f
-                    curProcConnections[sourceBand][sourceProc] = 0.0f;
-                }
-                // Set connection from [band][proc-1] to 1.0f
-                if (sourceBand == band && proc > 0)
-                {
-                    curProcConnections[sourceBand][proc - 1] = 1.0f;
-                }
+                connections.set(getNodeIndex(static_cast<int>(band), proc), getNodeIndex(static_cast<int>(band), proc - 1), 1.0f);
             }
-
-            newBands[band].interNodeConnections.push_back(std::move(curProcConnections));
         }
     }
-    bands.swap(newBands);
     numActiveProcsPerBand = numNodes;
+
+    // The control-rate rebuilds reuse this storage, so they do not allocate when the
+    // timers run on the audio thread (offline)
+    constexpr auto maxNumCandidates = maxNumNodes * maxNumNodes;
+    treePositions.reserve(numNodes);
+    growthCandidates.reserve(maxNumCandidates);
+    candidateIndices.resize(maxNumCandidates);
+    growthWeights.reserve(maxNumCandidates);
+    growthTable.reserve(maxNumCandidates);
+    grownEdges.reserve(maxNumCandidates);
+    isGrownEdge.reserve(maxNumCandidates);
+    edgeDriftTicks.reserve(maxNumCandidates);
+
+    allocateBuffers();
 }
 
-// Process a specific band and processor stage with its own context
-void DelayNodes::processNode(int band, size_t procIdx)
+// Lay out the node and tree buffers of every colony in one arena each, band after band
+void DelayNodes::allocateBuffers()
 {
-    if (band < 0 || band >= inNumColonies || procIdx >= numActiveProcsPerBand)
+    const auto numBands = bands.size();
+
+    processorArena.prepare(static_cast<int>(numBands * maxNumDelayProcsPerBand), static_cast<int>(numChannels), static_cast<int>(blockSize));
+    treeArena.prepare(static_cast<int>(numBands * maxNumDelayProcsPerBand), static_cast<int>(numChannels), static_cast<int>(blockSize));
+
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        bands[band].processorBuffers = processorArena.getBuffers(band * maxNumDelayProcsPerBand, maxNumDelayProcsPerBand);
+        bands[band].treeOutputBuffers = treeArena.getBuffers(band * maxNumDelayProcsPerBand, maxNumDelayProcsPerBand);
+    }
+}
+
+// Process a control period of a specific band and processor stage with its own context
+void DelayNodes::processNode(int band, size_t procIdx, BufferSpan inputs, int startSample, int numSamples)
+{
+    if (band < 0 || band >= numProcessedColonies || procIdx >= numActiveProcsPerBand)
         return;
 
-    // Make sure our processor buffer is the right size and initialized with the input
+    // The processor buffers all have the length of the block (see process)
     auto &procBuffer = getProcessorBuffer(band, procIdx);
 
     // If this is the first processor, data has been already copied from the input buffer
-    // Otherwise, clear the buffer to avoid garbage data and set it to the size of the previous processor
+    // Otherwise, clear the buffer to avoid garbage data
     if (procIdx > 0)
     {
-        procBuffer.setSize(getProcessorBuffer(band, procIdx - 1).getNumChannels(), getProcessorBuffer(band, procIdx - 1).getNumSamples(), false, false, true);
-        procBuffer.clear();
-    }
-    else
-    {
-        procBuffer.setSize(getProcessorBuffer(band, procIdx - 1).getNumChannels(), getProcessorBuffer(band, procIdx).getNumSamples(), false, false, true);
+        procBuffer.clear(startSample, numSamples);
     }
 
     // Mix in signals from other bands based on inter-band connections
-    for (int sourceBand = 0; sourceBand < inNumColonies; ++sourceBand)
+    for (int sourceBand = 0; sourceBand < numProcessedColonies; ++sourceBand)
     {
         for (size_t sourceProc = 0; sourceProc < numActiveProcsPerBand; ++sourceProc)
         {
             // Check if there's a connection from the source band to this band at this position
-            // Note: interNodeConnections[sourceBand][procIdx] - first index is target band
-            float connectionStrength = bands[band].interNodeConnections[procIdx][sourceBand][sourceProc];
+            float connectionStrength = connections.get(getNodeIndex(band, procIdx), getNodeIndex(sourceBand, sourceProc));
+
+            // Nodes that have not run yet in this control period pass on the input of their band,
+            // which is silent for colonies fading out
+            const auto sourceRan = (sourceBand < band) || (sourceBand == band && sourceProc < procIdx);
+            if (!sourceRan && sourceBand >= numActiveColonies)
+            {
+                continue;
+            }
 
             if (connectionStrength > 0.0f)
             {
                 // DBG("Processing node " << band << ", " << procIdx << " with connection from " << sourceBand << ", " << sourceProc << " with strength " << connectionStrength);
                 // Get the buffer from the source band's processor at srcPos
-                auto &srcBuffer = getProcessorBuffer(sourceBand, sourceProc);
+                const auto &srcBuffer = sourceRan ? getProcessorBuffer(sourceBand, sourceProc) : inputs[static_cast<size_t>(sourceBand)];
 
                 // Add the signal from the source band to our input with the connection gain
-                for (int ch = 0; ch < procBuffer.getNumChannels(); ++ch)
-                {
-                    if (ch < srcBuffer.getNumChannels())
-                    {
-                        procBuffer.addFrom(
-                            ch, 0, srcBuffer,
-                            ch, 0, procBuffer.getNumSamples(),
-                            connectionStrength);
-                    }
-                }
+                addWithGain(procBuffer, srcBuffer, connectionStrength, startSample, numSamples);
             }
         }
     }
 
+    // Sleep once the input has been negligible for longer than the delay, and the delay has emptied
+    auto &quietSamples = bands[band].quietSamples[procIdx];
+    if (getPeak(procBuffer, startSample, numSamples) > nodeSleepThreshold)
+    {
+        quietSamples = 0;
+    }
+    else
+    {
+        quietSamples = juce::jmin(quietSamples + numSamples, std::numeric_limits<int>::max() - numSamples);
+    }
+
+    // A sleeping node outputs silence, but its clocks, smoothing and ageing carry on
+    if (isNodeAsleep(band, procIdx))
+    {
+        procBuffer.clear(startSample, numSamples);
+        getProcessorNode(band, procIdx).skip(numSamples);
+        return;
+    }
+
     // Create a dedicated audio block and context for this processor
-    juce::dsp::AudioBlock<float> block(procBuffer);
+    auto block = juce::dsp::AudioBlock<float>(procBuffer).getSubBlock(static_cast<size_t>(startSample), static_cast<size_t>(numSamples));
     juce::dsp::ProcessContextReplacing<float> context(block);
 
     // Process with this delay processor
     getProcessorNode(band, procIdx).process(context);
+
+    bands[band].outputPeaks[procIdx] = getPeak(procBuffer, startSample, numSamples);
+}
+
+void DelayNodes::addWithGain(juce::AudioBuffer<float> &destination, const juce::AudioBuffer<float> &source, float gain,
+                             int startSample, int numSamples) const
+{
+    const auto numChannels = juce::jmin(destination.getNumChannels(), source.getNumChannels());
+    numSamples = juce::jmin(numSamples, destination.getNumSamples() - startSample, source.getNumSamples() - startSample);
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        kernels->addWithGain(destination.getWritePointer(ch, startSample), source.getReadPointer(ch, startSample), gain, numSamples);
+    }
+}
+
+float DelayNodes::getPeak(const juce::AudioBuffer<float> &buffer, int startSample, int numSamples) const
+{
+    auto peak = 0.0f;
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        peak = juce::jmax(peak, kernels->getPeak(buffer.getReadPointer(ch, startSample), numSamples));
+    }
+    return peak;
+}
+
+bool DelayNodes::isNodeAsleep(int band, size_t procIdx) const
+{
+    const auto holdSamples = static_cast<int>(bands[band].nodeDelayTimes[procIdx] * fs / 1000.0f) + static_cast<int>(blockSize);
+    return bands[band].quietSamples[procIdx] > holdSamples && bands[band].outputPeaks[procIdx] <= nodeSleepThreshold;
+}
+
+void DelayNodes::setQuality(const ProcessingQuality &quality)
+{
+    currentQuality = quality;
+    maxProcessedTrees = quality.maxActiveTrees;
+
+    for (auto &band : bands)
+    {
+        for (auto &proc : band.delayProcs)
+        {
+            proc->setQuality(quality);
+        }
+    }
+}
+
+bool DelayNodes::isSilent() const
+{
+    for (int band = 0; band < inNumColonies && band < static_cast<int>(bands.size()); ++band)
+    {
+        for (size_t proc = 0; proc < bands[band].delayProcs.size(); ++proc)
+        {
+            if (isNodeReachable(band, proc) && !isNodeAsleep(band, proc))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void DelayNodes::topologyChanged()
+{
+    ++topologyVersion;
+    updateReachability();
+}
+
+void DelayNodes::updateReachability()
+{
+    const auto numBands = juce::jmin(static_cast<size_t>(inNumColonies), bands.size());
+    const auto numProcs = numActiveProcsPerBand;
+
+    // Fewest leading trees through which each node reaches the output, in the table the audio thread is not using
+    auto &requiredTrees = requiredTreeTables[static_cast<size_t>(writtenRequiredTrees)];
+    for (auto &bandTrees : requiredTrees)
+    {
+        bandTrees.fill(unreachableNode);
+    }
+
+    // Every node is marked once at most, so the walk never holds more than all of them
+    std::array<std::pair<size_t, size_t>, maxNumNodes> pending;
+    size_t numPending = 0;
+
+    for (int treeIdx = 0; treeIdx < numActiveTrees; ++treeIdx)
+    {
+        // Nodes already reached through an earlier tree keep their count
+        auto markNeeded = [&](size_t band, size_t proc)
+        {
+            if (requiredTrees[band][proc] == unreachableNode)
+            {
+                requiredTrees[band][proc] = treeIdx + 1;
+                pending[numPending++] = {band, proc};
+            }
+        };
+
+        // Tree taps with a non-zero gain feed the output directly
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            if (treeIdx < static_cast<int>(bands[band].treeConnections.size()) &&
+                treeIdx < static_cast<int>(foldWindow.size()) &&
+                treeIdx < static_cast<int>(treePositions.size()) &&
+                getTreeConnection(static_cast<int>(band), treeIdx) * foldWindow[treeIdx] > 0.0f)
+            {
+                markNeeded(band, static_cast<size_t>(treePositions[treeIdx]));
+            }
+        }
+
+        // Walk the routing graph backwards from the taps
+        while (numPending > 0)
+        {
+            const auto [band, proc] = pending[--numPending];
+
+            // Anything routed into a needed node is needed
+            for (size_t srcBand = 0; srcBand < numBands; ++srcBand)
+            {
+                for (size_t srcProc = 0; srcProc < numProcs; ++srcProc)
+                {
+                    if (connections.get(getNodeIndex(static_cast<int>(band), proc), getNodeIndex(static_cast<int>(srcBand), srcProc)) > 0.0f)
+                    {
+                        markNeeded(srcBand, srcProc);
+                    }
+                }
+            }
+
+            // So are the nodes whose levels drive its sidechain (see updateSidechainLevels)
+            if (proc == numProcs - 1)
+            {
+                for (size_t otherBand = 0; otherBand < numBands; ++otherBand)
+                {
+                    markNeeded(otherBand, numProcs - 1);
+                }
+            }
+            else
+            {
+                for (size_t srcBand = 0; srcBand < numBands; ++srcBand)
+                {
+                    for (size_t srcProc = 0; srcProc < numProcs; ++srcProc)
+                    {
+                        if (connections.get(getNodeIndex(static_cast<int>(band), proc + 1), getNodeIndex(static_cast<int>(srcBand), srcProc)) > 0.0f)
+                        {
+                            markNeeded(srcBand, srcProc);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Hand the table to the audio thread and keep the one it last gave back
+    writtenRequiredTrees = publishedRequiredTrees.exchange(writtenRequiredTrees | newRequiredTrees) & ~newRequiredTrees;
+}
+
+void DelayNodes::takeReachability()
+{
+    if ((publishedRequiredTrees.load() & newRequiredTrees) != 0)
+    {
+        usedRequiredTrees = publishedRequiredTrees.exchange(usedRequiredTrees) & ~newRequiredTrees;
+    }
 }
 
 // Update sidechain levels for all processors in the matrix
 void DelayNodes::updateSidechainLevels()
 {
     averageScarcityAbundance = 0.0f;
+    const auto normScarcityAbundance = ParameterRanges::scarcityAbundanceMapping.normalise(inScarcityAbundance);
+
     // First, gather all output levels from all delay processors into a matrix
-    for (int band = 0; band < inNumColonies; ++band)
+    for (int band = 0; band < numActiveColonies; ++band)
     {
         for (size_t proc = 0; proc < numActiveProcsPerBand; ++proc)
         {
             auto outputLevel = getProcessorNode(band, proc).getOutputLevel();
-            auto normScarcityAbundance = ParameterRanges::normalizeParameter(ParameterRanges::scarcityAbundanceRange, inScarcityAbundance);
             bands[band].bufferLevels[proc] = juce::jlimit(0.0f, 1.0f, outputLevel + (normScarcityAbundance));
+            nodeLevels[static_cast<size_t>(getNodeIndex(band, proc))] = bands[band].bufferLevels[proc];
             averageScarcityAbundance += outputLevel;
         }
     }
 
-    averageScarcityAbundance = -1.0f + (averageScarcityAbundance * inNumColonies) + inScarcityAbundance;
+    // The flow of every active node's sources into it, in one pass over the connections
+    connections.multiply(nodeLevels.data(), siblingFlows.data(), getNodeIndex(numActiveColonies, 0));
+
+    averageScarcityAbundance = -1.0f + (averageScarcityAbundance * numActiveColonies) + inScarcityAbundance;
 
     // For each band and processor
-    for (int band = 0; band < inNumColonies; ++band)
+    for (int band = 0; band < numActiveColonies; ++band)
     {
         const size_t numProcs = bands[band].delayProcs.size();
 
@@ -483,7 +845,7 @@ void DelayNodes::updateSidechainLevels()
                 // For end-of-row nodes: sum levels from all OTHER row ends
                 float combinedLevel = 0.0f;
 
-                for (int otherBand = 0; otherBand < inNumColonies; ++otherBand)
+                for (int otherBand = 0; otherBand < numActiveColonies; ++otherBand)
                 {
                     if (otherBand != band)  // Skip the current band
                     {
@@ -498,7 +860,7 @@ void DelayNodes::updateSidechainLevels()
             else
             {
                 // For non-end nodes: use the output level of the next node in same row
-                float nextNodeLevel = getSiblingFlow(band, proc + 1);
+                float nextNodeLevel = siblingFlows[static_cast<size_t>(getNodeIndex(band, proc + 1))];
                 // Substract own level from the next node level
                 nextNodeLevel -= bands[band].bufferLevels[proc];
                 getProcessorNode(band, proc).setExternalSidechainLevel(nextNodeLevel);
@@ -513,7 +875,7 @@ void DelayNodes::updateTreePositions()
     // Calculate number of active trees based on treeDensity (0-100)
     const juce::NormalisableRange<float> activeTreeRange{1.0f, static_cast<float>(numActiveProcsPerBand)};
 
-    auto normTreeDensity = ParameterRanges::normalizeParameter(ParameterRanges::treeDensityRange, inTreeDensity);
+    auto normTreeDensity = ParameterRanges::treeDensityMapping.normalise(inTreeDensity);
     numActiveTrees = static_cast<int>(ParameterRanges::denormalizeParameter(activeTreeRange, normTreeDensity));
     numActiveTrees = juce::jlimit(1, static_cast<int>(numActiveProcsPerBand), numActiveTrees);
 
@@ -596,10 +958,10 @@ void DelayNodes::updateFoldWindow()
     // Ensure the window sizes are set correctly
     foldWindow.resize(maxNumDelayProcsPerBand);
 
-    // Use Juce windowing functions to create the window shapes...
-    juce::AudioBuffer<float> rect(numChannels, maxNumDelayProcsPerBand);
-    juce::AudioBuffer<float> hann(numChannels, maxNumDelayProcsPerBand);
-    juce::AudioBuffer<float> fold(numChannels, maxNumDelayProcsPerBand);
+    // Use Juce windowing functions to create the window shapes (on the stack, as this
+    // also runs on the audio thread offline)...
+    std::array<float, maxNumDelayProcsPerBand> rect {};
+    std::array<float, maxNumDelayProcsPerBand> hann {};
 
     // Populate the window buffers with the appropriate windowing functions
     auto winSize = static_cast<size_t>(std::ceil(inFoldWindowSize * maxNumDelayProcsPerBand));
@@ -608,34 +970,24 @@ void DelayNodes::updateFoldWindow()
     auto winPosition = static_cast<size_t>(std::floor((maxNumDelayProcsPerBand - winSize) * inFoldPosition));
 
     juce::dsp::WindowingFunction<float>::fillWindowingTables(
-        rect.getWritePointer(0, winPosition),
+        rect.data() + winPosition,
         winSize,
         juce::dsp::WindowingFunction<float>::rectangular,
         true);
 
     juce::dsp::WindowingFunction<float>::fillWindowingTables(
-        hann.getWritePointer(0, winPosition),
+        hann.data() + winPosition,
         winSize,
         juce::dsp::WindowingFunction<float>::hann,
         true);
 
-    juce::dsp::AudioBlock<float> foldBlock(fold);
-    juce::dsp::AudioBlock<float> rectBlock(rect);
-    juce::dsp::AudioBlock<float> hannBlock(hann);
-
-    // Apply the fold window shape to the fold windows
-    rectBlock.multiplyBy(inFoldWindowShape);
-    hannBlock.multiplyBy(1.0f - inFoldWindowShape);
-
-    // Sum the rectangular and Hann windows to create the fold window
-    foldBlock.replaceWithSumOf(rectBlock, hannBlock);
-
-    // ... and copy the window shapes to the member variables
+    // ... and sum the rectangular and Hann windows, weighted by the fold window shape, into the fold window
     for (size_t i = 0; i < maxNumDelayProcsPerBand; ++i)
     {
+        const auto fold = rect[i] * inFoldWindowShape + hann[i] * (1.0f - inFoldWindowShape);
+
         // Gain to match the potential reduction in window size
-        foldWindow[i] = fold.getSample(0, i) *
-                        (maxNumDelayProcsPerBand / static_cast<float>(winSize));
+        foldWindow[i] = fold * (maxNumDelayProcsPerBand / static_cast<float>(winSize));
     }
 }
 
@@ -644,7 +996,7 @@ void DelayNodes::timerCallback()
     if (growthRateChanged)
     {
         stopTimer();
-        auto normGrowthRate = ParameterRanges::normalizeParameter(ParameterRanges::growthRateRange, inGrowthRate);
+        auto normGrowthRate = ParameterRanges::growthRateMapping.normalise(inGrowthRate);
         // Calculate the new timer rate based on the growth rate (up to 4 bars at current tempo)
         auto newTimerRate = 16.0f * inBaseDelayMs * std::max(1.0f - normGrowthRate, 0.1f);
         startTimer(newTimerRate);
@@ -653,6 +1005,7 @@ void DelayNodes::timerCallback()
     if (baseDelayChanged || bandFrequenciesChanged || stretchChanged || growthRateChanged || useExternalSidechainChanged || compressorParamsChanged)
     {
         updateDelayProcParams();
+        topologyChanged();
         useExternalSidechainChanged = false;
         compressorParamsChanged = false;
         bandFrequenciesChanged = false;
@@ -664,10 +1017,12 @@ void DelayNodes::timerCallback()
     if (treeDensityChanged)
     {
         updateTreePositions();
+        topologyChanged();
         treeDensityChanged = false;
     }
 
-    if ((bands[0].delayProcs[0]) &&
+    if (!growthPaused &&
+        (bands[0].delayProcs[0]) &&
         (bands[1].delayProcs[0]) &&
         (bands[2].delayProcs[0]) &&
         (bands[3].delayProcs[0]))
@@ -678,177 +1033,230 @@ void DelayNodes::timerCallback()
             (bands[3].delayProcs[0]->getInputLevel() > 0.001f))
         {
             updateNodeInterconnections();
+            topologyChanged();
         }
     }
 
     if (foldPositionChanged || foldWindowShapeChanged || foldWindowSizeChanged)
     {
         updateFoldWindow();
+        topologyChanged();
         foldPositionChanged = false;
         foldWindowShapeChanged = false;
         foldWindowSizeChanged = false;
     }
 }
 
-// Get the flow of sibling nodes into a specific band and processor
-float DelayNodes::getSiblingFlow(int targetBand, size_t targetProcIdx)
+// Update sum of outgoing connections from a particular processor
+void DelayNodes::normalizeOutgoingConnections(int band, size_t procIdx)
 {
-    if (targetBand < 0 || targetBand >= inNumColonies || targetProcIdx >= numActiveProcsPerBand)
-        return 0.0f;
+    if (band < 0 || band >= inNumColonies || procIdx >= numActiveProcsPerBand)
+        return;
 
-    float incomingFlow = 0.0f;
+    // Scale the outgoing connections to sum to less than one, from the sum kept by the matrix
+    connections.normaliseOutgoing(getNodeIndex(band, procIdx), 0.1f);
+}
 
-    // Sum incoming connections from all other processors to this processor
-    for (int sourceBand = 0; sourceBand < inNumColonies; ++sourceBand)
+// Update inter-node connections based on entanglement parameter
+void DelayNodes::updateNodeInterconnections()
+{
+    const int numColonies = inNumColonies;
+    if (numColonies <= 1)
     {
-        for (size_t sourceProc = 0; sourceProc < numActiveProcsPerBand; ++sourceProc)
+        return; // No inter-band connections possible with only one band
+    }
+
+    // Initialize random number generator for consistent variations
+    juce::Random random(juce::Time::currentTimeMillis());
+
+    // The same for every pair of nodes
+    const auto entanglementAmount = ParameterRanges::entanglementMapping.normalise(inEntanglement);
+    const auto normStretch = std::abs(ParameterRanges::stretchMapping.normalise(inStretch) - 0.5f);
+
+    // Only the colonies switched on take part in the normalisation
+    connections.setNumActiveNodes(getNodeIndex(numColonies, 0));
+
+    if (numColonies != growthNumColonies || entanglementAmount != growthEntanglement || normStretch != growthStretch)
+    {
+        updateGrowthCandidates(numColonies, entanglementAmount, normStretch);
+    }
+
+    ++growthTick;
+
+    // A few existing connections per tick are updated based on entanglement and age, for every tick since their last update
+    const auto numDrifted = juce::jmin(static_cast<size_t>(maxDriftedEdgesPerTick), grownEdges.size());
+    for (size_t n = 0; n < numDrifted && !grownEdges.empty(); ++n)
+    {
+        nextDriftedEdge = (nextDriftedEdge < grownEdges.size()) ? nextDriftedEdge : 0;
+        const auto candidate = grownEdges[nextDriftedEdge];
+        const auto [band1, band2, proc1, proc2, inverseDistance, reverse] = growthCandidates[static_cast<size_t>(candidate)];
+        const auto node1 = getNodeIndex(band1, proc1);
+        const auto node2 = getNodeIndex(band2, proc2);
+        const auto connectionStrength = connections.get(node1, node2);
+
+        // Connections that have dropped to 0.0f are candidates for growing again
+        if (connectionStrength <= 0.0f)
         {
-            if (bands[targetBand].interNodeConnections[targetProcIdx][sourceBand][sourceProc] > 0.0f)
-            {
-                // Add the connection strength to the incoming flow
-                incomingFlow += bands[targetBand].interNodeConnections[targetProcIdx][sourceBand][sourceProc] *
-                                bands[sourceBand].bufferLevels[sourceProc];
-            }
+            isGrownEdge[static_cast<size_t>(candidate)] = false;
+            grownEdges[nextDriftedEdge] = grownEdges.back();
+            grownEdges.pop_back();
+            continue;
+        }
+        ++nextDriftedEdge;
+
+        // The reverse connection drifts along with this one
+        const auto numTicks = growthTick - edgeDriftTicks[static_cast<size_t>(candidate)];
+        edgeDriftTicks[static_cast<size_t>(candidate)] = growthTick;
+        if (reverse >= 0)
+        {
+            edgeDriftTicks[static_cast<size_t>(reverse)] = growthTick;
+        }
+        if (numTicks <= 0)
+        {
+            continue;
         }
+
+        // The mean of numTicks uniform draws, with the same mean and variance
+        const auto meanRandom = 0.5f + (random.nextFloat() - 0.5f) / std::sqrt(static_cast<float>(numTicks));
+        auto pairMinAge = std::min(bands[band1].delayProcs[proc1]->getAge(), bands[band2].delayProcs[proc2]->getAge());
+        auto pairEntanglementDelta = meanRandom * entanglementAmount * 0.5f * (0.5f - pairMinAge);
+
+        // Update the connection strength in both directions, compounded over the ticks
+        const auto change = connectionStrength * (std::pow(1.0f + pairEntanglementDelta, static_cast<float>(numTicks)) - 1.0f);
+        connections.set(node1, node2, std::max(0.0f, connections.get(node1, node2) + change));
+        connections.set(node2, node1, std::max(0.0f, connections.get(node2, node1) + change));
+
+        // Ensure that the sum of connections from this node to all other nodes is 1.0f
+        normalizeOutgoingConnections(band1, proc1);
+        normalizeOutgoingConnections(band2, proc2);
     }
-    // DBG("Sibling flow for band " << targetBand << " proc " << targetProcIdx << ": " << incomingFlow);
-    return incomingFlow;
-}
 
-// Update sum of outgoing connections from a particular processor
-void DelayNodes::normalizeOutgoingConnections(int band, size_t procIdx)
-{
-    if (band < 0 || band >= inNumColonies || procIdx >= numActiveProcsPerBand)
+    if (growthTable.isEmpty())
+    {
         return;
+    }
 
-    // Sum outgoing connections from all other processors to this processor
-    float sum = 0.0f;
-    for (int targetBand = 0; targetBand < inNumColonies; ++targetBand)
+    // A sweep over every pair tries to create a connection at each missing one with the stretch (same band) or
+    // entanglement (inter-band) weight of the pair, scaled down by age. The weights sum to the number of tries
+    // the sweep makes on average: pick that many candidates (up to the bound) with the same relative probabilities,
+    // each kept with the probability that makes up the fraction. Above the bound each pick stands for several tries
+    const auto totalWeight = growthTable.getTotalWeight();
+    const auto numPicks = juce::jlimit(1, maxGrowthCandidatesPerTick, static_cast<int>(std::ceil(totalWeight)));
+    const auto pickProbability = juce::jmin(1.0f, totalWeight / static_cast<float>(numPicks));
+    const auto triesPerPick = juce::jmax(1.0f, totalWeight / static_cast<float>(numPicks));
+
+    for (int pick = 0; pick < numPicks; ++pick)
     {
-        for (size_t targetProc = 0; targetProc < numActiveProcsPerBand; ++targetProc)
+        if (random.nextFloat() >= pickProbability)
         {
-            if (bands[targetBand].interNodeConnections[targetProc][band][procIdx] > 0.0f)
-            {
-                // Sum the outgoing connections to all other processors
-                sum += bands[targetBand].interNodeConnections[targetProc][band][procIdx];
-            }
+            continue;
         }
-    }
 
+        const auto candidate = growthTable.sample(random);
+        const auto [band1, band2, proc1, proc2, inverseDistance, reverse] = growthCandidates[static_cast<size_t>(candidate)];
 
-    // DBG("Normalizing outgoing connections for band " << band << " proc " << procIdx << " with sum " << sum);
-    // If updated connections over 100%, normalize the connections to ensure they sum up to 0.9f
-    for (int targetBand = 0; targetBand < inNumColonies; ++targetBand)
-    {
-        for (size_t targetProc = 0; targetProc < numActiveProcsPerBand; ++targetProc)
+        // Existing connections drift above
+        const auto node1 = getNodeIndex(band1, proc1);
+        const auto node2 = getNodeIndex(band2, proc2);
+        if (connections.get(node1, node2) > 0.0f)
         {
+            continue;
+        }
 
-            bands[targetBand].interNodeConnections[targetProc][band][procIdx] /= (sum + 0.1f);
+        // Create a new connection with the age part of the probability, once in any of the tries
+        auto pairMinAge = std::min(bands[band1].delayProcs[proc1]->getAge(), bands[band2].delayProcs[proc2]->getAge());
+        if (random.nextFloat() < 1.0f - std::pow(juce::jlimit(0.0f, 1.0f, pairMinAge), triesPerPick))
+        {
+            const auto normEntanglement = (band1 == band2) ? 0.0f : entanglementAmount;
+
+            // Determine a connection strength (0.08-0.1), scaled by the distance between the nodes
+            auto connectionStrength = random.nextFloat() / (10.0f + (1.0f - normEntanglement) + pairMinAge);
+            connectionStrength *= inverseDistance;
+            connections.set(node1, node2, connectionStrength);
+            connections.set(node2, node1, connectionStrength);
+            addGrownEdge(candidate);
+            addGrownEdge(reverse);
+
+            // Ensure that the sum of connections from this node to all other nodes is 1.0f
+            normalizeOutgoingConnections(band1, proc1);
+            normalizeOutgoingConnections(band2, proc2);
         }
     }
 }
 
-// Update inter-node connections based on entanglement parameter
-void DelayNodes::updateNodeInterconnections()
+void DelayNodes::addGrownEdge(int candidate)
 {
-    if (inNumColonies <= 1)
+    if (!isGrownEdge[static_cast<size_t>(candidate)])
     {
-        return; // No inter-band connections possible with only one band
+        isGrownEdge[static_cast<size_t>(candidate)] = true;
+        edgeDriftTicks[static_cast<size_t>(candidate)] = growthTick;
+        grownEdges.push_back(candidate);
     }
+}
 
-    // Initialize random number generator for consistent variations
-    juce::Random random(juce::Time::currentTimeMillis());
-
-    for (int band1 = 0; band1 < inNumColonies; ++band1)
+// Rebuild the candidate connections (when the colonies change) and their weights
+void DelayNodes::updateGrowthCandidates(int numColonies, float entanglementAmount, float normStretch)
+{
+    if (numColonies != growthNumColonies)
     {
-        for (int band2 = 0; band2 < inNumColonies; ++band2)
+        // Candidate of every pair of nodes, to find the reverse of each
+        std::fill(candidateIndices.begin(), candidateIndices.end(), -1);
+
+        growthCandidates.clear();
+        for (int band1 = 0; band1 < numColonies; ++band1)
         {
-            for (size_t proc1 = 0; proc1 < numActiveProcsPerBand; ++proc1)
+            for (int band2 = 0; band2 < numColonies; ++band2)
             {
-                for (size_t proc2 = 0; proc2 < numActiveProcsPerBand; ++proc2)
+                for (size_t proc1 = 0; proc1 < numActiveProcsPerBand; ++proc1)
                 {
-                    // Skip self-connections
-                    if ((band1 == band2) && (proc1 == proc2))
+                    for (size_t proc2 = 0; proc2 < numActiveProcsPerBand; ++proc2)
                     {
-                        continue;
-                    }
-
-                    // Skip connections to the previous processor on the same band
-                    if ((band1 == band2) &&
-                        std::abs(static_cast<int>(proc1) - static_cast<int>(proc2)) == 1)
-                    {
-                        continue;
-                    }
-
-                    // Check if there's a connection between band1 and band2 at proc1 and proc2, respectively
-                    float connectionStrength = bands[band1].interNodeConnections[proc1][band2][proc2];
-                    auto pairMinAge = std::min(bands[band1].delayProcs[proc1]->getAge(), bands[band2].delayProcs[proc2]->getAge());
-
-                    // If the connection strength is greater than 0.0f, we need to update it based on entanglement and age
-                    if (connectionStrength > 0.0f)
-                    {
-                        auto normEntanglement = ParameterRanges::normalizeParameter(ParameterRanges::entanglementRange, inEntanglement);
-                        auto pairEntanglementDelta = random.nextFloat() * normEntanglement * 0.5f * (0.5f - pairMinAge);
-
-                        // DBG("Updating connection strength: " << connectionStrength << " for proc1: " << proc1 << " band1: " << band1 << " proc2: " << proc2 << " band2: " << band2);
-                        // Update the connection strength based on entanglement and age
-                        bands[band1].interNodeConnections[proc1][band2][proc2] += connectionStrength * pairEntanglementDelta;
-                        // Update the connection strength for the reverse direction
-                        bands[band2].interNodeConnections[proc2][band1][proc1] += connectionStrength * pairEntanglementDelta;
-                        // Ensure that the connection strength does not drop below 0.0f
-                        bands[band1].interNodeConnections[proc1][band2][proc2] = std::max(0.0f, bands[band1].interNodeConnections[proc1][band2][proc2]);
-                        bands[band2].interNodeConnections[proc2][band1][proc1] = std::max(0.0f, bands[band2].interNodeConnections[proc2][band1][proc1]);
-
-                        // Ensure that the sum of connections from this node to all other nodes is 1.0f
-                        normalizeOutgoingConnections(band1, proc1);
-                        normalizeOutgoingConnections(band2, proc2);
-                    }
-                    // If the connection strength is 0.0f, attempt to create a new connection based on entanglement
-                    else
-                    {
-                        float pairEntanglementProbability;
-                        float normEntanglement = 0.0f;
-
-                        // Test for creating a connection
-                        if (band1 == band2)
-                        {
-                            // Same-band connections are dependent on the stretch parameter
-                            auto stretchFactor = ParameterRanges::normalizeParameter(ParameterRanges::stretchRange, inStretch);
-                            auto normStretch = std::abs(stretchFactor - 0.5f);
-                            pairEntanglementProbability = (1.0f - normStretch) * (1.0f - pairMinAge);
-                        }
-                        else
+                        // Skip self-connections, and connections to the previous or next processor on the same band
+                        const auto procDistance = static_cast<int>(proc1) - static_cast<int>(proc2);
+                        if ((band1 == band2) && (std::abs(procDistance) <= 1))
                         {
-                            // Inter-band connections are dependent on the entanglement parameter
-                            normEntanglement = ParameterRanges::normalizeParameter(ParameterRanges::entanglementRange, inEntanglement);
-                            pairEntanglementProbability = normEntanglement * (1.0f - pairMinAge);
+                            continue;
                         }
 
-                        // Create a new connection with the given probability
-                        if (random.nextFloat() < pairEntanglementProbability)
-                        {
-                            // Determine a connection strength (0.08-0.1)
-                            connectionStrength = random.nextFloat() / (10.0f + (1.0f - normEntanglement) + pairMinAge);
-                            // Scale connection strength by distance between nodes (with inter-band distance weighted higher)
-                            auto distance = std::sqrt
-                                            (
-                                                std::pow(static_cast<int>(proc1) - static_cast<int>(proc2), 2) +
-                                                15.0f * std::pow(static_cast<int>(band1) - static_cast<int>(band2), 2)
-                                            );
-                            connectionStrength *= 1/distance;
-                            // DBG("Creating new connection between band " << band1 << " proc " << proc1 << " and band " << band2 << " proc " << proc2 << " with strength " << connectionStrength);
-                            bands[band1].interNodeConnections[proc1][band2][proc2] = connectionStrength;
-                            bands[band2].interNodeConnections[proc2][band1][proc1] = connectionStrength;
-
-                            // Ensure that the sum of connections from this node to all other nodes is 1.0f
-                            normalizeOutgoingConnections(band1, proc1);
-                            normalizeOutgoingConnections(band2, proc2);
-                        }
+                        const auto distance = std::sqrt(static_cast<float>(juce::square(procDistance)) +
+                                                        15.0f * static_cast<float>(juce::square(band1 - band2)));
+                        const auto pair = static_cast<size_t>(getNodeIndex(band1, proc1)) * maxNumNodes + static_cast<size_t>(getNodeIndex(band2, proc2));
+                        candidateIndices[pair] = static_cast<int>(growthCandidates.size());
+                        growthCandidates.push_back({band1, band2, proc1, proc2, 1.0f / distance, -1});
                     }
                 }
             }
         }
+
+        // Pick up the connections that already exist
+        grownEdges.clear();
+        isGrownEdge.assign(growthCandidates.size(), false);
+        edgeDriftTicks.assign(growthCandidates.size(), growthTick);
+        nextDriftedEdge = 0;
+        for (size_t i = 0; i < growthCandidates.size(); ++i)
+        {
+            auto &candidate = growthCandidates[i];
+            const auto node1 = getNodeIndex(candidate.band1, candidate.proc1);
+            const auto node2 = getNodeIndex(candidate.band2, candidate.proc2);
+            candidate.reverse = candidateIndices[static_cast<size_t>(node2) * maxNumNodes + static_cast<size_t>(node1)];
+            if (connections.get(node1, node2) > 0.0f)
+            {
+                addGrownEdge(static_cast<int>(i));
+            }
+        }
     }
+
+    // Same-band connections grow with the stretch, inter-band ones with the entanglement
+    growthWeights.resize(growthCandidates.size());
+    for (size_t i = 0; i < growthCandidates.size(); ++i)
+    {
+        growthWeights[i] = (growthCandidates[i].band1 == growthCandidates[i].band2) ? (1.0f - normStretch) : entanglementAmount;
+    }
+    growthTable.build(growthWeights);
+
+    growthNumColonies = numColonies;
+    growthEntanglement = entanglementAmount;
+    growthStretch = normStretch;
 }
 
 ///////////////////////////
@@ -858,17 +1266,17 @@ void DelayNodes::updateNodeInterconnections()
 juce::AudioBuffer<float> &DelayNodes::getProcessorBuffer(int band, size_t procIdx)
 {
     // Make sure the indices are valid
-    band = juce::jlimit(0, inNumColonies - 1, band);
+    band = juce::jlimit(0, static_cast<int>(bands.size()) - 1, band);
     procIdx = juce::jlimit(static_cast<size_t>(0), bands[band].delayProcs.size() - 1, procIdx);
 
-    return *bands[band].processorBuffers[procIdx];
+    return bands[band].processorBuffers[procIdx];
 }
 
 // Get the processor node at a specific position in the matrix
 DelayProc &DelayNodes::getProcessorNode(int band, size_t procIdx)
 {
     // Make sure the indices are valid
-    band = juce::jlimit(0, inNumColonies - 1, band);
+    band = juce::jlimit(0, static_cast<int>(bands.size()) - 1, band);
     procIdx = juce::jlimit(static_cast<size_t>(0), bands[band].delayProcs.size() - 1, procIdx);
 
     return *bands[band].delayProcs[procIdx];
@@ -878,7 +1286,7 @@ DelayProc &DelayNodes::getProcessorNode(int band, size_t procIdx)
 float &DelayNodes::getTreeConnection(int band, size_t procIdx)
 {
     // Make sure the indices are valid
-    band = juce::jlimit(0, inNumColonies - 1, band);
+    band = juce::jlimit(0, static_cast<int>(bands.size()) - 1, band);
     procIdx = juce::jlimit(static_cast<size_t>(0), bands[band].treeConnections.size() - 1, procIdx);
 
     return bands[band].treeConnections[procIdx];
@@ -888,8 +1296,8 @@ float &DelayNodes::getTreeConnection(int band, size_t procIdx)
 juce::AudioBuffer<float> &DelayNodes::getTreeBuffer(int band, size_t treeIdx)
 {
     // Make sure the indices are valid
-    band = juce::jlimit(0, inNumColonies - 1, band);
+    band = juce::jlimit(0, static_cast<int>(bands.size()) - 1, band);
     treeIdx = juce::jlimit(static_cast<size_t>(0), bands[band].treeOutputBuffers.size() - 1, treeIdx);
 
-    return *bands[band].treeOutputBuffers[treeIdx];
+    return bands[band].treeOutputBuffers[treeIdx];
 }
\ No newline at end of file
@@ -1,10 +1,19 @@
 #pragma once
 
+#include "ControlScheduler.h"
+#include "BufferArena.h"
+#include "ConnectionMatrix.h"
 #include "DelayProc.h"
 #include "DuckingCompressor.h"
+#include "LfoBank.h"
+#include "SimdKernels.h"
+#include "ProcessingQuality.h"
+#include "util/AliasTable.h"
 #include "util/ParameterRanges.h"
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
 #include <vector>
 
 /**
@@ -12,14 +21,14 @@
  * Each input gets its own DelayProc with different delay parameters
  */
 class DelayNodes :
-    private juce::Timer
+    private ControlTimer
 {
     public:
         // Parameters
         struct Parameters
         {
             int   numColonies;                        // Controls the number of colonies (delay processor lineages)
-            std::vector<float> bandFrequencies;       // Controls the frequency processed by each colony
+            std::array<float, ParameterRanges::maxNutrientBands> bandFrequencies {}; // Controls the frequency processed by each colony
             float stretch;                            // Controls the stretch of the delay network
             float scarcityAbundance;                  // Controls the Scarcity/Abundance of the delay network
             float foldPosition;                       // Controls the fold position (-1-1)
@@ -38,8 +47,8 @@ class DelayNodes :
         struct BandResources
         {
             std::vector<std::unique_ptr<DelayProc>> delayProcs;
-            std::vector<std::unique_ptr<juce::AudioBuffer<float>>> processorBuffers;
-            std::vector<std::unique_ptr<juce::AudioBuffer<float>>> treeOutputBuffers;
+            BufferSpan processorBuffers;                  // Views into the node buffer arena
+            BufferSpan treeOutputBuffers;                 // Views into the tree buffer arena
             std::vector<float> treeConnections;
             // Vector to store output levels of each processor
             std::vector<float> bufferLevels;
@@ -50,35 +59,22 @@ class DelayNodes :
             // Band center frequency
             float inBandFrequency = 0.0f;
 
-            // Vector of matrices to store connection strengths between nodes
-            std::vector<std::vector<std::vector<float>>> interNodeConnections;
+            // Samples since each node last had input above the sleep threshold, and its last output peak
+            std::vector<int> quietSamples;
+            std::vector<float> outputPeaks;
 
             void clear()
             {
                 // Clear in reverse order of dependency
+                outputPeaks.clear();
+                quietSamples.clear();
                 bufferLevels.clear();
                 nodeDelayTimes.clear();
 
-                // Clear inter-node connections
-                for (auto &node : interNodeConnections)
-                {
-                    for (auto &bands : node)
-                    {
-                        bands.clear();
-                    }
-                    node.clear();
-                }
-                interNodeConnections.clear();
-
                 treeConnections.clear();
 
-                for (auto &buffer : treeOutputBuffers)
-                    buffer.reset();
-                treeOutputBuffers.clear();
-
-                for (auto &buffer : processorBuffers)
-                    buffer.reset();
-                processorBuffers.clear();
+                treeOutputBuffers = {};
+                processorBuffers = {};
 
                 for (auto &proc : delayProcs)
                     proc.reset();
@@ -86,14 +82,29 @@ class DelayNodes :
             }
         };
 
-        DelayNodes(size_t numBands = 4);
+        // Everything needed to rebuild the current routing in another DelayNodes instance
+        struct TopologySnapshot
+        {
+            Parameters params;
+            int numActiveTrees = 1;
+            std::vector<int> treePositions;
+            std::vector<float> foldWindow;
+            std::vector<std::vector<float>> treeConnections;  // [band][tree]
+            std::vector<std::vector<float>> nodeDelayTimes;   // [band][proc]
+            std::vector<std::vector<float>> nodeAges;         // [band][proc]
+            ConnectionMatrix connections;                     // [target node][source node]
+        };
+
+        // Without a scheduler the growth timer does not run (used for rendering impulse responses offline)
+        DelayNodes(size_t numBands = 4, ControlScheduler *scheduler = nullptr);
         ~DelayNodes();
 
         void prepare(const juce::dsp::ProcessSpec& spec);
         void reset();
 
-        // Process each diffusion output with its own delay node
-        void process(std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &diffusionBandBuffers);
+        // Process each diffusion output with its own delay node, writing the colony outputs to outputs
+        // (outputs may be the same buffers as inputs)
+        void process(BufferSpan inputs, BufferSpan outputs);
 
         void setParameters(const Parameters& params);
         float getAverageScarcityAbundance() const { return averageScarcityAbundance; }
@@ -101,20 +112,56 @@ class DelayNodes :
         // Get the contents of the fold window
         std::vector<BandResources>& getBandState() { return bands; }
 
+        // Connection strengths between nodes, indexed by getNodeIndex()
+        const ConnectionMatrix& getConnections() const { return connections; }
+        static int getNodeIndex(int band, size_t procIdx) { return band * static_cast<int>(maxNumDelayProcsPerBand) + static_cast<int>(procIdx); }
+
         // Get the position of the trees in the network
         std::vector<int>& getTreePositions() { return treePositions; }
 
+        // Capture the current routing, delay times and ages into a snapshot (call from the timer thread).
+        // Reuses the snapshot's storage, which never allocates once it has been reserved
+        void getTopologySnapshot(TopologySnapshot &snapshot) const;
+        // Size a snapshot's storage for the largest topology (allocates)
+        void reserveTopologySnapshot(TopologySnapshot &snapshot) const;
+        // Rebuild a captured routing, with all processor parameters applied immediately
+        void applyTopologySnapshot(const TopologySnapshot &snapshot);
+
+        // Incremented whenever the routing, trees, fold window or node parameters change
+        uint32_t getTopologyVersion() const { return topologyVersion.load(); }
+
+        // Stop (or resume) the growth of inter-node connections
+        void setGrowthPaused(bool shouldPause) { growthPaused = shouldPause; }
+
+        // True when every node that can reach the output is asleep
+        bool isSilent() const;
+
+        // Apply a processing quality to every node (audio thread)
+        void setQuality(const ProcessingQuality &quality);
+
     private:
         std::vector<BandResources> bands;
 
-        // Allocate delay processors and buffers based on the number of colonies and nodes
-        void allocateDelayProcessors(int numColonies, int numNodes = maxNumDelayProcsPerBand);
+        // Node and tree buffers of every colony, handed to the bands as views
+        BufferArena processorArena;
+        BufferArena treeArena;
+
+        // Build every colony and node of the largest topology, once. Changes to the number of
+        // colonies only switch them on or off and never allocate or move the DSP objects
+        void allocateMaxTopology();
+
+        // Lay out the node and tree buffers of every colony for the prepared block size
+        void allocateBuffers();
 
         // Tree-related parameters
         float inTreeDensity = 0.0f;                      // Tree density parameter (0-100)
         int numActiveTrees = 1;                          // Number of active trees (1-8)
         std::vector<int> treePositions;                  // Positions of trees in the network
 
+        // Processing quality, also given to nodes allocated later
+        ProcessingQuality currentQuality;
+        std::atomic<int> maxProcessedTrees {static_cast<int>(maxNumDelayProcsPerBand)}; // Quality limit on the trees that are processed
+
         // Parameters to control delay network behavior
         float fs = 44100.0f;
         size_t numChannels = 2;
@@ -123,8 +170,23 @@ class DelayNodes :
         // Average scarcity/abundance value
         float averageScarcityAbundance = 0.0f;
 
+        // Sidechain levels are refreshed and the LFOs stepped on control ticks, at the sample where each falls
+        ControlClock controlClock;
+
+        // Tilt modulation LFOs of every node, stepped together on control ticks
+        LfoBank modLfos;
+        void randomiseModulationPhases();
+
+        // Colonies that are switched on (set from the timer thread)
+        std::atomic<int> inNumColonies {ParameterRanges::maxNutrientBands};
+
+        // Colonies switched on or off fade in or out rather than starting or stopping abruptly
+        static constexpr double colonyFadeTimeSec = 0.05;
+        std::array<juce::SmoothedValue<float>, ParameterRanges::maxNutrientBands> colonyGains;
+        int numActiveColonies = ParameterRanges::maxNutrientBands;    // Audio thread: colonies switched on in this block
+        int numProcessedColonies = ParameterRanges::maxNutrientBands; // Audio thread: switched on, or still fading out
+
         // Parameters for delay network
-        int inNumColonies = ParameterRanges::maxNutrientBands;
         float inStretch = 0.0f;
         float inScarcityAbundance = 0.0f;
         float inFoldPosition = 0.0f;
@@ -155,35 +217,121 @@ class DelayNodes :
         static constexpr size_t maxNumDelayProcsPerBand = 8;
         size_t numActiveProcsPerBand = 0;
 
+        // Connections between every node of every colony, with the chain of each colony
+        static constexpr size_t maxNumNodes = ParameterRanges::maxNutrientBands * maxNumDelayProcsPerBand;
+        ConnectionMatrix connections;
+
+        // Audio thread: node output levels and the flow of their sources into every node (see updateSidechainLevels)
+        alignas(16) std::array<float, maxNumNodes> nodeLevels {};
+        alignas(16) std::array<float, maxNumNodes> siblingFlows {};
+
         // Window for folding
         std::vector<float> foldWindow;
 
+        // Topology change tracking
+        std::atomic<uint32_t> topologyVersion {0};
+        std::atomic<bool> growthPaused {false};
+
+        // Nodes sleep once their input and output stay below this level (-80 dB) for longer than their delay
+        static constexpr float nodeSleepThreshold = 1.0e-4f;
+
+        static constexpr int unreachableNode = std::numeric_limits<int>::max();
+
+        // Fewest leading trees through which each node affects the output (through the routing graph or a sidechain).
+        // The timer thread fills a spare table and publishes it, the audio thread takes the latest one at the start
+        // of a block: with three tables neither thread ever writes the table the other one reads
+        using RequiredTrees = std::array<std::array<int, maxNumDelayProcsPerBand>, ParameterRanges::maxNutrientBands>;
+        std::array<RequiredTrees, 3> requiredTreeTables {};
+        static constexpr int newRequiredTrees = 4;      // Set in the published index until the audio thread takes it
+        int writtenRequiredTrees = 0;                   // Timer thread
+        int usedRequiredTrees = 1;                      // Audio thread
+        std::atomic<int> publishedRequiredTrees {2};
+
+        // Audio thread: switch to the latest published reachability
+        void takeReachability();
+
+        // Trees beyond the quality limit are not processed, nor are the nodes that only feed them
+        int getNumProcessedTrees() const { return juce::jmin(numActiveTrees, maxProcessedTrees.load()); }
+        bool isNodeReachable(int band, size_t procIdx) const { return requiredTreeTables[static_cast<size_t>(usedRequiredTrees)][static_cast<size_t>(band)][procIdx] <= getNumProcessedTrees(); }
+
+        // A node sleeps once its input and delay contents have decayed
+        bool isNodeAsleep(int band, size_t procIdx) const;
+
+        // Bump the topology version and recompute which nodes can reach the output
+        void topologyChanged();
+
+        // Mark the nodes that feed an active tree, or the sidechain of a node that does
+        void updateReachability();
+
+        // Build the delay processor parameters for a node with the given delay time
+        DelayProc::Parameters makeDelayProcParams(size_t band, float delayMs) const;
+
         // Timer callback function
         void timerCallback() override;
 
         // Update sum of outgoing connections
         void normalizeOutgoingConnections(int band, size_t procIdx);
 
-        // Get incoming flow to a specific band and processor
-        float getSiblingFlow(int targetBand, size_t targetProcIdx);
-
         // Update delay processor parameters
         void updateDelayProcParams();
 
         // Update sidechain levels for all processors in the matrix
         void updateSidechainLevels();
 
+        // Follow the number of colonies switched on, starting the fades of those switched on or off
+        void updateColonyGains(int numBandBuffers);
+
         // Update tree positions and connections based on treeDensity
         void updateTreePositions();
 
         // Update inter-band connections based on entanglement parameter
         void updateNodeInterconnections();
 
+        // New connections grow from candidates picked per tick instead of a sweep over every pair,
+        // as many as the sweep would try on average up to this bound, each pick then standing for several tries
+        static constexpr int maxGrowthCandidatesPerTick = 32;
+        struct GrowthCandidate
+        {
+            int band1, band2;
+            size_t proc1, proc2;
+            float inverseDistance;   // Connection strengths fall off with the distance (inter-band distance weighted higher)
+            int reverse;             // The candidate in the other direction
+        };
+        std::vector<GrowthCandidate> growthCandidates;
+        std::vector<int> candidateIndices;   // [node1 * maxNumNodes + node2], to find the reverse of each candidate
+        std::vector<float> growthWeights;
+        AliasTable growthTable;      // Picks the candidates with the relative probabilities of the sweep
+        int growthNumColonies = 0;   // What the candidates and their weights were built for
+        float growthEntanglement = -1.0f;
+        float growthStretch = -1.0f;
+
+        // Candidates that hold a connection. A few of them per tick catch up on the drift of the ticks
+        // since they were last visited, so the cost per tick does not grow with the number of connections
+        static constexpr int maxDriftedEdgesPerTick = 16;
+        std::vector<int> grownEdges;
+        std::vector<bool> isGrownEdge;
+        std::vector<int> edgeDriftTicks;   // Growth tick each candidate last drifted at
+        int growthTick = 0;
+        size_t nextDriftedEdge = 0;
+        void addGrownEdge(int candidate);
+
+        // Rebuild the candidate connections and their weights
+        void updateGrowthCandidates(int numColonies, float entanglementAmount, float normStretch);
+
         // Update fold window for all processors
         void updateFoldWindow();
 
-        // Process a specific band and processor stage
-        void processNode(int band, size_t procIdx);
+        // Run every node and tree tap over one control period of the block
+        void processSegment(BufferSpan inputs, int startSample, int numSamples, int numProcessedTrees);
+
+        // Process a control period of a specific band and processor stage
+        void processNode(int band, size_t procIdx, BufferSpan inputs, int startSample, int numSamples);
+
+        // Routing mix and sleep detection, through the selected SIMD kernels
+        const SimdKernels::Table *kernels = &SimdKernels::get();
+        void addWithGain(juce::AudioBuffer<float> &destination, const juce::AudioBuffer<float> &source, float gain,
+                         int startSample, int numSamples) const;
+        float getPeak(const juce::AudioBuffer<float> &buffer, int startSample, int numSamples) const;
 
         // Get processor buffer at a specific position in the matrix
         juce::AudioBuffer<float> &getProcessorBuffer(int band, size_t procIdx);
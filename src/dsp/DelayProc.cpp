@@ -1,19 +1,18 @@
 #include "DelayProc.h"
 #include "util/ParameterRanges.h"
 #include "util/Utils.h"
+#include "util/FastMath.h"
 
 DelayProc::DelayProc()
 {
     delay = *delayStore->getNextDelay();
-
-    // Configure the modulation oscillator to be a sine wave
-    modProcs.get<oscillatorIdx>().initialise([](float x) { return std::sin(x); });
 }
 
 void DelayProc::prepare (const juce::dsp::ProcessSpec& spec)
 {
     delay.prepare (spec);
     fs = (float) spec.sampleRate;
+    numChannels = static_cast<int>(spec.numChannels);
     delay.setMaximumDelayInSamples(ParameterRanges::delayRange.end * fs / 1000.0f);
 
     inFeedback.reset(fs, smoothTimeSec);
@@ -37,18 +36,16 @@ void DelayProc::prepare (const juce::dsp::ProcessSpec& spec)
 
     reset();
 
+    // Give the filters their second-order coefficients before they are prepared, so the
+    // coefficient and state storage exist before the audio thread updates them in place
+    setShelfCoefficients(inFilterFreq.getTargetValue(), inFilterGainDb.getTargetValue());
     procs.prepare (spec);
-    modProcs.prepare (spec); // Prepare the modulation processor chain
-
-    // Initialize oscillator and gain
-    modProcs.get<oscillatorIdx>().setFrequency(0.2f); // Default frequency, will be updated later
-    modProcs.get<gainIdx>().setGainLinear(1.0f);      // Start at full gain
-    // Advance the modulation oscillator by a random amount of steps
-    auto steps = juce::Random::getSystemRandom().nextInt(1000);
-    float x = 0.0f;
-    for (int i = 0; i < steps; ++i)
+
+    // Default modulation until the parameters arrive (the bank owner randomises the phase)
+    modGain = 1.0f;
+    if (modLfoBank != nullptr)
     {
-        modProcs.get<oscillatorIdx>().processSample(x);
+        modLfoBank->setFrequency(modLfoIndex, 0.2f * modRateScale);
     }
 }
 
@@ -59,18 +56,31 @@ void DelayProc::reset()
     outputLevel = 0.0f;
     flushDelay();
     procs.reset();
-    modProcs.reset();
+    controlClock.reset();
     inEnvelopeFollower.reset();
     outEnvelopeFollower.reset();
     compressor.reset();
 }
 
+void DelayProc::setQuality(const ProcessingQuality &quality)
+{
+    delay.setInterpolation(quality.delayInterpolation);
+    procs.get<dispersionIdx>().setMaxStages(quality.maxDispersionStages);
+    inEnvelopeFollower.setAnalysisStride(quality.envelopeStride);
+    outEnvelopeFollower.setAnalysisStride(quality.envelopeStride);
+}
+
+void DelayProc::setModulationLfo(LfoBank *bank, size_t index)
+{
+    modLfoBank = bank;
+    modLfoIndex = index;
+}
+
 void DelayProc::flushDelay()
 {
     delay.reset();
     std::fill(state.begin(), state.end(), 0.0f);
     procs.reset();
-    modProcs.reset();
 }
 
 template <typename ProcessContext>
@@ -85,24 +95,100 @@ void DelayProc::process (const ProcessContext& context)
     jassert(inputBlock.getNumChannels() == numChannels);
     jassert(inputBlock.getNumSamples() == numSamples);
 
-    // Process the input with the envelope follower
-    inEnvelopeFollower.process(context);
-    outEnvelopeFollower.process(context);
-    inputLevel = inEnvelopeFollower.getAverageLevel();
-    outputLevel = outEnvelopeFollower.getAverageLevel();
-
     // Copy input to output if non-replacing
     if (context.usesSeparateInputAndOutputBlocks())
     {
         outputBlock.copyFrom(inputBlock);
     }
 
-    // Skip processing if bypassed
+    // Skip processing if bypassed (the envelopes still follow the input)
     if (context.isBypassed)
     {
+        inEnvelopeFollower.analyse(inputBlock);
+        outEnvelopeFollower.analyse(inputBlock);
+        inputLevel = inEnvelopeFollower.getAverageLevel();
+        outputLevel = outEnvelopeFollower.getAverageLevel();
+        controlClock.advance(static_cast<int>(numSamples));
         return;
     }
 
+    // Split the block at the control ticks, so the control-rate work runs on a fixed
+    // sample clock whatever the host block size
+    for (size_t start = 0; start < numSamples;)
+    {
+        const auto segmentLength = juce::jmin(numSamples - start, static_cast<size_t>(controlClock.getSamplesToNextTick()));
+
+        // The envelopes see every sample, their levels are read once per control period
+        const auto inputSegment = inputBlock.getSubBlock(start, segmentLength);
+        inEnvelopeFollower.analyse(inputSegment);
+        outEnvelopeFollower.analyse(inputSegment);
+
+        if (controlClock.isTick())
+        {
+            updateControl();
+        }
+
+        for (size_t i = start; i < start + segmentLength; ++i)
+        {
+            // Update delay time
+            if (inDelayTime.isSmoothing())
+            {
+                delay.setDelay(juce::jmax(0.0f, inDelayTime.getNextValue() /* + delayModValue */));
+            }
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto *inputSamples = inputBlock.getChannelPointer(channel);
+                auto *outputSamples = outputBlock.getChannelPointer(channel);
+                outputSamples[i] = processSample(inputSamples[i], channel);
+            }
+        }
+
+        controlClock.advance(static_cast<int>(segmentLength));
+        start += segmentLength;
+    }
+
+    procs.get<lpfIdx>().snapToZero();
+    procs.get<hpfIdx>().snapToZero();
+}
+
+void DelayProc::skip(int numSamples)
+{
+    // The same control segments as process, with only what a silent input leaves of the per-sample work
+    for (int start = 0; start < numSamples;)
+    {
+        const auto segmentLength = juce::jmin(numSamples - start, controlClock.getSamplesToNextTick());
+
+        inEnvelopeFollower.analyseSilence(segmentLength);
+        outEnvelopeFollower.analyseSilence(segmentLength);
+
+        if (controlClock.isTick())
+        {
+            updateControl();
+        }
+
+        if (inDelayTime.isSmoothing())
+        {
+            delay.setDelay(juce::jmax(0.0f, inDelayTime.skip(segmentLength)));
+        }
+        inFeedback.skip(segmentLength);
+
+        // The ducking follows its sidechain level, which is constant between control ticks
+        const auto sidechainLevel = inUseExternalSidechain ? externalSidechainLevel : inputLevel;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            compressor.getGainRamp(sidechainLevel, static_cast<size_t>(channel), segmentLength);
+        }
+
+        controlClock.advance(segmentLength);
+        start += segmentLength;
+    }
+}
+
+void DelayProc::updateControl()
+{
+    inputLevel = inEnvelopeFollower.getAverageLevel();
+    outputLevel = outEnvelopeFollower.getAverageLevel();
+
     // Update current aging rate and modulation parameters
     if (inGrowthRate.isSmoothing() || (inputLevel > inputLevelMetabolicThreshold))
     {
@@ -119,27 +205,9 @@ void DelayProc::process (const ProcessContext& context)
     // Update filter coefficients and modulation parameters
     if (currentAge.isSmoothing())
     {
-        updateProcChainParameters(numSamples);
+        updateProcChainParameters(static_cast<size_t>(controlClock.getInterval()));
         updateModulationParameters();
     }
-
-    for (size_t i = 0; i < numSamples; ++i)
-    {
-        // Update delay time
-        if (inDelayTime.isSmoothing())
-        {
-            delay.setDelay(juce::jmax(0.0f, inDelayTime.getNextValue() /* + delayModValue */));
-        }
-        for (size_t channel = 0; channel < numChannels; ++channel)
-        {
-            auto *inputSamples = inputBlock.getChannelPointer(channel);
-            auto *outputSamples = outputBlock.getChannelPointer(channel);
-            outputSamples[i] = processSample(inputSamples[i], channel);
-        }
-    }
-
-    procs.get<lpfIdx>().snapToZero();
-    procs.get<hpfIdx>().snapToZero();
 }
 
 template <typename SampleType>
@@ -165,7 +233,7 @@ void DelayProc::setParameters (const Parameters& params, bool force)
 {
     auto delaySamples = (ParameterRanges::delayRange.snapToLegalValue(params.delayMs) / 1000.0f) * fs;
     auto fbVal        = params.feedback >= ParameterRanges::fbRange.end ? 1.0f
-                                                                    : std::pow(juce::jmin(params.feedback, 0.95f), 0.9f);
+                                                                    : FastMath::pow(juce::jmin(params.feedback, 0.95f), 0.9f);
     auto filterFreq   = (ParameterRanges::filterFreqRange.snapToLegalValue(params.filterFreq));
     auto filterGainDb = (ParameterRanges::filterGainRangeDb.snapToLegalValue(params.filterGainDb));
 
@@ -295,17 +363,21 @@ void DelayProc::updateFilterCoefficients(bool force)
         filterGain = inFilterGainDb.getTargetValue();
     }
 
-    // Apply modulation processing chain to the output
-    float x = 0.0f;
-    x = modProcs.processSample(x);
     // Modulate the filter tilt
+    const auto x = (modLfoBank != nullptr) ? modGain * modLfoBank->getValue(modLfoIndex) : 0.0f;
     filterGain += x * 3.0f;
     filterGain = juce::jlimit(-6.0f, 6.0f, filterGain);
 
-    procs.get<lpfIdx>().coefficients = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        fs, filterFreq, 0.7f, juce::Decibels::decibelsToGain(filterGain * -1.0f));
-    procs.get<hpfIdx>().coefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        fs, filterFreq, 0.7f, juce::Decibels::decibelsToGain(filterGain));
+    setShelfCoefficients(filterFreq, filterGain);
+}
+
+void DelayProc::setShelfCoefficients(float filterFreq, float filterGainDb)
+{
+    // Assign in place: the coefficient objects are shared with the filters and never reallocated
+    *procs.get<lpfIdx>().coefficients = juce::dsp::IIR::ArrayCoefficients<float>::makeLowShelf(
+        fs, filterFreq, 0.7f, FastMath::dbToGain(filterGainDb * -1.0f));
+    *procs.get<hpfIdx>().coefficients = juce::dsp::IIR::ArrayCoefficients<float>::makeHighShelf(
+        fs, filterFreq, 0.7f, FastMath::dbToGain(filterGainDb));
 }
 
 void DelayProc::updateProcChainParameters(size_t numSamples, bool force)
@@ -334,7 +406,7 @@ void DelayProc::updateProcChainParameters(size_t numSamples, bool force)
 
 void DelayProc::updateAgeingRate(size_t numSamples)
 {
-    auto normalizedGrowthRate = ParameterRanges::normalizeParameter(ParameterRanges::growthRateRange, inGrowthRate.skip(numSamples));
+    auto normalizedGrowthRate = ParameterRanges::growthRateMapping.normalise(inGrowthRate.skip(numSamples));
     rampTimeMs = inBaseDelayMs * 100.0f / juce::jmax(0.001f, normalizedGrowthRate);
     if (inputLevel > inputLevelMetabolicThreshold)
     {
@@ -354,10 +426,12 @@ void DelayProc::updateModulationParameters()
         oscFreq = (1000.0f / inBaseDelayMs) * (1.0f - currentAge.getCurrentValue());
     }
 
-    // Set the oscillator frequency
-    modProcs.get<oscillatorIdx>().setFrequency(oscFreq);
-    // Set the ramp time for gain modulation
-    modProcs.get<gainIdx>().setGainLinear(1-currentAge.getCurrentValue());
+    // Set the oscillator frequency and depth
+    if (modLfoBank != nullptr)
+    {
+        modLfoBank->setFrequency(modLfoIndex, oscFreq * modRateScale);
+    }
+    modGain = 1.0f - currentAge.getCurrentValue();
 }
 
 //==================================================
@@ -7,11 +7,14 @@
 #include "Dispersion.h"
 #include "EnvelopeFollower.h"
 #include "DuckingCompressor.h"
+#include "ProcessingQuality.h"
+#include "ControlClock.h"
+#include "LfoBank.h"
 #include "util/ParameterRanges.h"
 // #include "PitchShiftWrapper.h"
 // #include "Reverser.h"
 // #include "TempoSyncUtils.h"
-// #include "VariableDelay.h"
+#include "VariableDelay.h"
 
 /**
  * Audio processor that implements delay line with feedback,
@@ -46,8 +49,19 @@ class DelayProc
 
         template <typename ProcessContext>
         void process(const ProcessContext &context);
+
+        // Move a sleeping node (silent input and output) on by numSamples without running the
+        // per-sample chain: its control clock, smoothed parameters, ageing and envelopes keep going
+        void skip(int numSamples);
+
         void setParameters(const Parameters &params, bool force = false);
 
+        // Trade accuracy for CPU time (audio thread)
+        void setQuality(const ProcessingQuality &quality);
+
+        // Take the tilt modulation from an LFO of a shared bank (the owner steps the bank)
+        void setModulationLfo(LfoBank *bank, size_t index);
+
         // Getter for the input level (envelope follower)
         float getInputLevel() const { return inputLevel; }
         float getOutputLevel() const { return outputLevel; }
@@ -56,6 +70,7 @@ class DelayProc
         void setExternalSidechainLevel(float level) { externalSidechainLevel = level; }
 
         float getAge() const { return currentAge.getCurrentValue(); } // Getter for the current age value
+        void setAge(float age) { currentAge.setCurrentAndTargetValue(age); } // Jump to an age without ramping
 
         // Getter for the current age as a normalized value (0.0-1.0)
         float getCurrentAge() const { return juce::jlimit(0.0f, 1.0f, currentAge.getCurrentValue() / 100.0f); }
@@ -65,10 +80,11 @@ class DelayProc
         inline SampleType processSample(SampleType x, size_t ch);
 
         juce::SharedResourcePointer<DelayStore> delayStore;
-        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> delay;
+        VariableDelay delay;
         DuckingCompressor compressor;
 
         float fs = 44100.0f;
+        int numChannels = 2;
         static constexpr float smoothTimeSec = 0.25f;
 
         // Parameters
@@ -85,7 +101,12 @@ class DelayProc
         // flush delay line state
         void flushDelay();
 
+        // Control-rate work: envelope reads, ageing, modulation and coefficient updates
+        ControlClock controlClock;
+        void updateControl();
+
         void updateFilterCoefficients(bool force = false);
+        void setShelfCoefficients(float filterFreq, float filterGainDb);
         void updateProcChainParameters(size_t numSamples = 1, bool force = false);
         void updateAgeingRate(size_t numSamples = 1);
         void updateModulationParameters();
@@ -128,17 +149,13 @@ class DelayProc
             // Reverser>
             procs;
 
-        // Modulation processor chain
-        enum
-        {
-            oscillatorIdx,
-            gainIdx
-        };
-
-        MyProcessorChain<
-            juce::dsp::Oscillator<float>,
-            juce::dsp::Gain<float>>
-            modProcs;
+        // Tilt modulation, from this node's LFO in the shared bank
+        LfoBank *modLfoBank = nullptr;
+        size_t modLfoIndex = 0;
+        // The tilt has always drifted at a fraction of its nominal rate (its oscillator advanced one
+        // sample per control period): this keeps that rate with the bank running in Hz
+        static constexpr float modRateScale = 1.0f / static_cast<float>(ControlClock::defaultInterval);
+        float modGain = 1.0f;
 
         // TempoSyncUtils::SyncedLFO modSine;
         float delayModValue = 0.0f;
@@ -6,6 +6,8 @@
 
 #include <juce_dsp/juce_dsp.h>
 
+#include "VariableDelay.h"
+
 /** A store to create delay objects more quickly. */
 class DelayStore
 {
@@ -17,7 +19,7 @@ class DelayStore
                 loadNewDelay();
         }
 
-        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd> *getNextDelay()
+        VariableDelay *getNextDelay()
         {
             juce::SpinLock::ScopedLockType nextDelayLock(delayStoreLock);
 
@@ -34,7 +36,7 @@ class DelayStore
             delayFutureStore.push_back(
                 std::async(std::launch::async,
                     [] {
-                            auto newDelay = std::make_unique<juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd>> (1 << 19);
+                            auto newDelay = std::make_unique<VariableDelay> (1 << 19);
                             newDelay->prepare ({ 48000.0, 512, 2 });
                             newDelay->reset();
                             return newDelay;
@@ -45,7 +47,7 @@ class DelayStore
 
         static constexpr int storeSize = 32;
 
-        std::deque<std::future<std::unique_ptr<juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Lagrange3rd>>>> delayFutureStore;
+        std::deque<std::future<std::unique_ptr<VariableDelay>>> delayFutureStore;
         juce::SpinLock delayStoreLock;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayStore)
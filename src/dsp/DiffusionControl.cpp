@@ -14,6 +14,7 @@ void DiffusionControl::prepare(const juce::dsp::ProcessSpec &spec)
 {
     // Store sample rate for coefficient updates
     fs = spec.sampleRate;
+    filterType = useSteepFilters ? sst::filters::fut_bp24 : sst::filters::fut_bp12;
 
     // Prepare all filters
     for (size_t i = 0; i < inNumActiveBands; ++i)
@@ -21,7 +22,7 @@ void DiffusionControl::prepare(const juce::dsp::ProcessSpec &spec)
         coeffMaker[i] = sst::filters::FilterCoefficientMaker<>();
         coeffMaker[i].setSampleRateAndBlockSize((float)fs, spec.maximumBlockSize);
 
-        filters[i] = sst::filters::GetQFPtrFilterUnit(sst::filters::fut_bp24, sst::filters::st_Standard);
+        filters[i] = sst::filters::GetQFPtrFilterUnit(filterType, sst::filters::st_Standard);
     }
 
     prepareCoefficients();
@@ -42,7 +43,7 @@ void DiffusionControl::reset()
 template <typename ProcessContext>
 void DiffusionControl::process(
     const ProcessContext &inContext,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &outputBuffers)
+    BufferSpan outputBuffers)
 {
     // Manage audio context
     const auto &inputBlock = inContext.getInputBlock();
@@ -53,16 +54,13 @@ void DiffusionControl::process(
     jassert(inputBlock.getNumChannels() == numChannels);
     jassert(inputBlock.getNumSamples() == numSamples);
 
-    // Copy input to all output bands
-    for (int band = 0; band < inNumActiveBands; ++band)
-    {
-        juce::dsp::AudioBlock<float> outputBandBlock(*outputBuffers[band].get());
-        outputBandBlock.copyFrom(inputBlock);
-    }
-
-    // Skip processing if bypassed
+    // Pass the input to all output bands if bypassed
     if (inContext.isBypassed)
     {
+        for (int band = 0; band < inNumActiveBands; ++band)
+        {
+            juce::dsp::AudioBlock<float>(outputBuffers[band]).copyFrom(inputBlock);
+        }
         return;
     }
 
@@ -70,7 +68,7 @@ void DiffusionControl::process(
     for (int band = 0; band < inNumActiveBands; ++band)
     {
         // Create AudioBlock for filter processing
-        juce::dsp::AudioBlock<float> outputBandBlock(*outputBuffers[band].get());
+        juce::dsp::AudioBlock<float> outputBandBlock(outputBuffers[band]);
 
         // Ensure filter bands are active
         for (int ch = 0; ch < numChannels; ++ch)
@@ -78,12 +76,12 @@ void DiffusionControl::process(
             filterState[band].active[ch] = 0xFFFFFFFF;
         }
 
-        // Apply filter
+        // Apply filter, reading straight from the input
         for (int i = 0; i < numSamples; ++i)
         {
             float r alignas(16)[4];
-            r[0] = outputBandBlock.getChannelPointer(0)[i];
-            r[1] = outputBandBlock.getChannelPointer(1)[i];
+            r[0] = inputBlock.getChannelPointer(0)[i];
+            r[1] = inputBlock.getChannelPointer(1)[i];
             r[2] = 0.f;
             r[3] = 0.f;
             auto yVec = filters[band](&filterState[band], SIMD_MM(load_ps)(r));
@@ -127,7 +125,7 @@ void DiffusionControl::prepareCoefficients()
         // Get the center frequency for this band
         float centerFreq = bandFrequencies[i];
 
-        coeffMaker[i].MakeCoeffs(freq_hz_to_note_num(centerFreq), 0.7f, sst::filters::fut_bp24, sst::filters::st_Standard, nullptr, false);
+        coeffMaker[i].MakeCoeffs(freq_hz_to_note_num(centerFreq), 0.7f, filterType, sst::filters::st_Standard, nullptr, false);
 
         coeffMaker[i].updateState(filterState[i]);
     }
@@ -153,5 +151,5 @@ void DiffusionControl::getBandFrequencies(float *outBandFrequencies, int *numAct
     std::memcpy(outBandFrequencies, bandFrequencies.data(), *numActiveBands * sizeof(float));
 }
 
-template void DiffusionControl::process<juce::dsp::ProcessContextReplacing<float>>(const juce::dsp::ProcessContextReplacing<float> &, std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
-template void DiffusionControl::process<juce::dsp::ProcessContextNonReplacing<float>>(const juce::dsp::ProcessContextNonReplacing<float> &, std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
\ No newline at end of file
+template void DiffusionControl::process<juce::dsp::ProcessContextReplacing<float>>(const juce::dsp::ProcessContextReplacing<float> &, BufferSpan);
+template void DiffusionControl::process<juce::dsp::ProcessContextNonReplacing<float>>(const juce::dsp::ProcessContextNonReplacing<float> &, BufferSpan);
\ No newline at end of file
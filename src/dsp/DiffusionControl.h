@@ -2,6 +2,8 @@
 #include "sst/filters.h"
 #include "sst/filters/FilterCoefficientMaker_Impl.h"
 #include "util/ParameterRanges.h"
+#include "ProcessingQuality.h"
+#include "BufferArena.h"
 
 class DiffusionControl
 {
@@ -22,9 +24,13 @@ class DiffusionControl
         // Returns an array of processed audio blocks
         template <typename ProcessContext>
         void process(const ProcessContext &context,
-                     std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &outputBuffers);
+                     BufferSpan outputBuffers);
 
         void setParameters(const Parameters &params);
+
+        // The filter slope is applied on the next prepare()
+        void setQuality(const ProcessingQuality &quality) { useSteepFilters = quality.steepDiffusionFilters; }
+
         void getBandFrequencies(float *outBandFrequencies, int *numActiveBands);
 
     private:
@@ -35,6 +41,10 @@ class DiffusionControl
         static constexpr double minFreq = 250.0;
         static constexpr double maxFreq = 4000.0;
 
+        // 24 dB/oct band-pass filters, or 12 dB/oct for the lean path
+        bool useSteepFilters = true;
+        sst::filters::FilterType filterType = sst::filters::fut_bp24;
+
         // Filter bank implementation
         std::array<sst::filters::FilterCoefficientMaker<>, ParameterRanges::maxNutrientBands> coeffMaker;
         std::array<sst::filters::QuadFilterUnitState, ParameterRanges::maxNutrientBands> filterState;
@@ -13,7 +13,7 @@ void Dispersion::reset()
 
 float Dispersion::processSample(float x)
 {
-    auto numStages = inDispersionAmount * maxNumStages;
+    auto numStages = std::min(inDispersionAmount * maxNumStages, static_cast<float>(maxActiveStages));
     const auto numStagesInt = static_cast<size_t>(numStages);
     float y = x;
 
@@ -21,9 +21,12 @@ float Dispersion::processSample(float x)
     for (size_t stage = 0; stage < numStagesInt; ++stage)
         y = processStage(y, stage);
 
-    // process fractional stage
-    float stageFrac = numStages - numStagesInt;
-    y = stageFrac * processStage(y, numStagesInt) + (1.0f - stageFrac) * y;
+    // process fractional stage (none when capped)
+    if (numStagesInt < maxActiveStages)
+    {
+        float stageFrac = numStages - numStagesInt;
+        y = stageFrac * processStage(y, numStagesInt) + (1.0f - stageFrac) * y;
+    }
 
     // Save the allpass path output for the next call
     y1 = y;
@@ -27,6 +27,9 @@ class Dispersion
         float processSample(float x);
         void  setParameters(const Parameters &params);
 
+        // Limit the number of allpass stages that are run
+        void  setMaxStages(size_t numStages) { maxActiveStages = std::min(numStages, maxNumStages); }
+
     private:
         void  updateAllpassCoefficients();
         float processStage(float x, size_t stage);
@@ -36,6 +39,7 @@ class Dispersion
         float inAllpassFreq = 800.0f;
 
         static constexpr size_t maxNumStages = 10;
+        size_t maxActiveStages = maxNumStages;
 
         float fs   = 44100.0f;
         float a[2] = { 0.0f};
@@ -1,4 +1,5 @@
 #include "DuckingCompressor.h"
+#include "util/FastMath.h"
 
 DuckingCompressor::DuckingCompressor()
 {
@@ -30,7 +31,7 @@ void DuckingCompressor::allocateVectors(size_t numChannels)
     // Resize gainReduction if needed
     if (gainReduction.size() != numChannels)
     {
-        gainReduction.resize(numChannels);
+        gainReduction.resize(numChannels, 1.0f);
     }
 }
 
@@ -53,7 +54,7 @@ float DuckingCompressor::processSample(float inputSample, float sidechainLevel,
         return inputSample;
 
     // Convert sidechain level to dB
-    auto sidechainDb = juce::Decibels::gainToDecibels(sidechainLevel);
+    auto sidechainDb = FastMath::gainToDb(sidechainLevel);
 
     // Calculate desired gain reduction amount
     auto gainReducDb = calculateGainReduction(sidechainDb);
@@ -63,11 +64,28 @@ float DuckingCompressor::processSample(float inputSample, float sidechainLevel,
     auto smoothedGainReducDb = attackReleaseCalculator.getAverageLevel(channel);
 
     // Convert gain reduction from dB to linear and update state
-    gainReduction[channel] = juce::Decibels::decibelsToGain(smoothedGainReducDb);
+    gainReduction[channel] = FastMath::dbToGain(smoothedGainReducDb);
 
     // Apply gain reduction and makeup gain to input sample
     auto reducedSample = inputSample * gainReduction[channel];
-    return reducedSample * juce::Decibels::decibelsToGain(params.makeupGain);
+    return reducedSample * FastMath::dbToGain(params.makeupGain);
+}
+
+DuckingCompressor::GainRamp DuckingCompressor::getGainRamp(float sidechainLevel, size_t channel, int numSamples)
+{
+    if (channel >= gainReduction.size() || numSamples <= 0 || !params.enabled)
+        return {};
+
+    // The target reduction is the same for every sample of the block, so the smoothing
+    // can be advanced in one step and only the gains at both ends are needed
+    const auto previousGain = gainReduction[channel];
+    const auto gainReducDb = calculateGainReduction(FastMath::gainToDb(sidechainLevel));
+    attackReleaseCalculator.processConstant(static_cast<int>(channel), gainReducDb, numSamples);
+    gainReduction[channel] = FastMath::dbToGain(attackReleaseCalculator.getAverageLevel(static_cast<int>(channel)));
+
+    const auto makeupGain = FastMath::dbToGain(params.makeupGain);
+    const auto step = (gainReduction[channel] - previousGain) / static_cast<float>(numSamples);
+    return {(previousGain + step) * makeupGain, step * makeupGain};
 }
 
 void DuckingCompressor::setParameters(const Parameters &newParams, bool force)
@@ -128,7 +146,7 @@ float DuckingCompressor::calculateGainReduction(float sidechainLevelDb)
         {
             // In the knee region
             return juce::jmin(
-                0.5f * slope * std::pow(overshootDb + kneeDbHalf, 2.0f) / params.kneeWidth,
+                0.5f * slope * juce::square(overshootDb + kneeDbHalf) / params.kneeWidth,
                 0.0f);
         }
 
@@ -2,6 +2,7 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include "EnvelopeFollower.h"
+#include "SimdKernels.h"
 
 /**
  * A compressor that uses a sidechain input to "duck" the main signal.
@@ -14,6 +15,9 @@ class DuckingCompressor
         DuckingCompressor();
         ~DuckingCompressor();
 
+        // A linear gain trajectory over a block: sample i gets start + i * step
+        using GainRamp = SimdKernels::GainRamp;
+
         struct Parameters
         {
             float threshold;   // Threshold in dB, below which no compression is applied
@@ -35,6 +39,9 @@ class DuckingCompressor
         // Process a single sample with sidechain input
         float processSample(float inputSample, float sidechainLevel, size_t channel);
 
+        // Advance over a block whose sidechain level is constant and return the gain to apply to it
+        GainRamp getGainRamp(float sidechainLevel, size_t channel, int numSamples);
+
         // Sets compressor parameters
         void setParameters(const Parameters &newParams, bool force = false);
 
@@ -1,13 +1,15 @@
 #include "EdgeTree.h"
 #include "util/ParameterRanges.h"
 
-EdgeTree::EdgeTree()
+EdgeTree::EdgeTree(ControlScheduler &scheduler) :
+    ControlTimer(&scheduler)
 {
     startTimerHz(2); // Start the timer for parameter updates
 }
 
 EdgeTree::~EdgeTree()
 {
+    stopTimer();
 }
 
 void EdgeTree::prepare(const juce::dsp::ProcessSpec &spec)
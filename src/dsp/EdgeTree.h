@@ -3,16 +3,17 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "EnvelopeFollower.h"
+#include "ControlScheduler.h"
 
 /**
  * EdgeTree processes audio to extract envelope information
  * and generate tree edge data based on audio dynamics
  */
 class EdgeTree
-    : private juce::Timer
+    : private ControlTimer
 {
     public:
-        EdgeTree();
+        explicit EdgeTree(ControlScheduler &scheduler);
         ~EdgeTree();
 
         // Parameters
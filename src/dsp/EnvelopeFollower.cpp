@@ -1,4 +1,5 @@
 #include "EnvelopeFollower.h"
+#include "util/FastMath.h"
 
 EnvelopeFollower::EnvelopeFollower()
 {
@@ -8,6 +9,7 @@ EnvelopeFollower::EnvelopeFollower()
 void EnvelopeFollower::prepare(const juce::dsp::ProcessSpec &spec)
 {
     sampleRate = static_cast<float>(spec.sampleRate);
+    kernels = &SimdKernels::get();
 
     // Calculate coefficients for attack and release
     setInterpolationParameters();
@@ -44,14 +46,17 @@ template <typename ProcessContext>
 void EnvelopeFollower::process(const ProcessContext &context)
 {
     // Get input block
-    const auto &inputBlock = context.getInputBlock();
-    const auto numSamples = inputBlock.getNumSamples();
+    analyse(context.getInputBlock());
+}
 
+template <typename SampleType>
+void EnvelopeFollower::analyse(const juce::dsp::AudioBlock<SampleType> &block)
+{
     // Resize envelopeStates if needed
     allocateVectors(numChannels);
 
     // Process each channel with the envelope follower
-    gainInterpolator(inputBlock, numSamples);
+    gainInterpolator(block, block.getNumSamples());
 }
 
 void EnvelopeFollower::processSample(int channel, float sample)
@@ -77,51 +82,101 @@ void EnvelopeFollower::processSample(int channel, float sample)
     }
 }
 
+void EnvelopeFollower::processConstant(int channel, float sample, int numSamples)
+{
+    if (channel < 0 || channel >= static_cast<int>(envelopeStates.size()) || numSamples <= 0)
+        return;
+
+    // Each step closes a fixed fraction of the distance to the input, so the envelope
+    // decays geometrically and never overshoots
+    auto &envelope = envelopeStates[channel].envelope;
+    const auto epsilon = (envelope < sample) ? epsilonAt : epsilonRe;
+
+    if (epsilon >= 1.0f)
+    {
+        envelope = sample;
+    }
+    else if (epsilon > 0.0f)
+    {
+        envelope = sample + (envelope - sample) * FastMath::exp2(static_cast<float>(numSamples) * FastMath::log2(1.0f - epsilon));
+    }
+}
+
 template <typename SampleType>
 void EnvelopeFollower::gainInterpolator(const juce::dsp::AudioBlock<SampleType> &inputBlock, size_t numSamples)
 {
     for (size_t channel = 0; channel < numChannels; ++channel)
     {
-        auto &envelope = envelopeStates[channel].envelope;
-
         float min = inputBlock.getSample(channel, 0);
         float max = min;
-        for (size_t i = 0; i < numSamples; ++i)
+        if (analysisStride == 1)
         {
-            auto sample = inputBlock.getSample(channel, i);
-            if (inLevelType == juce::dsp::BallisticsFilterLevelCalculationType::RMS)
-            {
-                sample *= sample;
-            }
-            else
+            // The whole block in one vectorised pass
+            auto levelMin = 0.0f;
+            auto levelMax = 0.0f;
+            kernels->getLevelRange(inputBlock.getChannelPointer(channel), static_cast<int>(numSamples),
+                                   inLevelType == juce::dsp::BallisticsFilterLevelCalculationType::RMS, levelMin, levelMax);
+            min = std::min(min, levelMin);
+            max = std::max(max, levelMax);
+        }
+        else
+        {
+            for (size_t i = 0; i < numSamples; i += static_cast<size_t>(analysisStride))
             {
-                sample = std::abs(sample);
+                auto sample = inputBlock.getSample(channel, i);
+                if (inLevelType == juce::dsp::BallisticsFilterLevelCalculationType::RMS)
+                {
+                    sample *= sample;
+                }
+                else
+                {
+                    sample = std::abs(sample);
+                }
+                min = std::min(min, sample);
+                max = std::max(max, sample);
             }
-            min = std::min(min, sample);
-            max = std::max(max, sample);
         }
 
-        if (envelope < max)
-        {
-            // Attack phase
-            envelope = std::min(envelope + numSamples * epsilonAt * ((max - envelope)), max);
-        }
+        followLevels(channel, min, max, numSamples);
+    }
+}
 
-        else if (envelope > max)
-        {
-            // Release phase
-            envelope = std::max(envelope + numSamples * epsilonRe * ((max - envelope)), min);
-        }
+void EnvelopeFollower::analyseSilence(int numSamples)
+{
+    if (numSamples <= 0)
+        return;
 
-        envelopeStates[channel].rmsSamples += numSamples;
-        if (inLevelType == juce::dsp::BallisticsFilterLevelCalculationType::RMS)
-        {
-            envelopeStates[channel].rmsSum += envelope;
-        }
-        else
-        {
-            envelopeStates[channel].rmsSum += envelope * envelope;
-        }
+    allocateVectors(numChannels);
+    for (size_t channel = 0; channel < static_cast<size_t>(numChannels); ++channel)
+    {
+        followLevels(channel, 0.0f, 0.0f, static_cast<size_t>(numSamples));
+    }
+}
+
+void EnvelopeFollower::followLevels(size_t channel, float min, float max, size_t numSamples)
+{
+    auto &envelope = envelopeStates[channel].envelope;
+
+    if (envelope < max)
+    {
+        // Attack phase
+        envelope = std::min(envelope + numSamples * epsilonAt * ((max - envelope)), max);
+    }
+
+    else if (envelope > max)
+    {
+        // Release phase
+        envelope = std::max(envelope + numSamples * epsilonRe * ((max - envelope)), min);
+    }
+
+    envelopeStates[channel].rmsSamples += numSamples;
+    if (inLevelType == juce::dsp::BallisticsFilterLevelCalculationType::RMS)
+    {
+        envelopeStates[channel].rmsSum += envelope;
+    }
+    else
+    {
+        envelopeStates[channel].rmsSum += envelope * envelope;
     }
 }
 
@@ -153,8 +208,10 @@ void EnvelopeFollower::setParameters(const Parameters &params, bool force)
 
 void EnvelopeFollower::setInterpolationParameters()
 {
-    attackCoef = std::exp(std::log(0.01) / (inAttackMs * sampleRate * 0.001));
-    releaseCoef = std::exp(std::log(0.01) / (inReleaseMs * sampleRate * 0.001));
+    // Time to reach 1% (-40 dB) of the step
+    constexpr float log2OnePercent = -6.643856190f;
+    attackCoef = FastMath::exp2(log2OnePercent / (inAttackMs * sampleRate * 0.001f));
+    releaseCoef = FastMath::exp2(log2OnePercent / (inReleaseMs * sampleRate * 0.001f));
 }
 
 float EnvelopeFollower::getAverageLevel(int channel) const
@@ -177,4 +234,8 @@ float EnvelopeFollower::getAverageLevel(int channel) const
 template void EnvelopeFollower::process<juce::dsp::ProcessContextReplacing<float>>(const juce::dsp::ProcessContextReplacing<float> &);
 template void EnvelopeFollower::process<juce::dsp::ProcessContextNonReplacing<float>>(const juce::dsp::ProcessContextNonReplacing<float> &);
 
-template void EnvelopeFollower::gainInterpolator(const juce::dsp::AudioBlock<float> &inputBlock, size_t numSamples);
\ No newline at end of file
+template void EnvelopeFollower::analyse<float>(const juce::dsp::AudioBlock<float> &);
+template void EnvelopeFollower::analyse<const float>(const juce::dsp::AudioBlock<const float> &);
+
+template void EnvelopeFollower::gainInterpolator(const juce::dsp::AudioBlock<float> &inputBlock, size_t numSamples);
+template void EnvelopeFollower::gainInterpolator(const juce::dsp::AudioBlock<const float> &inputBlock, size_t numSamples);
\ No newline at end of file
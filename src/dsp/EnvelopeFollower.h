@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_dsp/juce_dsp.h>
+#include "SimdKernels.h"
 
 /**
  * EnvelopeFollower processes audio to extract amplitude envelope information
@@ -25,10 +26,21 @@ public:
 
     template <typename ProcessContext>
     void process(const ProcessContext &context);
+
+    // Follow the envelope over a block (or part of one)
+    template <typename SampleType>
+    void analyse(const juce::dsp::AudioBlock<SampleType> &block);
     void processSample(int ch, float sample);
+    // Follow a constant input for numSamples samples (the same as that many processSample calls)
+    void processConstant(int ch, float sample, int numSamples);
+    // Follow a silent block of numSamples samples (the same as analysing one)
+    void analyseSilence(int numSamples);
 
     void setParameters(const Parameters &params, bool force = false);
 
+    // Analyse every Nth sample of each block (1 analyses them all)
+    void setAnalysisStride(int stride) { analysisStride = juce::jmax(1, stride); }
+
     // Get the average level across all channels
     float getAverageLevel(int channel = 0) const;
 
@@ -37,6 +49,9 @@ private:
     void gainInterpolator(const juce::dsp::AudioBlock<SampleType> &inputBlock, size_t numSamples);
     void setInterpolationParameters();
 
+    // Move a channel's envelope over a block from its lowest and highest levels
+    void followLevels(size_t channel, float min, float max, size_t numSamples);
+
     struct EnvelopeState
     {
         float envelope = 0.0f;
@@ -52,6 +67,10 @@ private:
     float epsilonRe   = 0.0f;
     juce::dsp::BallisticsFilterLevelCalculationType inLevelType = juce::dsp::BallisticsFilterLevelCalculationType::RMS;
     int numChannels = 2;
+    int analysisStride = 1;
+
+    // Level analysis kernels for the CPU (taken in prepare)
+    const SimdKernels::Table *kernels = &SimdKernels::get();
 
     // Coefficients for attack and release
     double attackCoef = 0.0;
@@ -0,0 +1,225 @@
+#include "FdnReverb.h"
+#include "sst/basic-blocks/simd/setup.h"
+#include "util/FastMath.h"
+
+namespace
+{
+    // Shuffle immediates: lanes (1, 0, 3, 2) and (2, 3, 0, 1)
+    constexpr int swapPairs = 0xB1;
+    constexpr int swapHalves = 0x4E;
+
+    bool isPrime(int n)
+    {
+        if (n < 2)
+            return false;
+        for (int d = 2; d * d <= n; ++d)
+        {
+            if (n % d == 0)
+                return false;
+        }
+        return true;
+    }
+
+    // Hadamard transform of the four lanes of a register
+    template <typename Vector>
+    inline Vector hadamard4(Vector v, Vector signsPairs, Vector signsHalves)
+    {
+        v = SIMD_MM(add_ps)(SIMD_MM(mul_ps)(v, signsPairs), SIMD_MM(shuffle_ps)(v, v, swapPairs));
+        return SIMD_MM(add_ps)(SIMD_MM(mul_ps)(v, signsHalves), SIMD_MM(shuffle_ps)(v, v, swapHalves));
+    }
+}
+
+void FdnReverb::prepare(double newSampleRate, int newNumLines, float roomSize)
+{
+    sampleRate = newSampleRate;
+    numLines = (newNumLines >= 16) ? 16 : (newNumLines >= 8) ? 8 : 4;
+
+    // Line lengths spread exponentially over the room, nudged to primes so they share no echoes
+    const auto scale = 0.5f + juce::jlimit(0.0f, 1.0f, roomSize);
+    constexpr float minMs = 15.0f;
+    constexpr float maxMs = 75.0f;
+    auto longest = 1;
+    for (int line = 0; line < numLines; ++line)
+    {
+        const auto ms = minMs * std::pow(maxMs / minMs, static_cast<float>(line) / static_cast<float>(numLines - 1));
+        auto length = juce::jmax(2, static_cast<int>(ms * scale * 0.001f * static_cast<float>(sampleRate)));
+        while (!isPrime(length))
+        {
+            ++length;
+        }
+        lineLengths[static_cast<size_t>(line)] = length;
+        longest = juce::jmax(longest, length);
+
+        // Even lines carry the left channel, odd lines the right one, with alternating signs
+        const auto sign = ((line / 2) % 2 == 0) ? 1.0f : -1.0f;
+        outputSignsLeft[static_cast<size_t>(line)] = (line % 2 == 0) ? sign : 0.0f;
+        outputSignsRight[static_cast<size_t>(line)] = (line % 2 == 1) ? sign : 0.0f;
+    }
+
+    const auto lineSize = juce::nextPowerOfTwo(longest + 1);
+    lineMask = lineSize - 1;
+    lines.assign(static_cast<size_t>(numLines * lineSize), 0.0f);
+
+    const auto predelaySize = juce::nextPowerOfTwo(static_cast<int>(maxPredelaySeconds * sampleRate) + 1);
+    predelayMask = predelaySize - 1;
+    predelayBuffer.assign(static_cast<size_t>(2 * predelaySize), 0.0f);
+
+    const auto rateScale = static_cast<float>(sampleRate / 44100.0);
+    diffuserLengths = {juce::jlimit(1, numDiffuserSamples, static_cast<int>(142 * rateScale)),
+                       juce::jlimit(1, numDiffuserSamples, static_cast<int>(107 * rateScale))};
+
+    parametersChanged = true;
+    reset();
+}
+
+void FdnReverb::reset()
+{
+    std::fill(lines.begin(), lines.end(), 0.0f);
+    std::fill(predelayBuffer.begin(), predelayBuffer.end(), 0.0f);
+    for (auto &diffuser : diffusers)
+    {
+        diffuser.fill(0.0f);
+    }
+    lowpassState.fill(0.0f);
+    writePos = 0;
+    predelayWritePos = 0;
+    diffuserPos = 0;
+}
+
+void FdnReverb::setParameters(const Parameters &params)
+{
+    inDecaySeconds = juce::jmax(0.05f, params.decaySeconds);
+    inPredelaySeconds = juce::jlimit(0.0f, maxPredelaySeconds, params.predelaySeconds);
+    inDiffusion = juce::jlimit(0.0f, 1.0f, params.diffusion);
+    inDamping = juce::jlimit(0.0f, 1.0f, params.damping);
+    parametersChanged = true;
+}
+
+void FdnReverb::updateCoefficients()
+{
+    // Every line loses 60 dB over the decay time, whatever its length (the Hadamard matrix is normalised here too)
+    const auto decaySamples = inDecaySeconds.load() * static_cast<float>(sampleRate);
+    const auto normalisation = 1.0f / std::sqrt(static_cast<float>(numLines));
+    for (int line = 0; line < numLines; ++line)
+    {
+        const auto length = static_cast<float>(lineLengths[static_cast<size_t>(line)]);
+        feedbackGains[static_cast<size_t>(line)] = normalisation * FastMath::dbToGain(-60.0f * length / decaySamples);
+    }
+
+    predelaySamples = juce::jlimit(0, predelayMask, static_cast<int>(inPredelaySeconds.load() * static_cast<float>(sampleRate)));
+    diffuserGain = 0.7f * inDiffusion.load();
+    dampingCoefficient = 0.95f * inDamping.load();
+}
+
+void FdnReverb::process(juce::dsp::AudioBlock<float> &block)
+{
+    if (numLines == 0 || block.getNumChannels() < 2)
+    {
+        return;
+    }
+
+    if (parametersChanged.exchange(false))
+    {
+        updateCoefficients();
+    }
+
+    auto *left = block.getChannelPointer(0);
+    auto *right = block.getChannelPointer(1);
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    const auto numVectors = numLines / 4;
+    const auto lineSize = lineMask + 1;
+    const auto predelaySize = predelayMask + 1;
+
+    const auto damping = SIMD_MM(set1_ps)(dampingCoefficient);
+    const auto signsPairs = SIMD_MM(setr_ps)(1.0f, -1.0f, 1.0f, -1.0f);
+    const auto signsHalves = SIMD_MM(setr_ps)(1.0f, 1.0f, -1.0f, -1.0f);
+    const auto outputScale = 2.0f / static_cast<float>(numLines);
+
+    alignas(16) float taps[maxNumLines];
+    alignas(16) float feedback[maxNumLines];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Predelay
+        float input[2] = {left[i], right[i]};
+        const auto readPos = (predelayWritePos - predelaySamples) & predelayMask;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            predelayBuffer[static_cast<size_t>(ch * predelaySize + predelayWritePos)] = input[ch];
+            input[ch] = predelayBuffer[static_cast<size_t>(ch * predelaySize + readPos)];
+        }
+        predelayWritePos = (predelayWritePos + 1) & predelayMask;
+
+        // Allpass diffusion
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto &diffuser = diffusers[static_cast<size_t>(ch)];
+            const auto pos = diffuserPos % diffuserLengths[static_cast<size_t>(ch)];
+            const auto delayed = diffuser[static_cast<size_t>(pos)];
+            const auto v = input[ch] - diffuserGain * delayed;
+            diffuser[static_cast<size_t>(pos)] = v;
+            input[ch] = delayed + diffuserGain * v;
+        }
+        diffuserPos = (diffuserPos + 1) % (diffuserLengths[0] * diffuserLengths[1]);
+
+        for (int line = 0; line < numLines; ++line)
+        {
+            taps[line] = lines[static_cast<size_t>(line * lineSize + ((writePos - lineLengths[static_cast<size_t>(line)]) & lineMask))];
+        }
+
+        // Damp every line and pick up the outputs
+        auto sumLeft = SIMD_MM(setzero_ps)();
+        auto sumRight = SIMD_MM(setzero_ps)();
+        for (int v = 0; v < numVectors; ++v)
+        {
+            auto state = SIMD_MM(load_ps)(lowpassState.data() + 4 * v);
+            const auto tap = SIMD_MM(load_ps)(taps + 4 * v);
+            state = SIMD_MM(add_ps)(tap, SIMD_MM(mul_ps)(damping, SIMD_MM(sub_ps)(state, tap)));
+            SIMD_MM(store_ps)(lowpassState.data() + 4 * v, state);
+
+            sumLeft = SIMD_MM(add_ps)(sumLeft, SIMD_MM(mul_ps)(state, SIMD_MM(load_ps)(outputSignsLeft.data() + 4 * v)));
+            sumRight = SIMD_MM(add_ps)(sumRight, SIMD_MM(mul_ps)(state, SIMD_MM(load_ps)(outputSignsRight.data() + 4 * v)));
+
+            SIMD_MM(store_ps)(feedback + 4 * v, hadamard4(state, signsPairs, signsHalves));
+        }
+
+        // Hadamard butterflies across registers
+        for (int stride = 4; stride < numLines; stride *= 2)
+        {
+            for (int start = 0; start < numLines; start += 2 * stride)
+            {
+                for (int offset = 0; offset < stride; offset += 4)
+                {
+                    auto *a = feedback + start + offset;
+                    auto *b = a + stride;
+                    const auto x = SIMD_MM(load_ps)(a);
+                    const auto y = SIMD_MM(load_ps)(b);
+                    SIMD_MM(store_ps)(a, SIMD_MM(add_ps)(x, y));
+                    SIMD_MM(store_ps)(b, SIMD_MM(sub_ps)(x, y));
+                }
+            }
+        }
+
+        // Decay, inject the input and write back
+        const auto inLeft = SIMD_MM(set1_ps)(input[0]);
+        const auto inRight = SIMD_MM(set1_ps)(input[1]);
+        for (int v = 0; v < numVectors; ++v)
+        {
+            auto x = SIMD_MM(mul_ps)(SIMD_MM(load_ps)(feedback + 4 * v), SIMD_MM(load_ps)(feedbackGains.data() + 4 * v));
+            x = SIMD_MM(add_ps)(x, SIMD_MM(mul_ps)(inLeft, SIMD_MM(load_ps)(outputSignsLeft.data() + 4 * v)));
+            x = SIMD_MM(add_ps)(x, SIMD_MM(mul_ps)(inRight, SIMD_MM(load_ps)(outputSignsRight.data() + 4 * v)));
+            SIMD_MM(store_ps)(feedback + 4 * v, x);
+        }
+        for (int line = 0; line < numLines; ++line)
+        {
+            lines[static_cast<size_t>(line * lineSize + writePos)] = feedback[line];
+        }
+        writePos = (writePos + 1) & lineMask;
+
+        alignas(16) float sums[2][4];
+        SIMD_MM(store_ps)(sums[0], sumLeft);
+        SIMD_MM(store_ps)(sums[1], sumRight);
+        left[i] = outputScale * ((sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]));
+        right[i] = outputScale * ((sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]));
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * A lean feedback delay network reverb, as a cheaper alternative to the sst reverb in Sky.
+ *
+ * 4, 8 or 16 delay lines are mixed through a normalised Hadamard matrix, four
+ * lines per SIMD register: the butterflies inside a register are shuffles,
+ * the ones across registers are plain adds. Every line has a one-pole lowpass
+ * in its feedback path and a gain that gives the same decay time on all lines.
+ * The stereo input goes through a short allpass diffuser and a predelay first.
+ */
+class FdnReverb
+{
+    public:
+        struct Parameters
+        {
+            float decaySeconds = 1.7f;      // Time to decay by 60 dB
+            float predelaySeconds = 0.06f;  // Time before the first reflections
+            float diffusion = 1.0f;         // Amount of input diffusion (0-1)
+            float damping = 0.35f;          // High frequency damping in the feedback path (0-1)
+        };
+
+        static constexpr int maxNumLines = 16;
+        static constexpr float maxPredelaySeconds = 2.0f;
+
+        FdnReverb() = default;
+
+        // Allocates: numLines is 4, 8 or 16, roomSize (0-1) scales the line lengths
+        void prepare(double sampleRate, int numLines, float roomSize);
+        void reset();
+
+        // Any thread: picked up at the start of the next block
+        void setParameters(const Parameters &params);
+
+        // Process a stereo block in place (100% wet)
+        void process(juce::dsp::AudioBlock<float> &block);
+
+        int getNumLines() const { return numLines; }
+
+    private:
+        void updateCoefficients();
+
+        double sampleRate = 44100.0;
+        int numLines = 0;
+
+        // Delay lines of one power of two length each, laid out one after the other
+        std::vector<float> lines;
+        int lineMask = 0;
+        int writePos = 0;
+        std::array<int, maxNumLines> lineLengths {};
+
+        // Feedback state, one SIMD lane per line
+        alignas(16) std::array<float, maxNumLines> lowpassState {};
+        alignas(16) std::array<float, maxNumLines> feedbackGains {};
+        alignas(16) std::array<float, maxNumLines> outputSignsLeft {};
+        alignas(16) std::array<float, maxNumLines> outputSignsRight {};
+        float dampingCoefficient = 0.0f;
+
+        // Input predelay and allpass diffusers (one per channel)
+        std::vector<float> predelayBuffer;
+        int predelayMask = 0;
+        int predelayWritePos = 0;
+        int predelaySamples = 0;
+
+        static constexpr int numDiffuserSamples = 512;
+        std::array<std::array<float, numDiffuserSamples>, 2> diffusers {};
+        std::array<int, 2> diffuserLengths {};
+        int diffuserPos = 0;
+        float diffuserGain = 0.0f;
+
+        // Parameters handed over from the control thread
+        std::atomic<float> inDecaySeconds {1.7f};
+        std::atomic<float> inPredelaySeconds {0.06f};
+        std::atomic<float> inDiffusion {1.0f};
+        std::atomic<float> inDamping {0.35f};
+        std::atomic<bool> parametersChanged {true};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FdnReverb)
+};
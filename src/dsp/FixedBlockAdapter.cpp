@@ -0,0 +1,15 @@
+#include "FixedBlockAdapter.h"
+
+void FixedBlockAdapter::prepare(int newBlockSize, bool blocksAligned)
+{
+    blockSize = juce::jmax(1, newBlockSize);
+    useFifo = !blocksAligned;
+    fifo.setSize(2, blockSize);
+    reset();
+}
+
+void FixedBlockAdapter::reset()
+{
+    fifo.clear();
+    position = 0;
+}
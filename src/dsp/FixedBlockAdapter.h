@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * Feeds a stereo effect that only processes blocks of a fixed size (the sst
+ * voice effects) from blocks of any size.
+ *
+ * When every block is a multiple of the effect block size, the effect runs
+ * directly on the block's own memory. Otherwise a FIFO of one effect block
+ * carries the remainder over to the next call: each sample is swapped with
+ * the processed sample at the same position, which delays the output by
+ * exactly one effect block.
+ */
+class FixedBlockAdapter
+{
+    public:
+        FixedBlockAdapter() = default;
+
+        // Allocates, call from prepare. Aligned blocks must always be a multiple of blockSize.
+        void prepare(int blockSize, bool blocksAligned);
+        void reset();
+
+        // Latency of the FIFO, in samples
+        int getLatencySamples() const { return useFifo ? blockSize : 0; }
+
+        // Run processBlock(left, right) in place on every block of blockSize samples
+        template <typename ProcessBlock>
+        void process(juce::dsp::AudioBlock<float> &block, ProcessBlock &&processBlock)
+        {
+            if (block.getNumChannels() < 2)
+            {
+                return;
+            }
+
+            auto *left = block.getChannelPointer(0);
+            auto *right = block.getChannelPointer(1);
+            const auto numSamples = static_cast<int>(block.getNumSamples());
+
+            if (!useFifo)
+            {
+                jassert(numSamples % blockSize == 0);
+                for (int pos = 0; pos + blockSize <= numSamples; pos += blockSize)
+                {
+                    processBlock(left + pos, right + pos);
+                }
+                return;
+            }
+
+            for (int pos = 0; pos < numSamples;)
+            {
+                const auto num = juce::jmin(numSamples - pos, blockSize - position);
+                std::swap_ranges(left + pos, left + pos + num, fifo.getWritePointer(0, position));
+                std::swap_ranges(right + pos, right + pos + num, fifo.getWritePointer(1, position));
+                position += num;
+                pos += num;
+
+                if (position == blockSize)
+                {
+                    processBlock(fifo.getWritePointer(0), fifo.getWritePointer(1));
+                    position = 0;
+                }
+            }
+        }
+
+    private:
+        int blockSize = 16;
+        bool useFifo = true;
+        int position = 0;
+        juce::AudioBuffer<float> fifo;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FixedBlockAdapter)
+};
@@ -1,7 +1,8 @@
 #include "InputNode.h"
 #include "util/ParameterRanges.h"
 
-InputNode::InputNode()
+InputNode::InputNode(ControlScheduler &scheduler) :
+    ControlTimer(&scheduler)
 {
     // Initialize the input nodes
     gain.setGainLinear(inGainLevel);    // Gain
@@ -28,7 +29,7 @@ InputNode::InputNode()
 
 InputNode::~InputNode()
 {
-    // Clean up any resources
+    stopTimer();
 }
 
 void InputNode::prepare(const juce::dsp::ProcessSpec &spec)
@@ -38,13 +39,16 @@ void InputNode::prepare(const juce::dsp::ProcessSpec &spec)
     // Prepare all processors in the chain
     gain.prepare(spec);
 
-    // Prepare the waveshaper
+    // Prepare the waveshaper. Only the re-blocker guarantees aligned blocks: host blocks can be shorter
+    // than their maximum or split at parameter events, so otherwise the FIFO (and its reported latency) is used
     updateFilterCoefficients();
+    blockAdapter.prepare(WaveshaperConfig::blockSize, blocksAligned);
 }
 
 void InputNode::reset()
 {
     gain.reset();
+    blockAdapter.reset();
 }
 
 template <typename ProcessContext>
@@ -160,26 +164,16 @@ void InputNode::updateFilterCoefficients()
     waveShaper->setFloatParam((int)MyShaperType::WaveShaperFloatParams::highpass, highpassPitch);
 }
 
-void InputNode::processWaveShaper(juce::dsp::AudioBlock<float> & buffer)
+void InputNode::processWaveShaper(juce::dsp::AudioBlock<float> &buffer)
 {
-    const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
-
     // Use a fixed note number for processing (key tracking not used here)
     const float noteNum = 0.0f;
 
-    // Process the audio through the waveshaper in blocks of WaveShaperConfig::blockSize
-    for (int pos = 0; pos < numSamples; pos += WaveshaperConfig::blockSize)
+    // Process the audio through the waveshaper in place, in blocks of WaveShaperConfig::blockSize
+    blockAdapter.process(buffer, [this, noteNum](float *leftChannel, float *rightChannel)
     {
-        if (numChannels >= 2)
-        {
-            auto curSubBlock = buffer.getSubBlock(pos, WaveshaperConfig::blockSize);
-            float *leftChannel = curSubBlock.getChannelPointer(0);
-            float *rightChannel = curSubBlock.getChannelPointer(1);
-
-            waveShaper->processStereo(leftChannel, rightChannel, leftChannel, rightChannel, noteNum);
-        }
-    }
+        waveShaper->processStereo(leftChannel, rightChannel, leftChannel, rightChannel, noteNum);
+    });
 }
 
 //==================================================
@@ -2,12 +2,16 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <sst/voice-effects/waveshaper/WaveShaper.h>
+#include "ControlScheduler.h"
+#include "BlockPool.h"
+#include "FixedBlockAdapter.h"
+#include "util/FastMath.h"
 
 /**
  * Audio processor that implements input gain and sculpting
  */
 class InputNode
-    : private juce::Timer
+    : private ControlTimer
 {
     public:
         struct Parameters
@@ -18,7 +22,7 @@ class InputNode
             float reverbMix;       // Reverb mix level (0.0 to 1.0)
         };
 
-        InputNode();
+        explicit InputNode(ControlScheduler &scheduler);
         ~InputNode();
 
         // processing functions
@@ -31,6 +35,12 @@ class InputNode
         void setParameters(const Parameters &params);
         void timerCallback();
 
+        // True when every block is a multiple of the waveshaper block size (applied on the next prepare())
+        void setBlocksAligned(bool aligned) { blocksAligned = aligned; }
+
+        // Latency of the waveshaper block FIFO, in samples
+        int getLatencySamples() const { return blockAdapter.getLatencySamples(); }
+
     private:
         float fs = 44100.0f;
 
@@ -59,6 +69,7 @@ class InputNode
             {
                 std::array<float, 256> fb{};
                 std::array<int, 256> ib{};
+                BlockPool pool;
             };
             static constexpr int blockSize{16};
             static void setFloatParam(BaseClass *b, int i, float f) { b->fb[i] = f; }
@@ -67,15 +78,15 @@ class InputNode
             static void setIntParam(BaseClass *b, int i, int v) { b->ib[i] = v; }
             static int getIntParam(const BaseClass *b, int i) { return b->ib[i]; }
 
-            static float dbToLinear(const BaseClass *, float db) { return std::pow(10, db / 20.0); }
-            static float equalNoteToPitch(const BaseClass *, float f) { return pow(2.f, (f + 69) / 12.f); }
+            static float dbToLinear(const BaseClass *, float db) { return FastMath::dbToGain(db, -std::numeric_limits<float>::infinity()); }
+            static float equalNoteToPitch(const BaseClass *, float f) { return FastMath::exp2((f + 69) / 12.f); }
             static float getSampleRate(const BaseClass *) { return 48000.f; }
             static float getSampleRateInv(const BaseClass *) { return 1.0 / 48000.f; }
 
-            static void preReservePool(BaseClass *, size_t) {}
-            static void preReserveSingleInstancePool(BaseClass *, size_t) {}
-            static uint8_t *checkoutBlock(BaseClass *, size_t) { return nullptr; }
-            static void returnBlock(BaseClass *, uint8_t *, size_t) {}
+            static void preReservePool(BaseClass *b, size_t n) { b->pool.reserve(n); }
+            static void preReserveSingleInstancePool(BaseClass *b, size_t n) { b->pool.reserve(n); }
+            static uint8_t *checkoutBlock(BaseClass *b, size_t n) { return b->pool.checkout(n); }
+            static void returnBlock(BaseClass *b, uint8_t *ptr, size_t n) { b->pool.giveBack(ptr, n); }
         };
 
         // Waveshaper implementation
@@ -83,6 +94,10 @@ class InputNode
         std::unique_ptr<MyShaperType> waveShaper;
         bool waveshaperBypass = false;
 
+        // Feeds the waveshaper in its own block size, straight from the block when it is aligned
+        bool blocksAligned = false;
+        FixedBlockAdapter blockAdapter;
+
         // Waveshaper filter
         void updateFilterCoefficients();
 
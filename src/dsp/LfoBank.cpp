@@ -0,0 +1,58 @@
+#include "LfoBank.h"
+#include "util/FastMath.h"
+
+void LfoBank::prepare(size_t newNumLfos, double updateRate)
+{
+    jassert(newNumLfos <= maxNumLfos);
+    numLfos = juce::jmin(newNumLfos, maxNumLfos);
+    numVectors = (numLfos + 3) / 4;
+    updatePeriod = static_cast<float>(1.0 / juce::jmax(1.0, updateRate));
+
+    increments.fill(0.0f);
+    reset();
+}
+
+void LfoBank::reset()
+{
+    phases.fill(0.0f);
+    evaluate();
+}
+
+void LfoBank::setPhase(size_t index, float phase)
+{
+    jassert(index < maxNumLfos);
+    phases[index] = phase - FastMath::floor(phase);
+    values[index] = FastMath::sinCycles(phases[index]);
+}
+
+void LfoBank::setFrequency(size_t index, float frequencyHz)
+{
+    jassert(index < maxNumLfos);
+    increments[index] = frequencyHz * updatePeriod;
+}
+
+void LfoBank::process(int numSteps)
+{
+    if (numSteps <= 0)
+    {
+        return;
+    }
+
+    const auto steps = SIMD_MM(set1_ps)(static_cast<float>(numSteps));
+    for (size_t v = 0; v < numVectors; ++v)
+    {
+        auto phase = SIMD_MM(load_ps)(phases.data() + 4 * v);
+        phase = SIMD_MM(add_ps)(phase, SIMD_MM(mul_ps)(steps, SIMD_MM(load_ps)(increments.data() + 4 * v)));
+        SIMD_MM(store_ps)(phases.data() + 4 * v, SIMD_MM(sub_ps)(phase, FastMath::floor(phase)));
+    }
+
+    evaluate();
+}
+
+void LfoBank::evaluate()
+{
+    for (size_t v = 0; v < numVectors; ++v)
+    {
+        SIMD_MM(store_ps)(values.data() + 4 * v, FastMath::sinCycles(SIMD_MM(load_ps)(phases.data() + 4 * v)));
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+/**
+ * A bank of sine LFOs stored as structure of arrays, so every LFO is stepped
+ * and evaluated in one SIMD pass at control rate instead of one oscillator per
+ * owner running at the audio rate.
+ *
+ * Phases are normalised (0-1) and can be set directly, the sine is a
+ * FastMath polynomial of the folded phase.
+ */
+class LfoBank
+{
+    public:
+        static constexpr size_t maxNumLfos = 64;
+
+        LfoBank() = default;
+
+        // updateRate is the number of process() steps per second (the sample rate over the control
+        // interval when stepped on every control tick), so frequencies are in Hz
+        void prepare(size_t numLfos, double updateRate);
+        void reset();
+
+        // Jump an LFO to a phase (0-1), without stepping it
+        void setPhase(size_t index, float phase);
+        void setFrequency(size_t index, float frequencyHz);
+
+        // Step every LFO by numSteps update periods and evaluate them
+        void process(int numSteps = 1);
+
+        // Output of an LFO after the last process() (-1 to 1)
+        float getValue(size_t index) const { return values[index]; }
+
+        size_t getNumLfos() const { return numLfos; }
+
+    private:
+        void evaluate();
+
+        size_t numLfos = 0;
+        size_t numVectors = 0;
+        float updatePeriod = 1.0f / 689.0f;
+
+        alignas(16) std::array<float, maxNumLfos> phases {};
+        alignas(16) std::array<float, maxNumLfos> increments {};
+        alignas(16) std::array<float, maxNumLfos> values {};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LfoBank)
+};
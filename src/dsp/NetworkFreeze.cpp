@@ -0,0 +1,240 @@
+#include "NetworkFreeze.h"
+#include "util/ParameterRanges.h"
+
+NetworkFreeze::NetworkFreeze() :
+    juce::Thread("Mycelia network freeze")
+{
+}
+
+NetworkFreeze::~NetworkFreeze()
+{
+    stopThread(2000);
+}
+
+void NetworkFreeze::prepare(const juce::dsp::ProcessSpec &spec, const DelayNodes &delayNodes)
+{
+    // A running render belongs to the previous configuration
+    stopThread(2000);
+
+    state = State::live;
+    freezeRequested = false;
+    captureRequested = false;
+    responseReady = false;
+    handoverSamplesRemaining = 0;
+
+    renderSpec.sampleRate = spec.sampleRate;
+    convolver.prepare(static_cast<int>(spec.numChannels));
+
+    convolutionArena.prepare(ParameterRanges::maxNutrientBands, static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    delayNodes.reserveTopologySnapshot(pendingSnapshot);
+
+    startThread(juce::Thread::Priority::low);
+}
+
+void NetworkFreeze::reset()
+{
+    convolver.reset();
+}
+
+bool NetworkFreeze::canStartCapture() const
+{
+    // The render thread writes into the convolver, which is only safe while it is not in use
+    return state.load() == State::live && !captureRequested.load();
+}
+
+void NetworkFreeze::startCapture(const DelayNodes &delayNodes)
+{
+    if (!canStartCapture())
+    {
+        return;
+    }
+
+    // The render thread only reads the snapshot while a capture is requested
+    delayNodes.getTopologySnapshot(pendingSnapshot);
+    capturedVersion = delayNodes.getTopologyVersion();
+
+    responseReady = false;
+    freezeRequested = true;
+    captureRequested = true;
+}
+
+void NetworkFreeze::requestThaw()
+{
+    freezeRequested = false;
+}
+
+void NetworkFreeze::run()
+{
+    while (!threadShouldExit())
+    {
+        if (captureRequested.load())
+        {
+            renderResponses();
+            captureRequested = false;
+        }
+        else
+        {
+            wait(capturePollIntervalMs);
+        }
+    }
+}
+
+void NetworkFreeze::renderResponses()
+{
+    const auto numBands = juce::jlimit(1, ParameterRanges::maxNutrientBands, pendingSnapshot.params.numColonies);
+    const auto responseLength = static_cast<int>(maxResponseSeconds * renderSpec.sampleRate);
+
+    // Render through a private copy of the network, without a growth timer
+    DelayNodes offlineNodes(static_cast<size_t>(numBands));
+    offlineNodes.prepare(renderSpec);
+
+    BufferArena renderArena;
+    renderArena.prepare(ParameterRanges::maxNutrientBands, 1, renderBlockSize);
+    auto renderBuffers = renderArena.getBuffers();
+
+    // One response per input band, with one channel per output band
+    std::vector<juce::AudioBuffer<float>> responses;
+    for (int in = 0; in < numBands; ++in)
+    {
+        juce::AudioBuffer<float> response(numBands, responseLength);
+        response.clear();
+
+        offlineNodes.reset();
+        offlineNodes.applyTopologySnapshot(pendingSnapshot);
+
+        for (int pos = 0; pos < responseLength; pos += renderBlockSize)
+        {
+            if (threadShouldExit())
+            {
+                return;
+            }
+
+            renderArena.clear();
+            if (pos == 0)
+            {
+                renderBuffers[in].setSample(0, 0, 1.0f);
+            }
+
+            offlineNodes.process(renderBuffers, renderBuffers);
+
+            const auto numSamples = juce::jmin(renderBlockSize, responseLength - pos);
+            for (int out = 0; out < numBands; ++out)
+            {
+                response.copyFrom(out, pos, renderBuffers[out], 0, 0, numSamples);
+            }
+        }
+
+        responses.push_back(std::move(response));
+    }
+
+    convolver.setImpulseResponses(responses, numBands, responseLength);
+    responseReady = true;
+}
+
+bool NetworkFreeze::isSilent(const DelayNodes &delayNodes) const
+{
+    const auto current = state.load();
+
+    // The live graph is not processed while frozen, so its sleep state is stale
+    const auto liveSilent = (current == State::frozen) || delayNodes.isSilent();
+    const auto convolutionSilent = (current == State::live) ||
+                                   (convolutionQuietSamples > convolver.getImpulseResponseLength());
+    return liveSilent && convolutionSilent;
+}
+
+void NetworkFreeze::copyBands(BufferSpan source, BufferSpan destination, int numBands)
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        juce::dsp::AudioBlock<float>(destination[band]).copyFrom(source[band]);
+    }
+}
+
+void NetworkFreeze::addBands(BufferSpan delayBandBuffers, int numBands)
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto &outputBuffer = delayBandBuffers[band];
+        for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+        {
+            outputBuffer.addFrom(ch, 0, convolutionArena.getBuffer(static_cast<size_t>(band)), ch, 0, outputBuffer.getNumSamples());
+        }
+    }
+}
+
+void NetworkFreeze::process(BufferSpan inputs, BufferSpan outputs, int numBands, DelayNodes &delayNodes)
+{
+    auto current = state.load();
+    const auto numSamples = inputs[0].getNumSamples();
+
+    // The convolution input follows the length of the block
+    convolutionArena.setNumSamples(numSamples);
+    auto convolutionBuffers = convolutionArena.getBuffers();
+
+    // Hand-overs start on block boundaries
+    if (current == State::live && freezeRequested && responseReady)
+    {
+        convolver.reset();
+        convolutionQuietSamples = 0;
+        handoverSamplesRemaining = convolver.getImpulseResponseLength();
+        current = State::freezing;
+    }
+    else if ((current == State::freezing || current == State::frozen) && !freezeRequested)
+    {
+        handoverSamplesRemaining = convolver.getImpulseResponseLength();
+        current = State::thawing;
+    }
+
+    // Track how long the convolution input has been quiet (it rings for the response length)
+    if (current != State::live)
+    {
+        auto isQuiet = true;
+        for (int band = 0; band < numBands && isQuiet; ++band)
+        {
+            isQuiet = inputs[band].getMagnitude(0, numSamples) <= silenceThreshold;
+        }
+        convolutionQuietSamples = isQuiet ? juce::jmin(convolutionQuietSamples + numSamples, 1 << 30) : 0;
+    }
+
+    switch (current)
+    {
+        case State::live:
+            delayNodes.process(inputs, outputs);
+            break;
+
+        case State::frozen:
+            convolver.process(inputs, outputs, numBands);
+            break;
+
+        case State::freezing:
+            // The convolution takes over the input, the live graph rings out on silence
+            copyBands(inputs, convolutionBuffers, numBands);
+            for (int band = 0; band < numBands; ++band)
+            {
+                outputs[band].clear();
+            }
+            delayNodes.process(outputs, outputs);
+            convolver.process(convolutionBuffers, numBands);
+            addBands(outputs, numBands);
+            break;
+
+        case State::thawing:
+            // The live graph takes the input back, the convolution rings out on silence
+            convolutionArena.clear();
+            convolver.process(convolutionBuffers, numBands);
+            delayNodes.process(inputs, outputs);
+            addBands(outputs, numBands);
+            break;
+    }
+
+    if (current == State::freezing || current == State::thawing)
+    {
+        handoverSamplesRemaining -= numSamples;
+        if (handoverSamplesRemaining <= 0)
+        {
+            current = (current == State::freezing) ? State::frozen : State::live;
+        }
+    }
+
+    state = current;
+}
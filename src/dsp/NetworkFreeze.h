@@ -0,0 +1,90 @@
+#pragma once
+
+#include "BufferArena.h"
+#include "DelayNodes.h"
+#include "PartitionedConvolver.h"
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * Replaces the live delay node graph with a partitioned convolution of its
+ * captured impulse response while the network is not growing.
+ *
+ * The response matrix (input band -> output band) is rendered offline from a
+ * snapshot of the topology, on a background thread. Hand-overs split the
+ * input at a sample boundary: the engine being switched off only receives
+ * silence and rings out, while the one being switched on gets the live
+ * input, so their sum is continuous for a linear network.
+ */
+class NetworkFreeze :
+    private juce::Thread
+{
+    public:
+        NetworkFreeze();
+        ~NetworkFreeze() override;
+
+        // Also sizes the snapshot storage for the topologies of delayNodes
+        void prepare(const juce::dsp::ProcessSpec &spec, const DelayNodes &delayNodes);
+        void reset();
+
+        // Timer callback: render the impulse response of the current topology. Neither allocates nor
+        // locks, as the timers run on the audio thread offline: the render thread picks the capture up
+        bool canStartCapture() const;
+        void startCapture(const DelayNodes &delayNodes);
+
+        // Message thread: hand the network back to the live graph
+        void requestThaw();
+
+        bool isFreezeRequested() const { return freezeRequested.load(); }
+        uint32_t getCapturedVersion() const { return capturedVersion.load(); }
+
+        // True when neither the live graph nor the convolution holds any energy
+        bool isSilent(const DelayNodes &delayNodes) const;
+
+        // Process the band buffers through the live graph, the convolution, or both while handing over
+        void process(BufferSpan inputs, BufferSpan outputs, int numBands, DelayNodes &delayNodes);
+
+    private:
+        enum class State
+        {
+            live,
+            freezing,
+            frozen,
+            thawing
+        };
+
+        // Longest impulse response captured from the network
+        static constexpr float maxResponseSeconds = 3.0f;
+        static constexpr int renderBlockSize = 512;
+
+        // The render thread runs from prepare on and polls for captures, as waking it would take a lock
+        static constexpr int capturePollIntervalMs = 50;
+        void run() override;
+        void renderResponses();
+
+        void copyBands(BufferSpan source, BufferSpan destination, int numBands);
+        void addBands(BufferSpan delayBandBuffers, int numBands);
+
+        PartitionedConvolver convolver;
+        juce::dsp::ProcessSpec renderSpec {44100.0, static_cast<juce::uint32>(renderBlockSize), 1};
+
+        // Snapshot handed to the render thread
+        DelayNodes::TopologySnapshot pendingSnapshot;
+
+        std::atomic<State> state {State::live};
+        std::atomic<bool> freezeRequested {false};
+        std::atomic<bool> captureRequested {false};    // Set until the render thread has rendered the snapshot
+        std::atomic<bool> responseReady {false};
+        std::atomic<uint32_t> capturedVersion {0};
+        int handoverSamplesRemaining = 0;
+
+        // Samples since the convolution last had input above -80 dB
+        static constexpr float silenceThreshold = 1.0e-4f;
+        int convolutionQuietSamples = 0;
+
+        // Input for the convolution while handing over
+        BufferArena convolutionArena;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NetworkFreeze)
+};
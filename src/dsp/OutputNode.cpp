@@ -1,35 +1,32 @@
 #include "OutputNode.h"
 #include "util/ParameterRanges.h"
 
-OutputNode::OutputNode()
-{
-    // Initialize the output nodes
-    for (auto *gain : {&wetGain, &dryGain})
-    {
-        gain->setRampDurationSeconds(0.05f);
-        gain->setGainLinear(0.0f);
-    }
-
-    tempBuffer = std::make_unique<juce::AudioBuffer<float>>();
+static_assert(SimdKernels::maxMixBands >= ParameterRanges::maxNutrientBands, "The mixing kernel must cover every band");
 
+OutputNode::OutputNode(ControlScheduler &scheduler) :
+    ControlTimer(&scheduler)
+{
     startTimerHz(2); // Start the timer for parameter updates
 }
 
 OutputNode::~OutputNode()
 {
-    // Clean up any resources
-    tempBuffer->clear();
+    stopTimer();
 }
 
 void OutputNode::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    prepare(spec, spec);
+}
+
+void OutputNode::prepare(const juce::dsp::ProcessSpec& spec, const juce::dsp::ProcessSpec& drySpec)
 {
     fs = (float) spec.sampleRate;
+    kernels = &SimdKernels::get();
 
-    // Prepare the gain modules
-    for (auto* gain : {&wetGain, &dryGain})
-    {
-        gain->prepare(spec);
-    }
+    // Prepare the gain ramps (the dry gain ramps at the rate of the dry path)
+    wetGain.reset(spec.sampleRate, gainRampSeconds);
+    dryGain.reset(drySpec.sampleRate, gainRampSeconds);
 
     // Prepare the ducking compressors
     for (auto& compressor : duckingCompressors)
@@ -47,9 +44,6 @@ void OutputNode::prepare(const juce::dsp::ProcessSpec& spec)
         follower.prepare(spec);
         follower.setParameters(envParams, true);
     }
-
-    // Initialize temporary buffer
-    tempBuffer = std::make_unique<juce::AudioBuffer<float>>(spec.numChannels, spec.maximumBlockSize);
 }
 
 void OutputNode::reset()
@@ -66,21 +60,16 @@ void OutputNode::reset()
         follower.reset();
     }
 
-    // Reset all gain modules
-    for (auto *gain : {&wetGain, &dryGain})
-    {
-        gain->reset();
-    }
-
-    // Clear temporary buffer
-    tempBuffer->clear();
+    // Jump the gain ramps to their targets
+    wetGain.setCurrentAndTargetValue(wetGainTarget.load());
+    dryGain.setCurrentAndTargetValue(dryGainTarget.load());
 }
 
 template <typename ProcessContext>
 void OutputNode::process(const ProcessContext &wetContext,
                          const ProcessContext &dryContext,
-                         std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &diffusionBandBuffers,
-                         std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &delayBandBuffers)
+                         BufferSpan diffusionBandBuffers,
+                         BufferSpan delayBandBuffers)
 {
     // Manage audio context
     const auto &inputDryBlock = dryContext.getInputBlock();
@@ -109,55 +98,96 @@ void OutputNode::process(const ProcessContext &wetContext,
         return;
     }
 
-    // Clear the wet context, as we will be adding to it
-    outputWetBlock.clear();
-
-    // Process each active band
-    for (int band = 0; band < inNumActiveBands; ++band)
-    {
-        // Get references to this band's buffers
-        auto& diffusionBuffer = diffusionBandBuffers[band];
-        juce::dsp::AudioBlock<float> diffusionBlock(*diffusionBuffer.get());
-        const auto& diffusionContext = juce::dsp::ProcessContextReplacing<float>(diffusionBlock);
-        const auto& delayBuffer = delayBandBuffers[band];
+    // Ducked bands, wet gain and dry mix in one pass
+    mixBands(outputWetBlock, &inputDryBlock, diffusionBandBuffers, delayBandBuffers);
+}
 
-        // Get the diffusion sample level using envelope follower
-        envelopeFollowers[band].process(diffusionContext);
+template <typename ProcessContext>
+void OutputNode::processBands(const ProcessContext &wetContext,
+                              BufferSpan diffusionBandBuffers,
+                              BufferSpan delayBandBuffers)
+{
+    mixBands(wetContext.getOutputBlock(), nullptr, diffusionBandBuffers, delayBandBuffers);
+}
 
-        // Process each channel
-        for (int channel = 0; channel < numWetChannels; ++channel)
+template <typename ProcessContext>
+void OutputNode::mixDry(const ProcessContext &wetContext, const ProcessContext &dryContext)
+{
+    auto &wetBlock = wetContext.getOutputBlock();
+    const auto &dryBlock = dryContext.getInputBlock();
+    const auto numSamples = static_cast<int>(wetBlock.getNumSamples());
+
+    // Add the dry signal along its gain ramp
+    dryGain.setTargetValue(dryGainTarget.load());
+    const auto dryRamp = getNextRamp(dryGain, numSamples);
+    for (size_t ch = 0; ch < wetBlock.getNumChannels(); ++ch)
+    {
+        auto *wetData = wetBlock.getChannelPointer(ch);
+        const auto *dryData = dryBlock.getChannelPointer(ch);
+        for (int i = 0; i < numSamples; ++i)
         {
-            float diffusionLevel = useExternalSidechain ? envelopeFollowers[band].getAverageLevel(channel) : 0.0f;
-            // Get raw pointers to data
-            const float* diffusionData = diffusionBandBuffers[band]->getReadPointer(channel);
-            const float* delayData = delayBandBuffers[band]->getReadPointer(channel);
-            float* outputData = tempBuffer->getWritePointer(channel);
-
-            // Process each sample
-            for (int sample = 0; sample < numWetSamples; ++sample)
-            {
-                // Use diffusion signal level as sidechain input to compress the delay signal
-                outputData[sample] = duckingCompressors[band].processSample(delayData[sample], diffusionLevel, channel);
-
-                // outputData[sample] = delayData[sample];
-            }
+            wetData[i] += dryData[i] * (dryRamp.start + dryRamp.step * static_cast<float>(i));
         }
+    }
+}
 
-        // Add the processed band to the output
-        juce::dsp::AudioBlock<float> tempBlock(*tempBuffer);
-        outputWetBlock.add(tempBlock);
+void OutputNode::mixBands(const juce::dsp::AudioBlock<float> &wetBlock,
+                          const juce::dsp::AudioBlock<const float> *dryBlock,
+                          BufferSpan diffusionBandBuffers,
+                          BufferSpan delayBandBuffers)
+{
+    const auto numChannels = wetBlock.getNumChannels();
+    const auto numSamples = static_cast<int>(wetBlock.getNumSamples());
+    const auto numBands = juce::jlimit(0, static_cast<int>(delayBandBuffers.size()), inNumActiveBands);
+
+    // Follow the diffusion levels (the ducking sidechains) over the whole block
+    for (int band = 0; band < numBands; ++band)
+    {
+        envelopeFollowers[band].analyse(juce::dsp::AudioBlock<float>(diffusionBandBuffers[band]));
     }
 
-    // Apply wet gain to the output
-    wetGain.process(wetContext);
+    // Gain ramps for the whole block
+    wetGain.setTargetValue(wetGainTarget.load());
+    const auto wetRamp = getNextRamp(wetGain, numSamples);
+    auto dryRamp = DuckingCompressor::GainRamp {};
+    if (dryBlock != nullptr)
+    {
+        dryGain.setTargetValue(dryGainTarget.load());
+        dryRamp = getNextRamp(dryGain, numSamples);
+    }
 
-    dryGain.process(dryContext);
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        const auto channel = static_cast<int>(ch);
 
-    // Mix the wet and dry signals
-    auto wetBlock = wetContext.getOutputBlock();
-    auto dryBlock = dryContext.getOutputBlock();
+        // The sidechain level is constant over the block, so each band's ducking is a ramp too
+        std::array<const float *, ParameterRanges::maxNutrientBands> bandData {};
+        std::array<DuckingCompressor::GainRamp, ParameterRanges::maxNutrientBands> duckRamps {};
+        for (int band = 0; band < numBands; ++band)
+        {
+            const auto diffusionLevel = useExternalSidechain ? envelopeFollowers[band].getAverageLevel(channel) : 0.0f;
+            bandData[band] = delayBandBuffers[band].getReadPointer(channel);
+            duckRamps[band] = duckingCompressors[band].getGainRamp(diffusionLevel, ch, numSamples);
+        }
 
-    wetBlock.replaceWithSumOf(wetBlock, dryBlock);
+        auto *outputData = wetBlock.getChannelPointer(ch);
+        const auto *dryData = (dryBlock != nullptr) ? dryBlock->getChannelPointer(ch) : nullptr;
+
+        kernels->mixRamped(outputData, bandData.data(), duckRamps.data(), numBands, wetRamp, dryData, dryRamp, numSamples);
+    }
+}
+
+DuckingCompressor::GainRamp OutputNode::getNextRamp(juce::SmoothedValue<float> &gain, int numSamples)
+{
+    if (numSamples <= 0)
+    {
+        return {gain.getCurrentValue(), 0.0f};
+    }
+
+    // The gain moves linearly, apart from a ramp that ends inside the block
+    const auto previous = gain.getCurrentValue();
+    const auto step = (gain.skip(numSamples) - previous) / static_cast<float>(numSamples);
+    return {previous + step, step};
 }
 
 void OutputNode::setParameters(const Parameters &params)
@@ -172,7 +202,7 @@ void OutputNode::setParameters(const Parameters &params)
         duckingChanged = true;
     }
 
-    auto tempWetGain = ParameterRanges::normalizeParameter(ParameterRanges::dryWetRange, params.dryWetMixLevel);
+    auto tempWetGain = ParameterRanges::dryWetMapping.normalise(params.dryWetMixLevel);
     if ((std::abs(inDryWetMixLevel - tempWetGain) / tempWetGain) > 0.01f)
     {
         // Convert to 0-1 range
@@ -202,16 +232,16 @@ void OutputNode::timerCallback()
 {
     if (gainChanged)
     {
-        // Set the gain for the wet and dry signals (linear gain)
-        wetGain.setGainLinear(inDryWetMixLevel);
-        dryGain.setGainLinear(1.0f - inDryWetMixLevel);
+        // Set the gain for the wet and dry signals (linear gain), picked up by the next block
+        wetGainTarget = inDryWetMixLevel;
+        dryGainTarget = 1.0f - inDryWetMixLevel;
         gainChanged = false;
     }
 
     if (duckingChanged)
     {
         // Calculate the compression threshold and ratio based on the delay ducking value
-        auto normalizedDuckValue = ParameterRanges::normalizeParameter(ParameterRanges::delayDuckRange, inDelayDuckLevel);
+        auto normalizedDuckValue = ParameterRanges::delayDuckMapping.normalise(inDelayDuckLevel);
 
         compressorParams.threshold = -12.0f * (4 * normalizedDuckValue);
         compressorParams.ratio = 1.0f + 7.0f * normalizedDuckValue;
@@ -239,10 +269,17 @@ void OutputNode::timerCallback()
 template void OutputNode::process<juce::dsp::ProcessContextReplacing<float>>(
     const juce::dsp::ProcessContextReplacing<float> &,
     const juce::dsp::ProcessContextReplacing<float> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
+    BufferSpan,
+    BufferSpan);
 template void OutputNode::process<juce::dsp::ProcessContextNonReplacing<float>>(
     const juce::dsp::ProcessContextNonReplacing<float> &,
     const juce::dsp::ProcessContextNonReplacing<float> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &,
-    std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &);
+    BufferSpan,
+    BufferSpan);
+template void OutputNode::processBands<juce::dsp::ProcessContextReplacing<float>>(
+    const juce::dsp::ProcessContextReplacing<float> &,
+    BufferSpan,
+    BufferSpan);
+template void OutputNode::mixDry<juce::dsp::ProcessContextReplacing<float>>(
+    const juce::dsp::ProcessContextReplacing<float> &,
+    const juce::dsp::ProcessContextReplacing<float> &);
@@ -2,16 +2,19 @@
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "EnvelopeFollower.h"
+#include "ControlScheduler.h"
+#include "BufferArena.h"
 #include "DuckingCompressor.h"
 #include "util/ParameterRanges.h"
 #include <array>
+#include <atomic>
 
 /**
  * OutputNode - Handles per-band ducking compression where diffusion bands
  * act as sidechain signals for compressing corresponding delay bands.
  */
 class OutputNode
-    : private juce::Timer
+    : private ControlTimer
 {
     public:
         // Parameters
@@ -26,25 +29,51 @@ class OutputNode
             EnvelopeFollower::Parameters envelopeFollowerParams;
         };
 
-        OutputNode();
+        explicit OutputNode(ControlScheduler &scheduler);
         ~OutputNode();
 
         // Processing functions
         void prepare(const juce::dsp::ProcessSpec &spec);
+        // Prepare with the dry path running at a different (host) rate than the bands
+        void prepare(const juce::dsp::ProcessSpec &spec, const juce::dsp::ProcessSpec &drySpec);
         void reset();
 
         template <typename ProcessContext>
         void process(
             const ProcessContext &wetContext,
             const ProcessContext &dryContext,
-            std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &diffusionBandBuffers,
-            std::vector<std::unique_ptr<juce::AudioBuffer<float>>> &delayBandBuffers);
+            BufferSpan diffusionBandBuffers,
+            BufferSpan delayBandBuffers);
+
+        // Sum the ducked bands into the wet context and apply the wet gain
+        template <typename ProcessContext>
+        void processBands(
+            const ProcessContext &wetContext,
+            BufferSpan diffusionBandBuffers,
+            BufferSpan delayBandBuffers);
+
+        // Apply the dry gain and add the dry context into the wet context
+        template <typename ProcessContext>
+        void mixDry(const ProcessContext &wetContext, const ProcessContext &dryContext);
 
         void setParameters(const Parameters &params);
 
     private:
         void timerCallback();
 
+        // Sum the ducked bands into the wet block along the wet gain ramp, adding the dry block
+        // along the dry gain ramp when given (one pass over the output)
+        void mixBands(const juce::dsp::AudioBlock<float> &wetBlock,
+                      const juce::dsp::AudioBlock<const float> *dryBlock,
+                      BufferSpan diffusionBandBuffers,
+                      BufferSpan delayBandBuffers);
+
+        // Mixing kernels for the CPU (taken in prepare)
+        const SimdKernels::Table *kernels = &SimdKernels::get();
+
+        // The next block of a gain ramp
+        static DuckingCompressor::GainRamp getNextRamp(juce::SmoothedValue<float> &gain, int numSamples);
+
         float fs = 44100.0f;
 
         float inDryWetMixLevel;
@@ -54,8 +83,12 @@ class OutputNode
         bool duckingChanged = false;
         bool envelopeFollowerChanged = false;
 
-        juce::dsp::Gain<float> wetGain;
-        juce::dsp::Gain<float> dryGain;
+        // Wet and dry gains, set by the timer and ramped on the audio thread
+        static constexpr double gainRampSeconds = 0.05;
+        std::atomic<float> wetGainTarget {0.0f};
+        std::atomic<float> dryGainTarget {0.0f};
+        juce::SmoothedValue<float> wetGain;
+        juce::SmoothedValue<float> dryGain;
 
         // Parameters
         int inNumActiveBands = 4;
@@ -84,8 +117,5 @@ class OutputNode
         std::array<EnvelopeFollower, ParameterRanges::maxNutrientBands> envelopeFollowers;
         std::array<DuckingCompressor, ParameterRanges::maxNutrientBands> duckingCompressors;
 
-        // Temporary buffers
-        std::unique_ptr<juce::AudioBuffer<float>> tempBuffer;
-
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputNode)
 };
@@ -0,0 +1,382 @@
+#include "PartitionedConvolver.h"
+
+namespace
+{
+    // acc += a * b for interleaved complex spectra
+    inline void complexMultiplyAccumulate(float *acc, const float *a, const float *b, int numBins)
+    {
+        for (int k = 0; k < 2 * numBins; k += 2)
+        {
+            acc[k] += a[k] * b[k] - a[k + 1] * b[k + 1];
+            acc[k + 1] += a[k] * b[k + 1] + a[k + 1] * b[k];
+        }
+    }
+
+    // Responses below this level (relative to the peak) are considered silent (-80 dB)
+    constexpr float silenceThreshold = 1.0e-4f;
+}
+
+PartitionedConvolver::PartitionedConvolver()
+{
+    fftBuffer.resize(2 * fftSize, 0.0f);
+    outputSpectrum.resize(spectrumSize, 0.0f);
+    kernels.resize(maxBands * maxBands);
+}
+
+void PartitionedConvolver::prepare(int newNumChannels)
+{
+    numChannels = juce::jmax(1, newNumChannels);
+
+    // Drop any loaded responses, the state layout depends on the channel count
+    numActiveBands = 0;
+    numPartitions = 0;
+    for (auto &kernel : kernels)
+    {
+        kernel.head.clear();
+        kernel.headPartitions.clear();
+        kernel.headSpectra.clear();
+        kernel.partitions.clear();
+        kernel.spectra.clear();
+    }
+    headInputSpectra.clear();
+    headBlockOutputs.clear();
+    headOverlaps.clear();
+    inputSpectra.clear();
+    inputHistories.clear();
+    blockOutputs.clear();
+    overlaps.clear();
+}
+
+void PartitionedConvolver::reset()
+{
+    for (auto *state : { &headInputSpectra, &headBlockOutputs, &headOverlaps, &inputSpectra, &inputHistories, &blockOutputs, &overlaps })
+    {
+        for (auto &band : *state)
+        {
+            for (auto &channel : band)
+            {
+                std::fill(channel.begin(), channel.end(), 0.0f);
+            }
+        }
+    }
+
+    currentHeadPartition = 0;
+    currentPartition = 0;
+    inputPos = 0;
+}
+
+void PartitionedConvolver::setImpulseResponses(const std::vector<juce::AudioBuffer<float>> &responses, int numBands, int irLength)
+{
+    numActiveBands = juce::jlimit(0, maxBands, juce::jmin(numBands, static_cast<int>(responses.size())));
+
+    // Trim the silent tail shared by all responses
+    float peak = 0.0f;
+    for (int in = 0; in < numActiveBands; ++in)
+    {
+        for (int out = 0; out < juce::jmin(numActiveBands, responses[in].getNumChannels()); ++out)
+        {
+            peak = juce::jmax(peak, responses[in].getMagnitude(out, 0, juce::jmin(irLength, responses[in].getNumSamples())));
+        }
+    }
+    const auto threshold = peak * silenceThreshold;
+
+    int length = 0;
+    for (int in = 0; in < numActiveBands; ++in)
+    {
+        for (int out = 0; out < juce::jmin(numActiveBands, responses[in].getNumChannels()); ++out)
+        {
+            const auto *data = responses[in].getReadPointer(out);
+            for (int i = juce::jmin(irLength, responses[in].getNumSamples()) - 1; i >= length; --i)
+            {
+                if (std::abs(data[i]) > threshold)
+                {
+                    length = i + 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    numPartitions = (length + partitionSize - 1) / partitionSize;
+    if (peak <= 0.0f)
+    {
+        numPartitions = 0;
+    }
+
+    // Keep the taps of the first head partition that carry energy, and transform every later (head) partition that does
+    for (int in = 0; in < maxBands; ++in)
+    {
+        for (int out = 0; out < maxBands; ++out)
+        {
+            auto &kernel = getKernel(in, out);
+            kernel.head.clear();
+            kernel.headPartitions.clear();
+            kernel.headSpectra.clear();
+            kernel.partitions.clear();
+            kernel.spectra.clear();
+
+            if (in >= numActiveBands || out >= numActiveBands || out >= responses[in].getNumChannels())
+            {
+                continue;
+            }
+
+            const auto *data = responses[in].getReadPointer(out);
+            const auto available = juce::jmin(length, responses[in].getNumSamples());
+            for (int i = 0; i < juce::jmin(headSize, available); ++i)
+            {
+                if (std::abs(data[i]) > threshold)
+                {
+                    kernel.head.push_back({i, data[i]});
+                }
+            }
+
+            auto hasEnergy = [&](int start, int numSamples)
+            {
+                return numSamples > 0 &&
+                       (juce::FloatVectorOperations::findMaximum(data + start, numSamples) > threshold ||
+                        juce::FloatVectorOperations::findMinimum(data + start, numSamples) < -threshold);
+            };
+
+            for (int p = 1; p < numHeadPartitions; ++p)
+            {
+                const auto start = p * headSize;
+                const auto numSamples = juce::jmin(headSize, available - start);
+                if (!hasEnergy(start, numSamples))
+                {
+                    continue;
+                }
+
+                kernel.headPartitions.push_back(p);
+                kernel.headSpectra.resize(kernel.headPartitions.size() * headSpectrumSize);
+                forwardTransform(headFft, data + start, numSamples, kernel.headSpectra.data() + (kernel.headPartitions.size() - 1) * headSpectrumSize);
+            }
+
+            for (int p = 1; p < numPartitions; ++p)
+            {
+                const auto start = p * partitionSize;
+                const auto numSamples = juce::jmin(partitionSize, available - start);
+                if (!hasEnergy(start, numSamples))
+                {
+                    continue;
+                }
+
+                kernel.partitions.push_back(p);
+                kernel.spectra.resize(kernel.partitions.size() * spectrumSize);
+                forwardTransform(fft, data + start, numSamples, kernel.spectra.data() + (kernel.partitions.size() - 1) * spectrumSize);
+            }
+        }
+    }
+
+    // Size the processing state for the new responses
+    const auto numSpectra = static_cast<size_t>(juce::jmax(1, numPartitions));
+    headInputSpectra.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(numHeadPartitions * headSpectrumSize, 0.0f)));
+    headBlockOutputs.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(headSize, 0.0f)));
+    headOverlaps.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(headSize, 0.0f)));
+    inputSpectra.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(numSpectra * spectrumSize, 0.0f)));
+    inputHistories.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(2 * partitionSize, 0.0f)));
+    blockOutputs.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(partitionSize, 0.0f)));
+    overlaps.assign(numActiveBands, std::vector<std::vector<float>>(numChannels, std::vector<float>(partitionSize, 0.0f)));
+
+    reset();
+}
+
+void PartitionedConvolver::forwardTransform(juce::dsp::FFT &transform, const float *source, int numSamples, float *spectrum)
+{
+    const auto size = transform.getSize();
+    std::fill(fftBuffer.begin(), fftBuffer.begin() + 2 * size, 0.0f);
+    std::copy(source, source + numSamples, fftBuffer.begin());
+    transform.performRealOnlyForwardTransform(fftBuffer.data(), true);
+    std::copy(fftBuffer.begin(), fftBuffer.begin() + size + 2, spectrum);
+}
+
+void PartitionedConvolver::inverseTransform(juce::dsp::FFT &transform, const float *spectrum)
+{
+    const auto size = transform.getSize();
+    std::copy(spectrum, spectrum + size + 2, fftBuffer.begin());
+
+    // Rebuild the negative frequencies from the conjugate symmetry of a real signal
+    for (int k = 1; k < size / 2; ++k)
+    {
+        fftBuffer[2 * (size - k)] = spectrum[2 * k];
+        fftBuffer[2 * (size - k) + 1] = -spectrum[2 * k + 1];
+    }
+
+    transform.performRealOnlyInverseTransform(fftBuffer.data());
+}
+
+void PartitionedConvolver::processCompletedHeadBlock(int blockStart)
+{
+    // Move the completed head block into its frequency-domain delay line
+    currentHeadPartition = (currentHeadPartition + 1) % numHeadPartitions;
+    for (int in = 0; in < numActiveBands; ++in)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            forwardTransform(headFft, inputHistories[in][ch].data() + partitionSize + blockStart, headSize,
+                             headInputSpectra[in][ch].data() + currentHeadPartition * headSpectrumSize);
+        }
+    }
+
+    // Head partition p applies to the head block completed p - 1 head blocks ago
+    for (int out = 0; out < numActiveBands; ++out)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            std::fill(outputSpectrum.begin(), outputSpectrum.begin() + headSpectrumSize, 0.0f);
+            auto hasEnergy = false;
+            for (int in = 0; in < numActiveBands; ++in)
+            {
+                const auto &kernel = getKernel(in, out);
+                for (size_t k = 0; k < kernel.headPartitions.size(); ++k)
+                {
+                    const auto slot = (currentHeadPartition - kernel.headPartitions[k] + 1 + numHeadPartitions) % numHeadPartitions;
+                    complexMultiplyAccumulate(outputSpectrum.data(),
+                                              kernel.headSpectra.data() + k * headSpectrumSize,
+                                              headInputSpectra[in][ch].data() + slot * headSpectrumSize,
+                                              headNumBins);
+                    hasEnergy = true;
+                }
+            }
+
+            auto &blockOutput = headBlockOutputs[out][ch];
+            auto &overlap = headOverlaps[out][ch];
+            if (!hasEnergy)
+            {
+                std::copy(overlap.begin(), overlap.end(), blockOutput.begin());
+                std::fill(overlap.begin(), overlap.end(), 0.0f);
+                continue;
+            }
+
+            // The first half completes the next head block, the second half overlaps the one after it
+            inverseTransform(headFft, outputSpectrum.data());
+            for (int i = 0; i < headSize; ++i)
+            {
+                blockOutput[i] = fftBuffer[i] + overlap[i];
+            }
+            std::copy(fftBuffer.begin() + headSize, fftBuffer.begin() + 2 * headSize, overlap.begin());
+        }
+    }
+}
+
+void PartitionedConvolver::processCompletedBlock()
+{
+    // Move the completed block into the frequency-domain delay line, and make room for the next one
+    currentPartition = (currentPartition + 1) % numPartitions;
+    for (int in = 0; in < numActiveBands; ++in)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto &history = inputHistories[in][ch];
+            forwardTransform(fft, history.data() + partitionSize, partitionSize, inputSpectra[in][ch].data() + currentPartition * spectrumSize);
+            std::copy(history.begin() + partitionSize, history.end(), history.begin());
+            std::fill(history.begin() + partitionSize, history.end(), 0.0f);
+        }
+    }
+
+    // Partition p applies to the block completed p - 1 blocks ago
+    for (int out = 0; out < numActiveBands; ++out)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            std::fill(outputSpectrum.begin(), outputSpectrum.end(), 0.0f);
+            auto hasEnergy = false;
+            for (int in = 0; in < numActiveBands; ++in)
+            {
+                const auto &kernel = getKernel(in, out);
+                for (size_t k = 0; k < kernel.partitions.size(); ++k)
+                {
+                    const auto slot = (currentPartition - kernel.partitions[k] + 1 + numPartitions) % numPartitions;
+                    complexMultiplyAccumulate(outputSpectrum.data(),
+                                              kernel.spectra.data() + k * spectrumSize,
+                                              inputSpectra[in][ch].data() + slot * spectrumSize,
+                                              numBins);
+                    hasEnergy = true;
+                }
+            }
+
+            auto &blockOutput = blockOutputs[out][ch];
+            auto &overlap = overlaps[out][ch];
+            if (!hasEnergy)
+            {
+                std::copy(overlap.begin(), overlap.end(), blockOutput.begin());
+                std::fill(overlap.begin(), overlap.end(), 0.0f);
+                continue;
+            }
+
+            // The first half completes the next block, the second half overlaps the one after it
+            inverseTransform(fft, outputSpectrum.data());
+            for (int i = 0; i < partitionSize; ++i)
+            {
+                blockOutput[i] = fftBuffer[i] + overlap[i];
+            }
+            std::copy(fftBuffer.begin() + partitionSize, fftBuffer.begin() + 2 * partitionSize, overlap.begin());
+        }
+    }
+}
+
+void PartitionedConvolver::process(BufferSpan inputs, BufferSpan outputs, int numBands)
+{
+    numBands = juce::jmin(numBands, numActiveBands, static_cast<int>(juce::jmin(inputs.size(), outputs.size())));
+    if (numPartitions == 0 || numBands == 0)
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            outputs[band].clear();
+        }
+        return;
+    }
+
+    const auto numSamples = inputs[0].getNumSamples();
+    const auto numCh = juce::jmin(numChannels, inputs[0].getNumChannels(), outputs[0].getNumChannels());
+
+    int done = 0;
+    while (done < numSamples)
+    {
+        const auto headPos = inputPos % headSize;
+        const auto num = juce::jmin(numSamples - done, headSize - headPos);
+
+        // Append the new input of every band before writing any output, the buffers may be shared
+        for (int in = 0; in < numBands; ++in)
+        {
+            for (int ch = 0; ch < numCh; ++ch)
+            {
+                const auto *src = inputs[in].getReadPointer(ch, done);
+                std::copy(src, src + num, inputHistories[in][ch].begin() + partitionSize + inputPos);
+            }
+        }
+
+        // The later (head) partitions were computed when the previous (head) block completed, add the direct taps on top
+        for (int out = 0; out < numBands; ++out)
+        {
+            for (int ch = 0; ch < numCh; ++ch)
+            {
+                auto *dst = outputs[out].getWritePointer(ch, done);
+                std::copy(blockOutputs[out][ch].begin() + inputPos, blockOutputs[out][ch].begin() + inputPos + num, dst);
+                juce::FloatVectorOperations::add(dst, headBlockOutputs[out][ch].data() + headPos, num);
+
+                for (int in = 0; in < numBands; ++in)
+                {
+                    const auto *current = inputHistories[in][ch].data() + partitionSize + inputPos;
+                    for (const auto &tap : getKernel(in, out).head)
+                    {
+                        juce::FloatVectorOperations::addWithMultiply(dst, current - tap.delay, tap.gain, num);
+                    }
+                }
+            }
+        }
+
+        inputPos += num;
+        done += num;
+
+        if (inputPos % headSize == 0)
+        {
+            processCompletedHeadBlock(inputPos - headSize);
+        }
+
+        if (inputPos == partitionSize)
+        {
+            inputPos = 0;
+            processCompletedBlock();
+        }
+    }
+}
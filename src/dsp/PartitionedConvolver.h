@@ -0,0 +1,121 @@
+#pragma once
+
+#include "BufferArena.h"
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/**
+ * Partitioned FFT convolution of a matrix of impulse responses
+ * (input band -> output band), applied identically to every channel.
+ *
+ * The engine adds no latency. The first headSize taps of each response are
+ * applied in direct form, sample by sample, from the taps that carry energy.
+ * The rest of the first partition runs in short head partitions, transformed
+ * once per completed head block, so the direct form stays cheap. The later
+ * partitions only need input that is at least one partition old, so they are
+ * transformed, accumulated and transformed back once per completed block.
+ * Partitions that carry no energy are skipped entirely.
+ */
+class PartitionedConvolver
+{
+    public:
+        static constexpr int partitionSize = 512;
+        static constexpr int headSize = 64;
+
+        PartitionedConvolver();
+
+        void prepare(int numChannels);
+        void reset();
+
+        // Build the partitions from responses[inputBand], whose channel j holds the response of output band j.
+        // Allocates: only call while the convolver is not being processed.
+        void setImpulseResponses(const std::vector<juce::AudioBuffer<float>> &responses, int numBands, int irLength);
+
+        // Length of the loaded responses in samples (a multiple of the partition size), 0 when empty
+        int getImpulseResponseLength() const { return numPartitions * partitionSize; }
+
+        // Convolve the band buffers in place
+        void process(BufferSpan bandBuffers, int numBands) { process(bandBuffers, bandBuffers, numBands); }
+
+        // Convolve the input bands into the output bands (which may be the same buffers)
+        void process(BufferSpan inputs, BufferSpan outputs, int numBands);
+
+    private:
+        static constexpr int fftOrder = 10; // 2 * partitionSize
+        static constexpr int fftSize = 1 << fftOrder;
+        static constexpr int numBins = fftSize / 2 + 1;
+        static constexpr int spectrumSize = 2 * numBins; // Interleaved real/imaginary
+
+        static constexpr int headFftOrder = 7; // 2 * headSize
+        static constexpr int headFftSize = 1 << headFftOrder;
+        static constexpr int headNumBins = headFftSize / 2 + 1;
+        static constexpr int headSpectrumSize = 2 * headNumBins;
+        static constexpr int numHeadPartitions = partitionSize / headSize;
+
+        // A tap of the direct-form head: output[i] += gain * input[i - delay]
+        struct HeadTap
+        {
+            int delay;
+            float gain;
+        };
+
+        struct PairKernel
+        {
+            std::vector<HeadTap> head;        // Taps of the first head partition with energy
+            std::vector<int> headPartitions;  // Indices of the later head partitions (in the first partition) with energy
+            std::vector<float> headSpectra;   // One spectrum per entry in headPartitions
+            std::vector<int> partitions;      // Indices of the later partitions with energy
+            std::vector<float> spectra;       // One spectrum per entry in partitions
+        };
+
+        // Transform numSamples (up to half the transform size) samples of source, zero padded
+        void forwardTransform(juce::dsp::FFT &transform, const float *source, int numSamples, float *spectrum);
+
+        // Inverse transform a half spectrum into fftBuffer
+        void inverseTransform(juce::dsp::FFT &transform, const float *spectrum);
+
+        // Transform the completed head block at blockStart of the current block, and compute the output
+        // of the later head partitions for the next head block
+        void processCompletedHeadBlock(int blockStart);
+
+        // Transform the completed input block and compute the output of the later partitions for the next block
+        void processCompletedBlock();
+
+        PairKernel &getKernel(int inputBand, int outputBand) { return kernels[inputBand * maxBands + outputBand]; }
+
+        static constexpr int maxBands = 4;
+
+        juce::dsp::FFT fft { fftOrder };
+        juce::dsp::FFT headFft { headFftOrder };
+
+        int numChannels = 2;
+        int numActiveBands = 0;
+        int numPartitions = 0;
+        std::vector<PairKernel> kernels;
+
+        // Frequency-domain delay line of the completed blocks, [band][channel] -> numPartitions spectra
+        std::vector<std::vector<std::vector<float>>> inputSpectra;
+        int currentPartition = 0;
+
+        // Frequency-domain delay line of the completed head blocks, [band][channel] -> numHeadPartitions spectra
+        std::vector<std::vector<std::vector<float>>> headInputSpectra;
+        int currentHeadPartition = 0;
+
+        // Output of the later head partitions for the current head block, and what they add to the next one, [band][channel]
+        std::vector<std::vector<std::vector<float>>> headBlockOutputs;
+        std::vector<std::vector<std::vector<float>>> headOverlaps;
+
+        // The previous and the current (partially filled) input block, [band][channel] -> 2 * partitionSize
+        std::vector<std::vector<std::vector<float>>> inputHistories;
+        int inputPos = 0;
+
+        // Output of the later partitions for the current block, and what they add to the next one, [band][channel]
+        std::vector<std::vector<std::vector<float>>> blockOutputs;
+        std::vector<std::vector<std::vector<float>>> overlaps;
+
+        // Scratch
+        std::vector<float> fftBuffer;
+        std::vector<float> outputSpectrum;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PartitionedConvolver)
+};
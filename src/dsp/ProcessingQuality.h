@@ -0,0 +1,53 @@
+#pragma once
+
+#include "VariableDelay.h"
+#include <stddef.h>
+
+// Quality presets, from the leanest to the full processing path
+enum class QualityTier
+{
+    eco,
+    standard,
+    high
+};
+
+/**
+ * The processing shortcuts the network can take to save CPU time.
+ * Default values give the full quality.
+ */
+struct ProcessingQuality
+{
+    size_t maxDispersionStages = 10;                                            // Allpass stages run by each Dispersion
+    VariableDelay::Interpolation delayInterpolation = VariableDelay::Interpolation::lagrange3rd;
+    int envelopeStride = 1;                                                     // Analyse every Nth sample for the envelopes
+    int maxActiveTrees = 8;                                                     // Trees (and the nodes feeding them) that are processed
+
+    // Only applied when the processors are prepared
+    bool steepDiffusionFilters = true;                                          // 24 dB/oct band filters, 12 dB/oct otherwise
+    bool fineReverbBlocks = true;                                               // Sky reverb control blocks of 16 samples, 32 otherwise
+
+    static ProcessingQuality forTier(QualityTier tier)
+    {
+        ProcessingQuality quality;
+        switch (tier)
+        {
+            case QualityTier::high:
+                break;
+
+            case QualityTier::standard:
+                quality.maxDispersionStages = 4;
+                quality.envelopeStride = 2;
+                quality.fineReverbBlocks = false;
+                break;
+
+            case QualityTier::eco:
+                quality.maxDispersionStages = 0;
+                quality.delayInterpolation = VariableDelay::Interpolation::linear;
+                quality.envelopeStride = 8;
+                quality.steepDiffusionFilters = false;
+                quality.fineReverbBlocks = false;
+                break;
+        }
+        return quality;
+    }
+};
@@ -0,0 +1,107 @@
+#include "QualityGovernor.h"
+#include "util/FastMath.h"
+
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    smoothedLoad = 0.0f;
+    samplesSinceChange = 0;
+    samplesBelowRestore = 0;
+    restoreSeconds = minRestoreSeconds;
+    qualityLevel = 0;
+    currentLoad = 0.0f;
+}
+
+void QualityGovernor::blockProcessed(juce::int64 startTicks, int numSamples)
+{
+    if (!enabled || numSamples <= 0)
+    {
+        return;
+    }
+
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const auto blockSeconds = numSamples / sampleRate;
+    const auto load = static_cast<float>(elapsedSeconds / blockSeconds);
+
+    // Smooth over a fixed time, whatever the block size
+    const auto alpha = 1.0f - FastMath::exp(-static_cast<float>(blockSeconds) / loadTimeSeconds);
+    smoothedLoad += alpha * (load - smoothedLoad);
+    currentLoad = smoothedLoad;
+
+    samplesSinceChange = juce::jmin(samplesSinceChange + numSamples, 1 << 30);
+    const auto settled = samplesSinceChange >= static_cast<int>(settleSeconds * sampleRate);
+
+    // A missed deadline steps down straight away, a high load once the last change has settled
+    if (load > 1.0f)
+    {
+        ++overrunCount;
+        stepDown();
+        return;
+    }
+
+    if (smoothedLoad > degradeLoad && settled)
+    {
+        stepDown();
+        return;
+    }
+
+    if (smoothedLoad < restoreLoad && qualityLevel.load() > 0)
+    {
+        samplesBelowRestore += numSamples;
+        if (samplesBelowRestore >= static_cast<int>(restoreSeconds * sampleRate))
+        {
+            --qualityLevel;
+            samplesSinceChange = 0;
+            samplesBelowRestore = 0;
+
+            if (qualityLevel.load() == 0)
+            {
+                restoreSeconds = minRestoreSeconds;
+            }
+        }
+    }
+    else
+    {
+        samplesBelowRestore = 0;
+    }
+}
+
+void QualityGovernor::stepDown()
+{
+    samplesBelowRestore = 0;
+    if (qualityLevel.load() < numQualityLevels - 1)
+    {
+        ++qualityLevel;
+        samplesSinceChange = 0;
+        restoreSeconds = juce::jmin(2.0f * restoreSeconds, maxRestoreSeconds);
+    }
+}
+
+ProcessingQuality QualityGovernor::getQualityForLevel(int level, ProcessingQuality base)
+{
+    // Each level keeps the shortcuts of the previous one, cheapest audible cost first
+    auto quality = base;
+    if (level >= 1)
+    {
+        // Half the allpass stages first, then none
+        quality.maxDispersionStages = (level >= 2) ? 0 : base.maxDispersionStages / 2;
+    }
+    if (level >= 2)
+    {
+        quality.delayInterpolation = VariableDelay::Interpolation::linear;
+    }
+    if (level >= 3)
+    {
+        quality.envelopeStride = juce::jmax(base.envelopeStride, 8);
+    }
+    if (level >= 4)
+    {
+        quality.maxActiveTrees = juce::jmin(base.maxActiveTrees, 2);
+    }
+    return quality;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ProcessingQuality.h"
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+/**
+ * Watches how long each block takes to process compared to its duration,
+ * and steps the processing quality down while the deadline is at risk.
+ *
+ * Quality drops one level on an overrun, or when the smoothed load stays
+ * above the degrade threshold. It only comes back one level at a time after
+ * the load has stayed low for a while, and the wait doubles every time the
+ * load forces it down again, so it does not oscillate around the limit.
+ */
+class QualityGovernor
+{
+    public:
+        static constexpr int numQualityLevels = 5;
+
+        QualityGovernor() = default;
+
+        void prepare(double sampleRate);
+        void reset();
+
+        // Offline renders have no deadline: the governor then keeps full quality
+        void setEnabled(bool shouldBeEnabled) { enabled = shouldBeEnabled; }
+
+        // Account for numSamples of audio whose processing started at startTicks (0 if nothing ran)
+        void blockProcessed(juce::int64 startTicks, int numSamples);
+
+        // 0 is full quality, higher levels take more shortcuts
+        int getQualityLevel() const { return enabled.load() ? qualityLevel.load() : 0; }
+        int getOverrunCount() const { return overrunCount.load(); }
+        float getLoad() const { return currentLoad.load(); }
+
+        // The quality of the selected tier, with the shortcuts of the given level on top
+        static ProcessingQuality getQualityForLevel(int level, ProcessingQuality base = {});
+
+    private:
+        static constexpr float degradeLoad = 0.6f;          // Share of the block duration that triggers a step down
+        static constexpr float restoreLoad = 0.3f;          // Share of the block duration below which quality can come back
+        static constexpr float loadTimeSeconds = 0.25f;     // Smoothing time of the load
+        static constexpr float settleSeconds = 0.25f;       // Time for a quality change to show in the load
+        static constexpr float minRestoreSeconds = 2.0f;
+        static constexpr float maxRestoreSeconds = 32.0f;
+
+        void stepDown();
+
+        double sampleRate = 44100.0;
+        float smoothedLoad = 0.0f;
+        int samplesSinceChange = 0;
+        int samplesBelowRestore = 0;
+        float restoreSeconds = minRestoreSeconds;
+
+        std::atomic<bool> enabled {true};
+        std::atomic<int> qualityLevel {0};
+        std::atomic<int> overrunCount {0};
+        std::atomic<float> currentLoad {0.0f};
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(QualityGovernor)
+};
@@ -0,0 +1,194 @@
+#include "RateConverter.h"
+#include "sst/basic-blocks/simd/setup.h"
+
+namespace
+{
+    // Dot product of two float arrays whose length is a multiple of 4
+    inline float dotProduct(const float *a, const float *b, int numSamples)
+    {
+        auto acc = SIMD_MM(setzero_ps)();
+        for (int i = 0; i < numSamples; i += 4)
+        {
+            acc = SIMD_MM(add_ps)(acc, SIMD_MM(mul_ps)(SIMD_MM(loadu_ps)(a + i), SIMD_MM(loadu_ps)(b + i)));
+        }
+
+        float r alignas(16)[4];
+        SIMD_MM(store_ps)(r, acc);
+        return (r[0] + r[1]) + (r[2] + r[3]);
+    }
+}
+
+int RateConverter::getDecimationFactor(double hostSampleRate)
+{
+    for (auto baseRate : baseSampleRates)
+    {
+        auto ratio = hostSampleRate / baseRate;
+        auto factor = juce::roundToInt(ratio);
+
+        // Only integer ratios of 2x and 4x are supported
+        if ((factor == 2 || factor == 4) && std::abs(ratio - factor) < 1.0e-6)
+        {
+            return factor;
+        }
+    }
+    return 1;
+}
+
+void RateConverter::prepare(const juce::dsp::ProcessSpec &hostSpec, int factor)
+{
+    const auto numChannels = static_cast<size_t>(hostSpec.numChannels);
+
+    decimationFactor = juce::jmax(1, factor);
+    kernelLength = tapsPerPhase * decimationFactor;
+
+    designKernel();
+
+    downHistory.assign(numChannels, std::vector<float>(2 * kernelLength, 0.0f));
+    upHistory.assign(numChannels, std::vector<float>(2 * tapsPerPhase, 0.0f));
+
+    dryDelay.setMaximumDelayInSamples(juce::jmax(1, getLatencySamples()));
+    dryDelay.prepare(hostSpec);
+    dryDelay.setDelay(static_cast<float>(getLatencySamples()));
+
+    reset();
+}
+
+void RateConverter::reset()
+{
+    for (auto &history : downHistory)
+    {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    for (auto &history : upHistory)
+    {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+
+    downPhase = 0;
+    upPhase = 0;
+    downWritePos = 0;
+    upWritePos = 0;
+
+    dryDelay.reset();
+}
+
+void RateConverter::designKernel()
+{
+    kernel.assign(kernelLength, 0.0f);
+
+    // Windowed-sinc lowpass just below the internal Nyquist frequency
+    const auto cutoff = 0.45 / decimationFactor;
+    const auto centre = 0.5 * (kernelLength - 1);
+
+    std::vector<float> window(kernelLength);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), kernelLength,
+                                                             juce::dsp::WindowingFunction<float>::kaiser,
+                                                             false, 8.0f);
+
+    double sum = 0.0;
+    for (int i = 0; i < kernelLength; ++i)
+    {
+        auto t = i - centre;
+        auto sinc = (t == 0.0) ? 2.0 * cutoff
+                               : std::sin(juce::MathConstants<double>::twoPi * cutoff * t) / (juce::MathConstants<double>::pi * t);
+        kernel[i] = static_cast<float>(sinc * window[i]);
+        sum += kernel[i];
+    }
+
+    // Unity gain at DC
+    for (auto &tap : kernel)
+    {
+        tap = static_cast<float>(tap / sum);
+    }
+
+    // Split the kernel into one branch per output phase, ordered oldest to newest
+    // to match the layout of the interpolator history
+    phaseKernels.assign(decimationFactor, std::vector<float>(tapsPerPhase, 0.0f));
+    for (int phase = 0; phase < decimationFactor; ++phase)
+    {
+        for (int i = 0; i < tapsPerPhase; ++i)
+        {
+            phaseKernels[phase][i] = decimationFactor * kernel[(tapsPerPhase - 1 - i) * decimationFactor + phase];
+        }
+    }
+}
+
+size_t RateConverter::downsample(const juce::dsp::AudioBlock<float> &hostBlock, juce::dsp::AudioBlock<float> &internalBlock)
+{
+    const auto numChannels = juce::jmin(hostBlock.getNumChannels(), internalBlock.getNumChannels(), downHistory.size());
+    const auto numSamples = hostBlock.getNumSamples();
+    size_t numInternal = 0;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        // Push the newest host sample into every channel history
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto &history = downHistory[ch];
+            const auto x = hostBlock.getChannelPointer(ch)[i];
+            history[downWritePos] = x;
+            history[downWritePos + kernelLength] = x;
+        }
+        downWritePos = (downWritePos + 1) % kernelLength;
+
+        // The decimator only evaluates the kernel once every decimationFactor samples
+        if (downPhase == decimationFactor - 1)
+        {
+            jassert(numInternal < internalBlock.getNumSamples());
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                // The kernel is symmetric, so it can be applied to the oldest-to-newest window directly
+                internalBlock.getChannelPointer(ch)[numInternal] =
+                    dotProduct(kernel.data(), downHistory[ch].data() + downWritePos, kernelLength);
+            }
+            ++numInternal;
+        }
+        downPhase = (downPhase + 1) % decimationFactor;
+    }
+
+    return numInternal;
+}
+
+void RateConverter::upsample(const juce::dsp::AudioBlock<float> &internalBlock, juce::dsp::AudioBlock<float> &hostBlock)
+{
+    const auto numChannels = juce::jmin(hostBlock.getNumChannels(), internalBlock.getNumChannels(), upHistory.size());
+    const auto numSamples = hostBlock.getNumSamples();
+    size_t readPos = 0;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        // Consume an internal sample at the same clock position the decimator produced it
+        if (upPhase == decimationFactor - 1)
+        {
+            jassert(readPos < internalBlock.getNumSamples());
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                auto &history = upHistory[ch];
+                const auto v = internalBlock.getChannelPointer(ch)[readPos];
+                history[upWritePos] = v;
+                history[upWritePos + tapsPerPhase] = v;
+            }
+            upWritePos = (upWritePos + 1) % tapsPerPhase;
+            ++readPos;
+        }
+
+        // Host samples elapsed since the last consumed internal sample select the polyphase branch
+        const auto &phaseKernel = phaseKernels[(upPhase + 1) % decimationFactor];
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            hostBlock.getChannelPointer(ch)[i] = dotProduct(phaseKernel.data(), upHistory[ch].data() + upWritePos, tapsPerPhase);
+        }
+        upPhase = (upPhase + 1) % decimationFactor;
+    }
+}
+
+void RateConverter::compensateLatency(juce::dsp::AudioBlock<float> &hostBlock)
+{
+    if (!isActive())
+    {
+        return;
+    }
+
+    juce::dsp::ProcessContextReplacing<float> context(hostBlock);
+    dryDelay.process(context);
+}
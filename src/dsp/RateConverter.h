@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/**
+ * Integer-factor polyphase resampler used at the plugin boundary
+ * to run the delay network at a fixed internal sample rate.
+ *
+ * The same sample clock drives the decimator and the interpolator, so every
+ * internal sample produced while downsampling a host block is consumed at the
+ * matching position while upsampling it. The round trip has a constant latency
+ * of (kernel length - 1) host samples.
+ */
+class RateConverter
+{
+    public:
+        RateConverter() = default;
+
+        // Returns the decimation factor that brings the host rate down to 48 kHz (or 44.1 kHz),
+        // or 1 when the host rate is not an integer multiple of either
+        static int getDecimationFactor(double hostSampleRate);
+
+        void prepare(const juce::dsp::ProcessSpec &hostSpec, int factor);
+        void reset();
+
+        bool isActive() const { return decimationFactor > 1; }
+        int  getFactor() const { return decimationFactor; }
+
+        // Latency of a down/up round trip, in host samples
+        int getLatencySamples() const { return isActive() ? kernelLength - 1 : 0; }
+
+        // Largest number of internal samples a single host block can produce
+        int getMaxInternalBlockSize(int maxHostBlockSize) const { return maxHostBlockSize / decimationFactor + 1; }
+
+        // Downsample a host block into the start of the internal block, returns the number of internal samples written
+        size_t downsample(const juce::dsp::AudioBlock<float> &hostBlock, juce::dsp::AudioBlock<float> &internalBlock);
+
+        // Upsample the internal samples produced by the matching downsample() call back into the host block
+        void upsample(const juce::dsp::AudioBlock<float> &internalBlock, juce::dsp::AudioBlock<float> &hostBlock);
+
+        // Delay a host-rate block by the round trip latency (used to keep the dry path aligned)
+        void compensateLatency(juce::dsp::AudioBlock<float> &hostBlock);
+
+    private:
+        static constexpr int tapsPerPhase = 24; // Must stay a multiple of 4 for the vectorised dot product
+        static constexpr double baseSampleRates[] = { 48000.0, 44100.0 };
+
+        void designKernel();
+
+        int decimationFactor = 1;
+        int kernelLength = tapsPerPhase;
+
+        // Shared sample clock for the decimator and the interpolator
+        int downPhase = 0;
+        int upPhase = 0;
+
+        // Lowpass kernel (decimator) and per-phase kernels (interpolator)
+        std::vector<float> kernel;
+        std::vector<std::vector<float>> phaseKernels;
+
+        // Double-written history rings, so the newest kernelLength samples are always contiguous
+        std::vector<std::vector<float>> downHistory;
+        std::vector<std::vector<float>> upHistory;
+        int downWritePos = 0;
+        int upWritePos = 0;
+
+        // Latency compensation for the host-rate dry path
+        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RateConverter)
+};
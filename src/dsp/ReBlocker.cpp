@@ -0,0 +1,35 @@
+#include "ReBlocker.h"
+
+void ReBlocker::prepare(const juce::dsp::ProcessSpec &hostSpec, int internalBlockSize)
+{
+    blockSize = juce::jmax(0, internalBlockSize);
+    buffer.setSize(static_cast<int>(hostSpec.numChannels), juce::jmax(1, blockSize));
+    reset();
+}
+
+void ReBlocker::reset()
+{
+    buffer.clear();
+    position = 0;
+}
+
+size_t ReBlocker::exchange(juce::dsp::AudioBlock<float> &hostBlock, size_t startSample)
+{
+    // The previous block has been processed: start playing it out
+    if (position == blockSize)
+    {
+        position = 0;
+    }
+
+    const auto numSamples = juce::jmin(hostBlock.getNumSamples() - startSample, static_cast<size_t>(blockSize - position));
+    const auto numChannels = juce::jmin(hostBlock.getNumChannels(), static_cast<size_t>(buffer.getNumChannels()));
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        auto *host = hostBlock.getChannelPointer(ch) + startSample;
+        std::swap_ranges(host, host + numSamples, buffer.getWritePointer(static_cast<int>(ch), position));
+    }
+
+    position += static_cast<int>(numSamples);
+    return numSamples;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * FIFO that turns host blocks of any size into blocks of a fixed size.
+ *
+ * A single buffer holds the processed block being played out and the input
+ * block being collected: each host sample is swapped with the processed
+ * sample at the same position, so the output is delayed by exactly one
+ * internal block.
+ */
+class ReBlocker
+{
+    public:
+        ReBlocker() = default;
+
+        // An internal block size of 0 disables the re-blocking
+        void prepare(const juce::dsp::ProcessSpec &hostSpec, int internalBlockSize);
+        void reset();
+
+        bool isActive() const { return blockSize > 0; }
+        int  getBlockSize() const { return blockSize; }
+
+        // Latency of the FIFO, in host samples
+        int getLatencySamples() const { return blockSize; }
+
+        // Swap host samples from startSample onwards with the FIFO, up to the end of the internal block.
+        // Returns the number of host samples exchanged.
+        size_t exchange(juce::dsp::AudioBlock<float> &hostBlock, size_t startSample);
+
+        // True when a full internal block has been collected and must be processed in place
+        bool isBlockReady() const { return isActive() && position == blockSize; }
+        juce::dsp::AudioBlock<float> getBlock() { return juce::dsp::AudioBlock<float>(buffer); }
+
+    private:
+        int blockSize = 0;
+        int position = 0;
+        juce::AudioBuffer<float> buffer;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReBlocker)
+};
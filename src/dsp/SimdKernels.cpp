@@ -0,0 +1,94 @@
+#include "SimdKernels.h"
+
+std::atomic<const SimdKernels::Table *> SimdKernels::selected {nullptr};
+
+namespace
+{
+    bool cpuSupports(SimdKernels::Level level)
+    {
+        switch (level)
+        {
+            case SimdKernels::Level::avx2:
+                return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+            case SimdKernels::Level::avx512:
+                return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL()
+                    && juce::SystemStats::hasAVX512BW() && juce::SystemStats::hasAVX512DQ()
+                    && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+            case SimdKernels::Level::baseline:
+            default:
+                return true;
+        }
+    }
+}
+
+const SimdKernels::Table &SimdKernels::get()
+{
+    auto *table = selected.load(std::memory_order_acquire);
+    if (table == nullptr)
+    {
+        selectDefault();
+        table = selected.load(std::memory_order_acquire);
+    }
+    return *table;
+}
+
+const SimdKernels::Table *SimdKernels::getTable(Level level)
+{
+    if (!cpuSupports(level))
+    {
+        return nullptr;
+    }
+
+    switch (level)
+    {
+        case Level::avx2: return SimdKernelBuilds::getAvx2Table();
+        case Level::avx512: return SimdKernelBuilds::getAvx512Table();
+        case Level::baseline:
+        default: return SimdKernelBuilds::getBaselineTable();
+    }
+}
+
+bool SimdKernels::select(Level level)
+{
+    auto *table = getTable(level);
+    if (table == nullptr)
+    {
+        return false;
+    }
+
+    selected.store(table, std::memory_order_release);
+    return true;
+}
+
+void SimdKernels::selectDefault()
+{
+    // The highest level available, capped by the environment override
+    auto maxLevel = static_cast<int>(numLevels) - 1;
+    const auto forced = juce::SystemStats::getEnvironmentVariable("MYCELIA_SIMD", {}).trim().toLowerCase();
+    for (size_t level = 0; level < numLevels; ++level)
+    {
+        if (forced == getLevelName(static_cast<Level>(level)))
+        {
+            maxLevel = static_cast<int>(level);
+        }
+    }
+
+    for (auto level = maxLevel; level >= 0; --level)
+    {
+        if (select(static_cast<Level>(level)))
+        {
+            return;
+        }
+    }
+}
+
+const char *SimdKernels::getLevelName(Level level)
+{
+    switch (level)
+    {
+        case Level::avx2: return "avx2";
+        case Level::avx512: return "avx512";
+        case Level::baseline:
+        default: return "baseline";
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+/**
+ * The hot loops of the engine, compiled once per x86 ISA level and picked at
+ * runtime from what the CPU supports.
+ *
+ * The baseline build is whatever the plugin is compiled for (SSE2 on x86, NEON
+ * through simde on ARM). On x86 with GCC or Clang the same loops are compiled
+ * again for AVX2 + FMA and for AVX-512, and the best level the CPU has is
+ * selected the first time the kernels are asked for. Set the MYCELIA_SIMD
+ * environment variable to "baseline", "avx2" or "avx512" to force a lower
+ * level, or call select().
+ *
+ * Processors take the table in prepare() and keep it, so a new selection
+ * reaches them on their next prepare().
+ */
+class SimdKernels
+{
+    public:
+        enum class Level
+        {
+            baseline,
+            avx2,
+            avx512
+        };
+        static constexpr size_t numLevels = 3;
+
+        // A linear gain trajectory over a block: sample i gets start + i * step
+        struct GainRamp
+        {
+            float start = 1.0f;
+            float step = 0.0f;
+        };
+
+        static constexpr int maxMixBands = 4;
+
+        struct Table
+        {
+            Level level;
+
+            // destination[i] += gain * source[i]
+            void (*addWithGain)(float *destination, const float *source, float gain, int numSamples);
+
+            // Largest absolute sample
+            float (*getPeak)(const float *data, int numSamples);
+
+            // Smallest and largest level of the samples (squared, or absolute values)
+            void (*getLevelRange)(const float *data, int numSamples, bool squared, float &min, float &max);
+
+            // output[i] = sum(bands[b][i] * bandRamps[b]) * wetRamp + dry[i] * dryRamp, for up to
+            // maxMixBands bands (dry may be null)
+            void (*mixRamped)(float *output, const float *const *bands, const GainRamp *bandRamps, int numBands,
+                              GainRamp wetRamp, const float *dry, GainRamp dryRamp, int numSamples);
+        };
+
+        // The selected kernels (chooses them on the first call)
+        static const Table &get();
+
+        // The kernels of one level, or nullptr when they are not built or the CPU lacks the instructions
+        static const Table *getTable(Level level);
+
+        // Select a level, returns false (and changes nothing) if it is unavailable
+        static bool select(Level level);
+
+        // Select the best level the CPU supports, or the one forced by MYCELIA_SIMD
+        static void selectDefault();
+
+        static Level getSelectedLevel() { return get().level; }
+        static const char *getLevelName(Level level);
+
+    private:
+        static std::atomic<const Table *> selected;
+
+        SimdKernels() = delete;
+};
+
+// The tables of each build (SimdKernels*.cpp), nullptr when a level is not compiled in
+namespace SimdKernelBuilds
+{
+    const SimdKernels::Table *getBaselineTable();
+    const SimdKernels::Table *getAvx2Table();
+    const SimdKernels::Table *getAvx512Table();
+}
@@ -0,0 +1,39 @@
+#include "SimdKernels.h"
+
+// Built for AVX-512 (F, VL, BW, DQ) through function target attributes, so the
+// rest of the plugin keeps its baseline flags. Only x86 with GCC or Clang has these.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #include <immintrin.h>
+    #define SIMD_KERNELS_HAS_AVX512 1
+#else
+    #define SIMD_KERNELS_HAS_AVX512 0
+#endif
+
+#if SIMD_KERNELS_HAS_AVX512
+    #if defined(__clang__)
+        #pragma clang attribute push (__attribute__((target("avx2,fma,avx512f,avx512vl,avx512bw,avx512dq"))), apply_to = function)
+    #else
+        #pragma GCC push_options
+        #pragma GCC target("avx2,fma,avx512f,avx512vl,avx512bw,avx512dq")
+    #endif
+
+    #define SIMD_KERNELS_BUILD avx512
+    #define SIMD_KERNELS_WIDTH 16
+    #define SIMD_KERNELS_LEVEL SimdKernels::Level::avx512
+    #include "SimdKernelsImpl.h"
+
+    #if defined(__clang__)
+        #pragma clang attribute pop
+    #else
+        #pragma GCC pop_options
+    #endif
+#endif
+
+const SimdKernels::Table *SimdKernelBuilds::getAvx512Table()
+{
+#if SIMD_KERNELS_HAS_AVX512
+    return &avx512::table;
+#else
+    return nullptr;
+#endif
+}
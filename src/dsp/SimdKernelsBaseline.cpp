@@ -0,0 +1,12 @@
+#include "SimdKernels.h"
+#include "sst/basic-blocks/simd/setup.h"
+
+#define SIMD_KERNELS_BUILD baseline
+#define SIMD_KERNELS_WIDTH 4
+#define SIMD_KERNELS_LEVEL SimdKernels::Level::baseline
+#include "SimdKernelsImpl.h"
+
+const SimdKernels::Table *SimdKernelBuilds::getBaselineTable()
+{
+    return &baseline::table;
+}
@@ -0,0 +1,223 @@
+// Kernel bodies, included once by each of the SimdKernels*.cpp builds
+// (no include guard). The includer defines SIMD_KERNELS_BUILD as the namespace
+// to put them in and SIMD_KERNELS_WIDTH as its register width in floats,
+// includes SimdKernels.h first and sets the target ISA around this file.
+// The element-wise loops are plain loops the compiler vectorises for the target.
+// It does not vectorise the min/max reductions (their NaN handling differs
+// from the scalar compares), so those are written with the registers of the
+// build, through the few operations below.
+
+namespace SimdKernelBuilds::SIMD_KERNELS_BUILD
+{
+#if SIMD_KERNELS_WIDTH == 16
+    using Vector = __m512;
+    inline Vector load(const float *data) { return _mm512_loadu_ps(data); }
+    inline Vector broadcast(float x) { return _mm512_set1_ps(x); }
+    inline Vector abs(Vector v) { return _mm512_andnot_ps(_mm512_set1_ps(-0.0f), v); }
+    inline Vector square(Vector v) { return _mm512_mul_ps(v, v); }
+    inline Vector min(Vector a, Vector b) { return _mm512_min_ps(a, b); }
+    inline Vector max(Vector a, Vector b) { return _mm512_max_ps(a, b); }
+    inline float reduceMin(Vector v) { return _mm512_reduce_min_ps(v); }
+    inline float reduceMax(Vector v) { return _mm512_reduce_max_ps(v); }
+#elif SIMD_KERNELS_WIDTH == 8
+    using Vector = __m256;
+    inline Vector load(const float *data) { return _mm256_loadu_ps(data); }
+    inline Vector broadcast(float x) { return _mm256_set1_ps(x); }
+    inline Vector abs(Vector v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+    inline Vector square(Vector v) { return _mm256_mul_ps(v, v); }
+    inline Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+    inline Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    inline float reduceMin(Vector v)
+    {
+        auto x = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_min_ps(x, _mm_movehl_ps(x, x));
+        return _mm_cvtss_f32(_mm_min_ss(x, _mm_shuffle_ps(x, x, 1)));
+    }
+    inline float reduceMax(Vector v)
+    {
+        auto x = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+        return _mm_cvtss_f32(_mm_max_ss(x, _mm_shuffle_ps(x, x, 1)));
+    }
+#else
+    using Vector = decltype(SIMD_MM(setzero_ps)());
+    inline Vector load(const float *data) { return SIMD_MM(loadu_ps)(data); }
+    inline Vector broadcast(float x) { return SIMD_MM(set1_ps)(x); }
+    inline Vector abs(Vector v) { return SIMD_MM(andnot_ps)(SIMD_MM(set1_ps)(-0.0f), v); }
+    inline Vector square(Vector v) { return SIMD_MM(mul_ps)(v, v); }
+    inline Vector min(Vector a, Vector b) { return SIMD_MM(min_ps)(a, b); }
+    inline Vector max(Vector a, Vector b) { return SIMD_MM(max_ps)(a, b); }
+    inline float reduceMin(Vector v)
+    {
+        v = SIMD_MM(min_ps)(v, SIMD_MM(movehl_ps)(v, v));
+        return SIMD_MM(cvtss_f32)(SIMD_MM(min_ss)(v, SIMD_MM(shuffle_ps)(v, v, 1)));
+    }
+    inline float reduceMax(Vector v)
+    {
+        v = SIMD_MM(max_ps)(v, SIMD_MM(movehl_ps)(v, v));
+        return SIMD_MM(cvtss_f32)(SIMD_MM(max_ss)(v, SIMD_MM(shuffle_ps)(v, v, 1)));
+    }
+#endif
+    constexpr int width = SIMD_KERNELS_WIDTH;
+
+    void addWithGain(float *destination, const float *source, float gain, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destination[i] += gain * source[i];
+        }
+    }
+
+    // Running maxima (and minima) per loop, so the loops are not held up by the latency of a single chain
+    constexpr int numChains = 4;
+
+    // The level comes first in max() and min(), so NaN samples are skipped as in the scalar compares
+    float getPeak(const float *data, int numSamples)
+    {
+        Vector peaks[numChains];
+        for (auto &chain : peaks)
+        {
+            chain = broadcast(0.0f);
+        }
+
+        int i = 0;
+        for (; i + numChains * width <= numSamples; i += numChains * width)
+        {
+            for (int chain = 0; chain < numChains; ++chain)
+            {
+                peaks[chain] = max(abs(load(data + i + chain * width)), peaks[chain]);
+            }
+        }
+        for (; i + width <= numSamples; i += width)
+        {
+            peaks[0] = max(abs(load(data + i)), peaks[0]);
+        }
+
+        auto peak = reduceMax(max(max(peaks[0], peaks[1]), max(peaks[2], peaks[3])));
+        for (; i < numSamples; ++i)
+        {
+            const auto level = data[i] < 0.0f ? -data[i] : data[i];
+            peak = level > peak ? level : peak;
+        }
+        return peak;
+    }
+
+    // Plain functions rather than lambdas, which do not pick up the target ISA of the build
+    template <bool Squared>
+    float levelOf(float x) { return Squared ? x * x : (x < 0.0f ? -x : x); }
+
+    template <bool Squared>
+    Vector levelsOf(Vector v) { return Squared ? square(v) : abs(v); }
+
+    template <bool Squared>
+    void getLevelRangeOf(const float *data, int numSamples, float &min, float &max)
+    {
+        auto low = levelOf<Squared>(data[0]);
+        auto high = low;
+
+        Vector lows[numChains], highs[numChains];
+        for (int chain = 0; chain < numChains; ++chain)
+        {
+            lows[chain] = highs[chain] = broadcast(low);
+        }
+
+        int i = 1;
+        for (; i + numChains * width <= numSamples; i += numChains * width)
+        {
+            for (int chain = 0; chain < numChains; ++chain)
+            {
+                const auto levels = levelsOf<Squared>(load(data + i + chain * width));
+                lows[chain] = SIMD_KERNELS_BUILD::min(levels, lows[chain]);
+                highs[chain] = SIMD_KERNELS_BUILD::max(levels, highs[chain]);
+            }
+        }
+        for (; i + width <= numSamples; i += width)
+        {
+            const auto levels = levelsOf<Squared>(load(data + i));
+            lows[0] = SIMD_KERNELS_BUILD::min(levels, lows[0]);
+            highs[0] = SIMD_KERNELS_BUILD::max(levels, highs[0]);
+        }
+
+        low = reduceMin(SIMD_KERNELS_BUILD::min(SIMD_KERNELS_BUILD::min(lows[0], lows[1]), SIMD_KERNELS_BUILD::min(lows[2], lows[3])));
+        high = reduceMax(SIMD_KERNELS_BUILD::max(SIMD_KERNELS_BUILD::max(highs[0], highs[1]), SIMD_KERNELS_BUILD::max(highs[2], highs[3])));
+        for (; i < numSamples; ++i)
+        {
+            const auto level = levelOf<Squared>(data[i]);
+            low = level < low ? level : low;
+            high = level > high ? level : high;
+        }
+        min = low;
+        max = high;
+    }
+
+    void getLevelRange(const float *data, int numSamples, bool squared, float &min, float &max)
+    {
+        if (numSamples <= 0)
+        {
+            return;
+        }
+
+        if (squared)
+        {
+            getLevelRangeOf<true>(data, numSamples, min, max);
+        }
+        else
+        {
+            getLevelRangeOf<false>(data, numSamples, min, max);
+        }
+    }
+
+    // Straight-line loops with a fixed number of bands
+    template <int NumBands>
+    void mixBands(float *output, const float *const *bands, const SimdKernels::GainRamp *bandRamps,
+                  SimdKernels::GainRamp wetRamp, const float *dry, SimdKernels::GainRamp dryRamp, int numSamples)
+    {
+        if (dry != nullptr)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto t = static_cast<float>(i);
+                auto sum = 0.0f;
+                for (int band = 0; band < NumBands; ++band)
+                {
+                    sum += bands[band][i] * (bandRamps[band].start + bandRamps[band].step * t);
+                }
+                output[i] = sum * (wetRamp.start + wetRamp.step * t) + dry[i] * (dryRamp.start + dryRamp.step * t);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto t = static_cast<float>(i);
+                auto sum = 0.0f;
+                for (int band = 0; band < NumBands; ++band)
+                {
+                    sum += bands[band][i] * (bandRamps[band].start + bandRamps[band].step * t);
+                }
+                output[i] = sum * (wetRamp.start + wetRamp.step * t);
+            }
+        }
+    }
+
+    void mixRamped(float *output, const float *const *bands, const SimdKernels::GainRamp *bandRamps, int numBands,
+                   SimdKernels::GainRamp wetRamp, const float *dry, SimdKernels::GainRamp dryRamp, int numSamples)
+    {
+        switch (numBands)
+        {
+            case 1: mixBands<1>(output, bands, bandRamps, wetRamp, dry, dryRamp, numSamples); break;
+            case 2: mixBands<2>(output, bands, bandRamps, wetRamp, dry, dryRamp, numSamples); break;
+            case 3: mixBands<3>(output, bands, bandRamps, wetRamp, dry, dryRamp, numSamples); break;
+            case 4: mixBands<4>(output, bands, bandRamps, wetRamp, dry, dryRamp, numSamples); break;
+            default: mixBands<0>(output, bands, bandRamps, wetRamp, dry, dryRamp, numSamples); break;
+        }
+    }
+
+    const SimdKernels::Table table {
+        SIMD_KERNELS_LEVEL,
+        addWithGain,
+        getPeak,
+        getLevelRange,
+        mixRamped
+    };
+}
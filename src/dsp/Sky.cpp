@@ -1,7 +1,18 @@
 #include "Sky.h"
 #include "util/ParameterRanges.h"
+#include "util/FastMath.h"
 
-Sky::Sky()
+namespace
+{
+    // Reverb settings the humidity and height map to (built once, not on first use in the timer callback)
+    const juce::NormalisableRange<float> diffusionRange {0.65f, 1.0f, 0.01f};
+    const juce::NormalisableRange<float> decayTimeRange {-4.0f, 1.0f, 0.01f};
+    const juce::NormalisableRange<float> buildupRange {0.9f, 1.0f, 0.01f};
+    const juce::NormalisableRange<float> predelayRange {-0.5f, 1.0f, 0.01f};
+}
+
+Sky::Sky(ControlScheduler &scheduler) :
+    ControlTimer(&scheduler)
 {
     // Initialize reverb parameters
     reverbParams[ReverbParams::PREDELAY]   = -4.0f;    // Default pre-delay
@@ -14,37 +25,73 @@ Sky::Sky()
     reverbParams[ReverbParams::HF_DAMPING] = 0.35f;    // Some HF damping
 
     // Initialize the reverb effect
-    reverb = std::make_unique<sst::voice_effects::liftbus::LiftedReverb2<VFXConfig>>();
+    fineReverb = std::make_unique<FineReverb>();
     // Manual parameter initialization - we'll set them directly in paramStorage
     // since there's an issue with setFloatParam
-    reverb->initVoiceEffect();
+    fineReverb->initVoiceEffect();
     startTimer(500); // Start the timer for parameter updates
 }
 
 Sky::~Sky()
 {
+    stopTimer();
+
     // Ensure proper cleanup of both effects
-    reverb.reset();
+    fineReverb.reset();
+    coarseReverb.reset();
 }
 
 void Sky::prepare(const juce::dsp::ProcessSpec &spec)
 {
     fs = static_cast<float>(spec.sampleRate);
 
-    // Initialize the process buffer
-    processBuffer.setSize(spec.numChannels, VFXConfig::blockSize);
+    // Feed the reverb in the block size of the current quality
+    blockAdapter.prepare(useFineBlocks ? VFXConfig<16>::blockSize : VFXConfig<32>::blockSize, blocksAligned);
 
-    // Re-initialize the reverb effect with new sample rate
-    reverb = std::make_unique<sst::voice_effects::liftbus::LiftedReverb2<VFXConfig>>();
+    // Re-initialize the reverb effect with new sample rate, in the block size of the current quality
     // Manual parameter initialization - we'll set them directly in the reverb object
     // through the VFXConfig::setFloatParam method
-    reverb->initVoiceEffect();
+    if (engine != Engine::lifted)
+    {
+        // Only the FDN exists, with the current mapping
+        fineReverb.reset();
+        coarseReverb.reset();
+        const auto numLines = (engine == Engine::fdn4) ? 4 : (engine == Engine::fdn8) ? 8 : 16;
+        fdnReverb.prepare(spec.sampleRate, numLines, reverbParams[ReverbParams::ROOM_SIZE]);
+        updateFdnParameters();
+    }
+    else if (useFineBlocks)
+    {
+        coarseReverb.reset();
+        fineReverb = std::make_unique<FineReverb>();
+        fineReverb->initVoiceEffect();
+    }
+    else
+    {
+        fineReverb.reset();
+        coarseReverb = std::make_unique<CoarseReverb>();
+        coarseReverb->initVoiceEffect();
+    }
+
+    // The new reverb starts from its defaults: send it the current mapping again
+    humidityChanged = true;
+    heightChanged = true;
 }
 
 void Sky::reset()
 {
     // Suspend processing for the reverb
-    reverb->initVoiceEffect(); // Re-initialize the reverb
+    if (fineReverb)
+    {
+        fineReverb->initVoiceEffect(); // Re-initialize the reverb
+    }
+    if (coarseReverb)
+    {
+        coarseReverb->initVoiceEffect();
+    }
+
+    fdnReverb.reset();
+    blockAdapter.reset();
 }
 
 template <typename ProcessContext>
@@ -52,8 +99,6 @@ void Sky::process(const ProcessContext &context)
 {
     const auto &inputBlock = context.getInputBlock();
     auto &outputBlock = context.getOutputBlock();
-    const auto numChannels = inputBlock.getNumChannels();
-    const auto numSamples = inputBlock.getNumSamples();
 
     // Handle bypass
     if (context.isBypassed)
@@ -71,37 +116,29 @@ void Sky::process(const ProcessContext &context)
         outputBlock.copyFrom(inputBlock);
     }
 
-    // Process the audio through the Reverb in blocks of VFXConfig::blockSize
-    for (size_t pos = 0; pos < numSamples; pos += VFXConfig::blockSize)
+    if (fineReverb)
     {
-        // Calculate how many samples to process in this iteration
-        size_t blockSize = std::min((size_t)VFXConfig::blockSize, numSamples - pos);
-
-        if (numChannels >= 2)
-        {
-            // Copy input audio to process buffer
-            for (size_t i = 0; i < blockSize; ++i)
-            {
-                processBuffer.setSample(0, i, inputBlock.getSample(0, pos + i));
-                processBuffer.setSample(1, i, inputBlock.getSample(1, pos + i));
-            }
-
-            // Process through Reverb
-            reverb->processStereo(
-                processBuffer.getReadPointer(0),
-                processBuffer.getReadPointer(1),
-                processBuffer.getWritePointer(0),
-                processBuffer.getWritePointer(1),
-                0.0f); // No pitch modulation
-
-            // Copy processed audio back to output
-            for (size_t i = 0; i < blockSize; ++i)
-            {
-                outputBlock.setSample(0, pos + i, processBuffer.getSample(0, i));
-                outputBlock.setSample(1, pos + i, processBuffer.getSample(1, i));
-            }
-        }
+        processReverb(*fineReverb, outputBlock);
+    }
+    else if (coarseReverb)
+    {
+        processReverb(*coarseReverb, outputBlock);
     }
+    else
+    {
+        fdnReverb.process(outputBlock);
+    }
+}
+
+template <int BlockSize>
+void Sky::processReverb(sst::voice_effects::liftbus::LiftedReverb2<VFXConfig<BlockSize>> &reverb,
+                        juce::dsp::AudioBlock<float> &block)
+{
+    // Process the audio through the Reverb in place, in blocks of VFXConfig::blockSize
+    blockAdapter.process(block, [&reverb](float *left, float *right)
+    {
+        reverb.processStereo(left, right, left, right, 0.0f); // No pitch modulation
+    });
 }
 
 void Sky::setParameters(const Parameters &params)
@@ -123,28 +160,27 @@ void Sky::setParameters(const Parameters &params)
 
 void Sky::timerCallback()
 {
+    const auto anyChanged = humidityChanged || heightChanged;
+
     if (humidityChanged)
     {
         float normalizedHumidity = ParameterRanges::normalizeParameter(ParameterRanges::skyHumidityRange, inHumidity);
         // Map humidity to diffusion (0.65-1)
-        static auto diffusionRange = juce::NormalisableRange<float>(0.65f, 1.0f, 0.01f);
         auto diffusionVal = ParameterRanges::denormalizeParameter(diffusionRange, normalizedHumidity);
         reverbParams[ReverbParams::DIFFUSION] = diffusionVal; // Higher humidity = more diffusion
 
         // Map humidity to decay time (-4 to 1)
-        static auto decayTimeRange = juce::NormalisableRange<float>(-4.0f, 1.0f, 0.01f);
         auto decayTimeVal = ParameterRanges::denormalizeParameter(decayTimeRange, normalizedHumidity);
         reverbParams[ReverbParams::DECAY_TIME] = decayTimeVal; // Higher humidity = longer decay
 
         // Map humidity to buildup (0.9 to 1.0)
-        static auto buildupRange = juce::NormalisableRange<float>(0.9f, 1.0f, 0.01f);
         auto buildupVal = ParameterRanges::denormalizeParameter(buildupRange, normalizedHumidity);
         reverbParams[ReverbParams::BUILDUP] = buildupVal; // Higher humidity = more buildup
 
         // Update reverb parameters
-        VFXConfig::setFloatParam(reverb.get(), ReverbParams::DIFFUSION, reverbParams[ReverbParams::DIFFUSION]);
-        VFXConfig::setFloatParam(reverb.get(), ReverbParams::DECAY_TIME, reverbParams[ReverbParams::DECAY_TIME]);
-        VFXConfig::setFloatParam(reverb.get(), ReverbParams::BUILDUP, reverbParams[ReverbParams::BUILDUP]);
+        setReverbParam(ReverbParams::DIFFUSION, reverbParams[ReverbParams::DIFFUSION]);
+        setReverbParam(ReverbParams::DECAY_TIME, reverbParams[ReverbParams::DECAY_TIME]);
+        setReverbParam(ReverbParams::BUILDUP, reverbParams[ReverbParams::BUILDUP]);
 
         humidityChanged = false;
     }
@@ -154,15 +190,42 @@ void Sky::timerCallback()
         float normalizedHeight = ParameterRanges::normalizeParameter(ParameterRanges::skyHeightRange, inHeight);
 
         // Height affects reverb predelay (from -0.5 to 1)
-        static auto predelayRange = juce::NormalisableRange<float>(-0.5f, 1.0f, 0.01f);
         auto predelayVal = ParameterRanges::denormalizeParameter(predelayRange, normalizedHeight);
         reverbParams[ReverbParams::PREDELAY] = predelayVal;
 
         // Update reverb parameters
-        VFXConfig::setFloatParam(reverb.get(), ReverbParams::PREDELAY, reverbParams[ReverbParams::PREDELAY]);
+        setReverbParam(ReverbParams::PREDELAY, reverbParams[ReverbParams::PREDELAY]);
 
         heightChanged = false;
     }
+
+    if (anyChanged)
+    {
+        updateFdnParameters();
+    }
+}
+
+void Sky::updateFdnParameters()
+{
+    // The sst reverb takes its times as log2 of seconds
+    FdnReverb::Parameters fdnParams;
+    fdnParams.decaySeconds = FastMath::exp2(reverbParams[ReverbParams::DECAY_TIME]);
+    fdnParams.predelaySeconds = FastMath::exp2(reverbParams[ReverbParams::PREDELAY]);
+    fdnParams.diffusion = reverbParams[ReverbParams::DIFFUSION];
+    fdnParams.damping = reverbParams[ReverbParams::HF_DAMPING];
+    fdnReverb.setParameters(fdnParams);
+}
+
+void Sky::setReverbParam(ReverbParams param, float value)
+{
+    if (fineReverb)
+    {
+        VFXConfig<16>::setFloatParam(fineReverb.get(), param, value);
+    }
+    if (coarseReverb)
+    {
+        VFXConfig<32>::setFloatParam(coarseReverb.get(), param, value);
+    }
 }
 
 //==================================================
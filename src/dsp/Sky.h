@@ -4,11 +4,16 @@
 #include "sst/voice-effects/lifted_bus_effects/LiftedReverb2.h"
 #include "sst/voice-effects/lifted_bus_effects/FXConfigFromVFXConfig.h"
 #include "sst/effects/Reverb2.h"
+#include "ProcessingQuality.h"
+#include "ControlScheduler.h"
+#include "BlockPool.h"
+#include "FixedBlockAdapter.h"
+#include "FdnReverb.h"
 /**
  * Sky processor that uses Nimbus granular effect from SST
  */
 class Sky
-    : private juce::Timer
+    : private ControlTimer
 {
     public:
         struct Parameters
@@ -17,7 +22,16 @@ class Sky
             float height;        // Height affects position and pitch (0-100)
         };
 
-        Sky();
+        // The sst reverb, or the leaner in-house FDN with 4, 8 or 16 lines
+        enum class Engine
+        {
+            lifted,
+            fdn4,
+            fdn8,
+            fdn16
+        };
+
+        explicit Sky(ControlScheduler &scheduler);
         ~Sky();
 
         // processing functions
@@ -29,6 +43,15 @@ class Sky
 
         void setParameters(const Parameters& params);
 
+        // The reverb block size is applied on the next prepare()
+        void setQuality(const ProcessingQuality &quality) { useFineBlocks = quality.fineReverbBlocks; }
+
+        // True when every block is a multiple of the reverb block size (applied on the next prepare())
+        void setBlocksAligned(bool aligned) { blocksAligned = aligned; }
+
+        // The reverb engine is applied on the next prepare()
+        void setEngine(Engine newEngine) { engine = newEngine; }
+
     private:
         float fs = 44100.0f;
 
@@ -77,6 +100,7 @@ class Sky
             }
         };
 
+        template <int BlockSize>
         struct VFXConfig
         {
             using config_t = VFXConfig;
@@ -84,6 +108,7 @@ class Sky
             struct BC
             {
                 DbToLinearProvider dbtlp;
+                BlockPool pool;
                 static constexpr uint16_t maxParamCount{8};
                 float paramStorage[maxParamCount];
                 double sampleRate = 44100.0; // Add the sampleRate field here
@@ -91,7 +116,11 @@ class Sky
                 float equalNoteToPitch(float p) const { return pow(2.0, p / 12); }
                 float dbToLinear(float f) const { return dbtlp.dbToLinear(f); }
                 template <typename... Types>
-                BC(Types...) { dbtlp.init(); }
+                BC(Types...)
+                {
+                    dbtlp.init();
+                    pool.reserve(defaultPoolBytes);
+                }
             };
             struct GS
             {
@@ -115,7 +144,7 @@ class Sky
             using GlobalStorage = GS;
             using EffectStorage = ES;
             using ValueStorage = float *;
-            static constexpr int blockSize{16};
+            static constexpr int blockSize{BlockSize};
 
             static void setFloatParam(BC *b, int i, float f) { b->paramStorage[i] = f; }
             static float getFloatParam(const BC *b, int i) { return b->paramStorage[i]; }
@@ -141,25 +170,46 @@ class Sky
                 return 1.0f / s->getSampleRate();
             }
 
-            static uint8_t *checkoutBlock(BaseClass *, size_t n)
+            static uint8_t *checkoutBlock(BaseClass *b, size_t n)
             {
-                return new uint8_t[n];
+                return b->pool.checkout(n);
             }
 
-            static void returnBlock(BaseClass *, uint8_t *ptr, size_t)
+            static void returnBlock(BaseClass *b, uint8_t *ptr, size_t n)
             {
-                delete[] ptr;
+                b->pool.giveBack(ptr, n);
             }
 
-            static void preReservePool(BaseClass *, size_t) {}
-            static void preReserveSingleInstancePool(BaseClass *, size_t) {}
+            static void preReservePool(BaseClass *b, size_t n) { b->pool.reserve(n); }
+            static void preReserveSingleInstancePool(BaseClass *b, size_t n) { b->pool.reserve(n); }
         };
 
-        std::unique_ptr<sst::voice_effects::liftbus::LiftedReverb2<VFXConfig>> reverb;
-        std::array<float, sst::voice_effects::liftbus::LiftedReverb2<VFXConfig>::numFloatParams> reverbParams;
+        // The reverb updates its parameters once per block: longer blocks are cheaper but coarser
+        using FineReverb = sst::voice_effects::liftbus::LiftedReverb2<VFXConfig<16>>;
+        using CoarseReverb = sst::voice_effects::liftbus::LiftedReverb2<VFXConfig<32>>;
+        // Memory the reverb can check out without touching the heap
+        static constexpr size_t defaultPoolBytes = 1 << 16;
+
+        // Only the reverb for the prepared quality exists
+        bool useFineBlocks = true;
+        std::unique_ptr<FineReverb> fineReverb;
+        std::unique_ptr<CoarseReverb> coarseReverb;
+        std::array<float, FineReverb::numFloatParams> reverbParams;
+
+        void setReverbParam(ReverbParams param, float value);
+
+        // The FDN alternative, only used when it is the prepared engine
+        Engine engine = Engine::lifted;
+        FdnReverb fdnReverb;
+        void updateFdnParameters();
+
+        template <int BlockSize>
+        void processReverb(sst::voice_effects::liftbus::LiftedReverb2<VFXConfig<BlockSize>> &reverb,
+                           juce::dsp::AudioBlock<float> &block);
 
-        // Buffer for handling different block sizes
-        juce::AudioBuffer<float> processBuffer;
+        // Feeds the reverb in its own block size, straight from the block when it is aligned
+        bool blocksAligned = false;
+        FixedBlockAdapter blockAdapter;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sky)
 };
\ No newline at end of file
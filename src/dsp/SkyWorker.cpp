@@ -0,0 +1,172 @@
+#include "SkyWorker.h"
+#include "util/Utils.h"
+
+SkyWorker::SkyWorker(Sky &sky) :
+    juce::Thread("Mycelia sky"),
+    sky(sky)
+{
+}
+
+SkyWorker::~SkyWorker()
+{
+    stop();
+}
+
+void SkyWorker::prepare(const juce::dsp::ProcessSpec &spec)
+{
+    stop();
+
+    const auto numChannels = static_cast<int>(spec.numChannels);
+    const auto maxNumSamples = static_cast<int>(spec.maximumBlockSize);
+    buffer.setSize(numChannels, maxNumSamples);
+    fifo.setSize(numChannels, maxNumSamples);
+    outputBuffer.setSize(numChannels, maxNumSamples);
+    reset();
+
+    // The audio thread waits for this one, so it runs with the priority and period of the audio.
+    // If that is refused the thread is not started and blocks are processed inline
+    const auto blockPeriodMs = 1000.0 * spec.maximumBlockSize / spec.sampleRate;
+    startRealtimeThread(juce::Thread::RealtimeOptions{}.withPeriodMs(blockPeriodMs));
+}
+
+void SkyWorker::stop()
+{
+    if (jobPending)
+    {
+        jobDone.acquire();
+        jobPending = false;
+    }
+
+    signalThreadShouldExit();
+    jobReady.release();
+    stopThread(2000);
+
+    // Drop the wake-up if the thread had already left its loop
+    while (jobReady.try_acquire())
+    {
+    }
+}
+
+void SkyWorker::reset()
+{
+    buffer.clear();
+    jobSamples = 0;
+    jobUnread = false;
+
+    // Primed with a full block of silence: it then always holds a block before a read
+    fifo.clear();
+    fifoReadPos = 0;
+    fifoWritePos = 0;
+
+    idle = false;
+    lastPeak = 0.0f;
+}
+
+juce::dsp::AudioBlock<float> SkyWorker::join(size_t numSamples)
+{
+    if (jobPending)
+    {
+        jobDone.acquire();
+        jobPending = false;
+    }
+    pushJobOutput();
+
+    // The FIFO is back to one maximum block here, so there is always enough to read
+    const auto fifoSize = fifo.getNumSamples();
+    const auto n = juce::jmin(static_cast<int>(numSamples), fifoSize);
+    const auto first = juce::jmin(n, fifoSize - fifoReadPos);
+    for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+    {
+        outputBuffer.copyFrom(ch, 0, fifo, ch, fifoReadPos, first);
+        outputBuffer.copyFrom(ch, first, fifo, ch, 0, n - first);
+    }
+    fifoReadPos = (fifoReadPos + n) % fifoSize;
+
+    return juce::dsp::AudioBlock<float>(outputBuffer).getSubBlock(0, static_cast<size_t>(n));
+}
+
+void SkyWorker::pushJobOutput()
+{
+    if (!jobUnread)
+    {
+        return;
+    }
+    jobUnread = false;
+
+    const auto fifoSize = fifo.getNumSamples();
+    const auto n = juce::jmin(static_cast<int>(jobSamples), fifoSize);
+    const auto first = juce::jmin(n, fifoSize - fifoWritePos);
+    for (int ch = 0; ch < fifo.getNumChannels(); ++ch)
+    {
+        fifo.copyFrom(ch, fifoWritePos, buffer, ch, 0, first);
+        fifo.copyFrom(ch, 0, buffer, ch, first, n - first);
+    }
+    fifoWritePos = (fifoWritePos + n) % fifoSize;
+}
+
+void SkyWorker::launch(const juce::dsp::AudioBlock<float> &sendBlock, bool sendMuted)
+{
+    jassert(!jobPending && !jobUnread);
+
+    // Every block puts as many samples in the FIFO as it takes out
+    jobSamples = sendBlock.getNumSamples();
+    jobUnread = true;
+
+    // Nothing to hear and nothing left ringing: skip the reverb until it is unmuted (the buffer stays clear)
+    if (sendMuted && lastPeak <= silenceThreshold)
+    {
+        if (!idle)
+        {
+            buffer.clear();
+            idle = true;
+        }
+        lastPeak = 0.0f;
+        return;
+    }
+
+    idle = false;
+    auto jobBlock = juce::dsp::AudioBlock<float>(buffer).getSubBlock(0, jobSamples);
+
+    // A muted reverb only gets silence, so its tail decays
+    if (sendMuted)
+    {
+        jobBlock.clear();
+    }
+    else
+    {
+        jobBlock.copyFrom(sendBlock);
+    }
+
+    if (runInline || !isThreadRunning())
+    {
+        processJob();
+        return;
+    }
+
+    jobPending = true;
+    jobReady.release();
+}
+
+void SkyWorker::run()
+{
+    while (!threadShouldExit())
+    {
+        jobReady.acquire();
+        if (threadShouldExit())
+        {
+            break;
+        }
+
+        processJob();
+        jobDone.release();
+    }
+}
+
+void SkyWorker::processJob()
+{
+    auto jobBlock = juce::dsp::AudioBlock<float>(buffer).getSubBlock(0, jobSamples);
+    juce::dsp::ProcessContextReplacing<float> context(jobBlock);
+
+    sky.process(context);
+    lastPeak = Utils::getPeakLevel(jobBlock);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Sky.h"
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <semaphore>
+
+/**
+ * Runs Sky on its own thread, one block behind the rest of the network.
+ *
+ * The reverb output is only mixed into the following blocks, so the block
+ * launched at the end of processCore() can be processed while the next
+ * block goes through the input, EdgeTree and DelayNetwork stages, and is
+ * joined at the next mix point. The hand-over uses semaphores only, so
+ * the audio thread never takes a lock, and the thread is a realtime one
+ * with the period of a block so the audio thread does not wait on a
+ * lower priority thread (without it, blocks are processed inline).
+ *
+ * Joined blocks go through a FIFO primed with one maximum block of
+ * silence, so blocks of any length read exactly their own number of
+ * samples and the reverb is delayed by a constant maximum block size.
+ *
+ * While the reverb is muted its send is silenced, and once the tail has
+ * decayed the reverb is not run at all. Offline, blocks are processed
+ * inline on the audio thread (with the same one block delay).
+ */
+class SkyWorker :
+    private juce::Thread
+{
+    public:
+        explicit SkyWorker(Sky &sky);
+        ~SkyWorker() override;
+
+        // Size the block buffer and start the thread (call after Sky::prepare)
+        void prepare(const juce::dsp::ProcessSpec &spec);
+        // Wait for the running block and stop the thread (call before preparing or resetting Sky)
+        void stop();
+        // Clear the pending output
+        void reset();
+
+        void setRealtime(bool isRealtime) { runInline = !isRealtime; }
+
+        // Audio thread: wait for the last launched block and return the next numSamples of output
+        juce::dsp::AudioBlock<float> join(size_t numSamples);
+
+        // Audio thread: start processing a copy of the send block
+        void launch(const juce::dsp::AudioBlock<float> &sendBlock, bool sendMuted);
+
+        // Peak of the output returned by the last join()
+        float getLastPeak() const { return lastPeak; }
+
+    private:
+        void run() override;
+        void processJob();
+
+        static constexpr float silenceThreshold = 1.0e-6f; // -120 dB
+
+        Sky &sky;
+
+        // Holds the send of a launched block, and its output once processed
+        juce::AudioBuffer<float> buffer;
+        size_t jobSamples = 0;
+        bool jobUnread = false;   // The output of the last job has not been moved to the FIFO yet
+
+        // Audio thread: processed output waiting to be mixed, and the block handed out by join()
+        juce::AudioBuffer<float> fifo;
+        int fifoReadPos = 0;
+        int fifoWritePos = 0;
+        juce::AudioBuffer<float> outputBuffer;
+        void pushJobOutput();
+
+        std::binary_semaphore jobReady {0};
+        std::binary_semaphore jobDone {0};
+        bool jobPending = false;
+        std::atomic<bool> runInline {false};
+
+        // Muted with a decayed tail: the reverb is not run and the buffer stays clear
+        bool idle = false;
+        float lastPeak = 0.0f;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SkyWorker)
+};
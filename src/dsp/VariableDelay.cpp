@@ -0,0 +1,49 @@
+#include "VariableDelay.h"
+
+VariableDelay::VariableDelay() :
+    VariableDelay(0)
+{
+}
+
+VariableDelay::VariableDelay(int maximumDelayInSamples)
+{
+    jassert(maximumDelayInSamples >= 0);
+    setMaximumDelayInSamples(maximumDelayInSamples);
+}
+
+void VariableDelay::prepare(const juce::dsp::ProcessSpec &spec)
+{
+    jassert(spec.numChannels > 0);
+
+    bufferData.setSize(static_cast<int>(spec.numChannels), totalSize, false, false, true);
+    writePos.resize(spec.numChannels);
+    readPos.resize(spec.numChannels);
+
+    reset();
+}
+
+void VariableDelay::reset()
+{
+    std::fill(writePos.begin(), writePos.end(), 0);
+    std::fill(readPos.begin(), readPos.end(), 0);
+    bufferData.clear();
+}
+
+void VariableDelay::setMaximumDelayInSamples(int maxDelayInSamples)
+{
+    jassert(maxDelayInSamples >= 0);
+    totalSize = juce::jmax(4, maxDelayInSamples + 2);
+    bufferData.setSize(bufferData.getNumChannels(), totalSize, false, false, true);
+    reset();
+}
+
+void VariableDelay::setDelay(float newDelayInSamples)
+{
+    auto upperLimit = static_cast<float>(getMaximumDelayInSamples());
+    jassert(juce::isPositiveAndNotGreaterThan(newDelayInSamples, upperLimit));
+
+    // The Lagrange read offset is applied per sample, so the order can change at any time
+    delay = juce::jlimit(0.0f, upperLimit, newDelayInSamples);
+    delayInt = static_cast<int>(std::floor(delay));
+    delayFrac = delay - static_cast<float>(delayInt);
+}
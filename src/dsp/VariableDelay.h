@@ -0,0 +1,115 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/**
+ * Multi-channel delay line with an interpolation order that can be changed
+ * while processing. Matches juce::dsp::DelayLine (push, then pop) sample for
+ * sample for the Lagrange3rd and Linear interpolation types.
+ */
+class VariableDelay
+{
+    public:
+        enum class Interpolation
+        {
+            linear,
+            lagrange3rd
+        };
+
+        VariableDelay();
+        explicit VariableDelay(int maximumDelayInSamples);
+
+        void prepare(const juce::dsp::ProcessSpec &spec);
+        void reset();
+
+        void setMaximumDelayInSamples(int maxDelayInSamples);
+        int  getMaximumDelayInSamples() const noexcept { return totalSize - 2; }
+
+        void  setDelay(float newDelayInSamples);
+        float getDelay() const noexcept { return delay; }
+
+        void setInterpolation(Interpolation newInterpolation) noexcept { interpolation = newInterpolation; }
+        Interpolation getInterpolation() const noexcept { return interpolation; }
+
+        void pushSample(int channel, float sample)
+        {
+            bufferData.setSample(channel, writePos[(size_t) channel], sample);
+            writePos[(size_t) channel] = (writePos[(size_t) channel] + totalSize - 1) % totalSize;
+        }
+
+        float popSample(int channel)
+        {
+            auto result = (interpolation == Interpolation::lagrange3rd) ? interpolateLagrange(channel)
+                                                                        : interpolateLinear(channel);
+            readPos[(size_t) channel] = (readPos[(size_t) channel] + totalSize - 1) % totalSize;
+            return result;
+        }
+
+    private:
+        float interpolateLinear(int channel) const
+        {
+            auto index1 = readPos[(size_t) channel] + delayInt;
+            auto index2 = index1 + 1;
+
+            if (index2 >= totalSize)
+            {
+                index1 %= totalSize;
+                index2 %= totalSize;
+            }
+
+            const auto *samples = bufferData.getReadPointer(channel);
+            auto value1 = samples[index1];
+            auto value2 = samples[index2];
+
+            return value1 + delayFrac * (value2 - value1);
+        }
+
+        float interpolateLagrange(int channel) const
+        {
+            // Lagrange reads one sample earlier, centring the kernel on the fractional delay
+            auto lagrangeInt = delayInt;
+            auto lagrangeFrac = delayFrac;
+            if (lagrangeInt >= 1)
+            {
+                lagrangeFrac++;
+                lagrangeInt--;
+            }
+
+            auto index1 = readPos[(size_t) channel] + lagrangeInt;
+            auto index2 = index1 + 1;
+            auto index3 = index2 + 1;
+            auto index4 = index3 + 1;
+
+            if (index4 >= totalSize)
+            {
+                index1 %= totalSize;
+                index2 %= totalSize;
+                index3 %= totalSize;
+                index4 %= totalSize;
+            }
+
+            const auto *samples = bufferData.getReadPointer(channel);
+            auto value1 = samples[index1];
+            auto value2 = samples[index2];
+            auto value3 = samples[index3];
+            auto value4 = samples[index4];
+
+            auto d1 = lagrangeFrac - 1.f;
+            auto d2 = lagrangeFrac - 2.f;
+            auto d3 = lagrangeFrac - 3.f;
+
+            auto c1 = -d1 * d2 * d3 / 6.f;
+            auto c2 = d2 * d3 * 0.5f;
+            auto c3 = -d1 * d3 * 0.5f;
+            auto c4 = d1 * d2 / 6.f;
+
+            return value1 * c1 + lagrangeFrac * (value2 * c2 + value3 * c3 + value4 * c4);
+        }
+
+        juce::AudioBuffer<float> bufferData;
+        std::vector<int> writePos, readPos;
+        float delay = 0.0f, delayFrac = 0.0f;
+        int delayInt = 0, totalSize = 4;
+        Interpolation interpolation = Interpolation::lagrange3rd;
+};
@@ -30,15 +30,16 @@ void NetworkGraphAnimation::setTreePositions(std::vector<int> &treePositions)
     this->treePositions = treePositions;
 }
 
-void NetworkGraphAnimation::setBandStates(const std::vector<DelayNodes::BandResources> &states)
+void NetworkGraphAnimation::setBandStates(const std::vector<DelayNodes::BandResources> &states, const ConnectionMatrix &connections)
 {
     // Clear existing snapshots
     bandStateSnapshots.clear();
 
     // Convert BandResources to our snapshots
-    for (const auto &state : states)
+    const auto numBands = static_cast<int>(states.size());
+    for (int band = 0; band < numBands; ++band)
     {
-        bandStateSnapshots.push_back(BandStateSnapshot::fromBandResources(state));
+        bandStateSnapshots.push_back(BandStateSnapshot::fromBandResources(states[static_cast<size_t>(band)], connections, band, numBands));
     }
 }
 
@@ -33,7 +33,7 @@ class NetworkGraphAnimation : public juce::Component
         void setTreePositions(std::vector<int> &treePositions);
 
         // Update with new band states
-        void setBandStates(const std::vector<DelayNodes::BandResources> &states);
+        void setBandStates(const std::vector<DelayNodes::BandResources> &states, const ConnectionMatrix &connections);
 
         // Paint the network graph
         void paint(juce::Graphics &g) override;
@@ -66,14 +66,28 @@ class NetworkGraphAnimation : public juce::Component
             std::vector<float> treeConnections;
             std::vector<std::vector<std::vector<float>>> interNodeConnections;
 
-            // Helper method to extract just what we need from BandResources
-            static BandStateSnapshot fromBandResources(const DelayNodes::BandResources &resource)
+            // Helper method to extract just what we need from BandResources, with the connections into the band
+            static BandStateSnapshot fromBandResources(const DelayNodes::BandResources &resource, const ConnectionMatrix &connections,
+                                                       int band, int numBands)
             {
                 BandStateSnapshot snapshot;
                 snapshot.bufferLevels = resource.bufferLevels;
                 snapshot.nodeDelayTimes = resource.nodeDelayTimes;
                 snapshot.treeConnections = resource.treeConnections;
-                snapshot.interNodeConnections = resource.interNodeConnections;
+
+                const auto numNodes = resource.bufferLevels.size();
+                snapshot.interNodeConnections.assign(numNodes, std::vector<std::vector<float>>(static_cast<size_t>(numBands), std::vector<float>(numNodes, 0.0f)));
+                for (size_t proc = 0; proc < numNodes; ++proc)
+                {
+                    for (int srcBand = 0; srcBand < numBands; ++srcBand)
+                    {
+                        for (size_t srcProc = 0; srcProc < numNodes; ++srcProc)
+                        {
+                            snapshot.interNodeConnections[proc][static_cast<size_t>(srcBand)][srcProc] =
+                                connections.get(DelayNodes::getNodeIndex(band, proc), DelayNodes::getNodeIndex(srcBand, srcProc));
+                        }
+                    }
+                }
                 return snapshot;
             }
         };
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * Draws an index with a probability proportional to its weight in constant time,
+ * from a table built in linear time (Walker's alias method, built as in Vose).
+ *
+ * Every slot holds the probability of keeping its own index, and the index to
+ * take instead: a draw picks a slot uniformly and then one of the two.
+ */
+class AliasTable
+{
+    public:
+        // Allocates only when the number of weights grows. Negative weights count as zero,
+        // returns false (and empties the table) when no weight is positive
+        bool build(const std::vector<float> &weights)
+        {
+            const auto n = weights.size();
+            totalWeight = 0.0f;
+            for (auto weight : weights)
+            {
+                totalWeight += juce::jmax(0.0f, weight);
+            }
+
+            if (totalWeight <= 0.0f)
+            {
+                thresholds.clear();
+                aliases.clear();
+                return false;
+            }
+
+            // Scale the weights to average one, and sort the slots into those below and above it
+            thresholds.resize(n);
+            aliases.resize(n);
+            small.clear();
+            large.clear();
+            const auto scale = static_cast<float>(n) / totalWeight;
+            for (size_t i = 0; i < n; ++i)
+            {
+                thresholds[i] = juce::jmax(0.0f, weights[i]) * scale;
+                aliases[i] = static_cast<int>(i);
+                (thresholds[i] < 1.0f ? small : large).push_back(static_cast<int>(i));
+            }
+
+            // Top up every small slot with the excess of a large one
+            while (!small.empty() && !large.empty())
+            {
+                const auto less = small.back();
+                const auto more = large.back();
+                small.pop_back();
+                large.pop_back();
+
+                aliases[static_cast<size_t>(less)] = more;
+                auto &excess = thresholds[static_cast<size_t>(more)];
+                excess = (excess + thresholds[static_cast<size_t>(less)]) - 1.0f;
+                (excess < 1.0f ? small : large).push_back(more);
+            }
+
+            // Whatever is left is full, up to rounding
+            for (auto i : small)
+            {
+                thresholds[static_cast<size_t>(i)] = 1.0f;
+            }
+            for (auto i : large)
+            {
+                thresholds[static_cast<size_t>(i)] = 1.0f;
+            }
+            return true;
+        }
+
+        // Make room for up to numWeights weights, so building does not allocate
+        void reserve(size_t numWeights)
+        {
+            thresholds.reserve(numWeights);
+            aliases.reserve(numWeights);
+            small.reserve(numWeights);
+            large.reserve(numWeights);
+        }
+
+        // Only call on a table that has been built with a positive weight
+        int sample(juce::Random &random) const
+        {
+            jassert(!thresholds.empty());
+            const auto slot = random.nextInt(static_cast<int>(thresholds.size()));
+            return (random.nextFloat() < thresholds[static_cast<size_t>(slot)]) ? slot : aliases[static_cast<size_t>(slot)];
+        }
+
+        bool isEmpty() const { return thresholds.empty(); }
+        size_t size() const { return thresholds.size(); }
+
+        // Sum of the weights the table was built from
+        float getTotalWeight() const { return totalWeight; }
+
+    private:
+        std::vector<float> thresholds;
+        std::vector<int> aliases;
+        std::vector<int> small, large;   // Scratch space for build()
+        float totalWeight = 0.0f;
+};
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "sst/basic-blocks/simd/setup.h"
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Polynomial approximations of the libm functions used on the audio and
+ * control paths, as scalar inlines and as SIMD kernels over four lanes.
+ *
+ * Accuracy (checked against libm in tests/FastMath.cpp):
+ *  - exp2, exp, dbToGain: about 3e-6 relative error
+ *  - log2, log: about 1e-6 absolute error (gainToDb: 1e-5 dB)
+ *  - sin: about 5e-6 absolute error
+ *  - tanh: about 2e-6 absolute error
+ *
+ * Arguments outside the float exponent range are clamped rather than
+ * producing infinities, log2 of zero or a negative number gives -126.
+ */
+namespace FastMath
+{
+    // Same floor as juce::Decibels
+    static constexpr float minusInfinityDb = -100.0f;
+
+    namespace detail
+    {
+        static constexpr float log2Of10Over20 = 0.166096404744f;  // dB to log2 of gain
+        static constexpr float twentyLog10Of2 = 6.020599913280f;  // log2 of gain to dB
+        static constexpr float log2e = 1.442695040889f;
+        static constexpr float ln2 = 0.693147180560f;
+        static constexpr float sqrt2 = 1.414213562373f;
+        static constexpr float inverseTwoPi = 0.159154943092f;
+
+        // 2^f for f in [-0.5, 0.5]
+        static constexpr float exp2c1 = 0.693147180560f;
+        static constexpr float exp2c2 = 0.240226506959f;
+        static constexpr float exp2c3 = 0.055504108665f;
+        static constexpr float exp2c4 = 0.009618129108f;
+        static constexpr float exp2c5 = 0.001333355815f;
+
+        // log2(m) = t * (c1 + c3 t^2 + ...) with t = (m - 1) / (m + 1), for m in [sqrt(1/2), sqrt(2)]
+        static constexpr float log2c1 = 2.885390081778f;
+        static constexpr float log2c3 = 0.961796693926f;
+        static constexpr float log2c5 = 0.577078016356f;
+        static constexpr float log2c7 = 0.412198583111f;
+
+        // sin(pi/2 t) for t in [-1, 1]
+        static constexpr float sinc1 = 1.570796326795f;
+        static constexpr float sinc3 = -0.645964097506f;
+        static constexpr float sinc5 = 0.079692626246f;
+        static constexpr float sinc7 = -0.004681754135f;
+        static constexpr float sinc9 = 0.000160441184f;
+    }
+
+    // Only SIMD registers take the vector overloads, so doubles don't end up in them
+    template <typename Vector>
+    concept SimdVector = !std::is_arithmetic_v<Vector>;
+
+    //==============================================================================
+    // Scalar
+
+    // For arguments within the int range
+    inline float floor(float x)
+    {
+        const auto truncated = static_cast<float>(static_cast<int32_t>(x));
+        return truncated > x ? truncated - 1.0f : truncated;
+    }
+
+    inline float exp2(float x)
+    {
+        x = juce::jlimit(-126.0f, 126.0f, x);
+        const auto exponent = static_cast<int32_t>(floor(x + 0.5f));
+        const auto f = x - static_cast<float>(exponent);
+        const auto p = 1.0f + f * (detail::exp2c1 + f * (detail::exp2c2 + f * (detail::exp2c3 + f * (detail::exp2c4 + f * detail::exp2c5))));
+        return p * std::bit_cast<float>(static_cast<uint32_t>(exponent + 127) << 23);
+    }
+
+    inline float log2(float x)
+    {
+        const auto bits = std::bit_cast<uint32_t>(juce::jmax(x, std::numeric_limits<float>::min()));
+        auto exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+        auto m = std::bit_cast<float>((bits & 0x007fffffu) | 0x3f800000u);
+        if (m > detail::sqrt2)
+        {
+            m *= 0.5f;
+            exponent += 1.0f;
+        }
+        const auto t = (m - 1.0f) / (m + 1.0f);
+        const auto t2 = t * t;
+        return exponent + t * (detail::log2c1 + t2 * (detail::log2c3 + t2 * (detail::log2c5 + t2 * detail::log2c7)));
+    }
+
+    inline float exp(float x) { return exp2(x * detail::log2e); }
+    inline float log(float x) { return log2(x) * detail::ln2; }
+
+    // base must be positive
+    inline float pow(float base, float exponent) { return exp2(exponent * log2(base)); }
+
+    inline float dbToGain(float db, float minusInfDb = minusInfinityDb)
+    {
+        return db > minusInfDb ? exp2(db * detail::log2Of10Over20) : 0.0f;
+    }
+
+    inline float gainToDb(float gain, float minusInfDb = minusInfinityDb)
+    {
+        return gain > 0.0f ? juce::jmax(minusInfDb, detail::twentyLog10Of2 * log2(gain)) : minusInfDb;
+    }
+
+    // sin(2 pi cycles): folds the phase into a triangle t with sin(2 pi cycles) = sin(pi/2 t)
+    inline float sinCycles(float cycles)
+    {
+        auto q = cycles + 0.25f;
+        q -= floor(q);
+        const auto t = 1.0f - std::abs(4.0f * q - 2.0f);
+        const auto t2 = t * t;
+        return t * (detail::sinc1 + t2 * (detail::sinc3 + t2 * (detail::sinc5 + t2 * (detail::sinc7 + t2 * detail::sinc9))));
+    }
+
+    inline float sin(float radians) { return sinCycles(radians * detail::inverseTwoPi); }
+
+    inline float tanh(float x)
+    {
+        const auto e = exp2(juce::jlimit(-9.0f, 9.0f, x) * (2.0f * detail::log2e));
+        return (e - 1.0f) / (e + 1.0f);
+    }
+
+    //==============================================================================
+    // Four lanes at a time
+
+    // Largest integer not above each lane (the SSE2 conversions truncate towards zero)
+    template <SimdVector Vector>
+    inline Vector floor(Vector x)
+    {
+        const auto truncated = SIMD_MM(cvtepi32_ps)(SIMD_MM(cvttps_epi32)(x));
+        return SIMD_MM(sub_ps)(truncated, SIMD_MM(and_ps)(SIMD_MM(cmpgt_ps)(truncated, x), SIMD_MM(set1_ps)(1.0f)));
+    }
+
+    template <SimdVector Vector>
+    inline Vector exp2(Vector x)
+    {
+        x = SIMD_MM(min_ps)(SIMD_MM(max_ps)(x, SIMD_MM(set1_ps)(-126.0f)), SIMD_MM(set1_ps)(126.0f));
+        const auto exponent = SIMD_MM(cvtps_epi32)(x); // Rounds to nearest
+        const auto f = SIMD_MM(sub_ps)(x, SIMD_MM(cvtepi32_ps)(exponent));
+
+        auto p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::exp2c4), SIMD_MM(mul_ps)(f, SIMD_MM(set1_ps)(detail::exp2c5)));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::exp2c3), SIMD_MM(mul_ps)(f, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::exp2c2), SIMD_MM(mul_ps)(f, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::exp2c1), SIMD_MM(mul_ps)(f, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(1.0f), SIMD_MM(mul_ps)(f, p));
+
+        const auto scale = SIMD_MM(castsi128_ps)(SIMD_MM(slli_epi32)(SIMD_MM(add_epi32)(exponent, SIMD_MM(set1_epi32)(127)), 23));
+        return SIMD_MM(mul_ps)(p, scale);
+    }
+
+    template <SimdVector Vector>
+    inline Vector log2(Vector x)
+    {
+        const auto bits = SIMD_MM(castps_si128)(SIMD_MM(max_ps)(x, SIMD_MM(set1_ps)(std::numeric_limits<float>::min())));
+        auto exponent = SIMD_MM(cvtepi32_ps)(SIMD_MM(sub_epi32)(SIMD_MM(srli_epi32)(bits, 23), SIMD_MM(set1_epi32)(127)));
+        auto m = SIMD_MM(castsi128_ps)(SIMD_MM(or_si128)(SIMD_MM(and_si128)(bits, SIMD_MM(set1_epi32)(0x007fffff)),
+                                                         SIMD_MM(set1_epi32)(0x3f800000)));
+
+        // Centre the mantissa on 1
+        const auto large = SIMD_MM(cmpgt_ps)(m, SIMD_MM(set1_ps)(detail::sqrt2));
+        m = SIMD_MM(sub_ps)(m, SIMD_MM(and_ps)(large, SIMD_MM(mul_ps)(m, SIMD_MM(set1_ps)(0.5f))));
+        exponent = SIMD_MM(add_ps)(exponent, SIMD_MM(and_ps)(large, SIMD_MM(set1_ps)(1.0f)));
+
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        const auto t = SIMD_MM(div_ps)(SIMD_MM(sub_ps)(m, one), SIMD_MM(add_ps)(m, one));
+        const auto t2 = SIMD_MM(mul_ps)(t, t);
+        auto p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::log2c5), SIMD_MM(mul_ps)(t2, SIMD_MM(set1_ps)(detail::log2c7)));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::log2c3), SIMD_MM(mul_ps)(t2, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::log2c1), SIMD_MM(mul_ps)(t2, p));
+        return SIMD_MM(add_ps)(exponent, SIMD_MM(mul_ps)(t, p));
+    }
+
+    template <SimdVector Vector>
+    inline Vector sinCycles(Vector cycles)
+    {
+        auto q = SIMD_MM(add_ps)(cycles, SIMD_MM(set1_ps)(0.25f));
+        q = SIMD_MM(sub_ps)(q, floor(q));
+
+        const auto centred = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(SIMD_MM(set1_ps)(4.0f), q), SIMD_MM(set1_ps)(2.0f));
+        const auto t = SIMD_MM(sub_ps)(SIMD_MM(set1_ps)(1.0f), SIMD_MM(max_ps)(centred, SIMD_MM(sub_ps)(SIMD_MM(setzero_ps)(), centred)));
+        const auto t2 = SIMD_MM(mul_ps)(t, t);
+
+        auto p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::sinc7), SIMD_MM(mul_ps)(t2, SIMD_MM(set1_ps)(detail::sinc9)));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::sinc5), SIMD_MM(mul_ps)(t2, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::sinc3), SIMD_MM(mul_ps)(t2, p));
+        p = SIMD_MM(add_ps)(SIMD_MM(set1_ps)(detail::sinc1), SIMD_MM(mul_ps)(t2, p));
+        return SIMD_MM(mul_ps)(t, p);
+    }
+
+    template <SimdVector Vector>
+    inline Vector tanh(Vector x)
+    {
+        const auto clamped = SIMD_MM(min_ps)(SIMD_MM(max_ps)(x, SIMD_MM(set1_ps)(-9.0f)), SIMD_MM(set1_ps)(9.0f));
+        const auto e = exp2(SIMD_MM(mul_ps)(clamped, SIMD_MM(set1_ps)(2.0f * detail::log2e)));
+        const auto one = SIMD_MM(set1_ps)(1.0f);
+        return SIMD_MM(div_ps)(SIMD_MM(sub_ps)(e, one), SIMD_MM(add_ps)(e, one));
+    }
+
+    //==============================================================================
+    // Arrays (any length and alignment, the tail is done one sample at a time)
+
+    namespace detail
+    {
+        template <typename VectorOp, typename ScalarOp>
+        inline void applyToArray(const float *input, float *output, size_t numValues, VectorOp vectorOp, ScalarOp scalarOp)
+        {
+            size_t i = 0;
+            for (; i + 4 <= numValues; i += 4)
+            {
+                SIMD_MM(storeu_ps)(output + i, vectorOp(SIMD_MM(loadu_ps)(input + i)));
+            }
+            for (; i < numValues; ++i)
+            {
+                output[i] = scalarOp(input[i]);
+            }
+        }
+    }
+
+    inline void exp2(const float *input, float *output, size_t numValues)
+    {
+        detail::applyToArray(input, output, numValues,
+                             [](auto x) { return exp2(x); },
+                             [](float x) { return exp2(x); });
+    }
+
+    inline void dbToGain(const float *db, float *gain, size_t numValues)
+    {
+        detail::applyToArray(db, gain, numValues,
+                             [](auto x)
+                             {
+                                 const auto audible = SIMD_MM(cmpgt_ps)(x, SIMD_MM(set1_ps)(minusInfinityDb));
+                                 return SIMD_MM(and_ps)(audible, exp2(SIMD_MM(mul_ps)(x, SIMD_MM(set1_ps)(detail::log2Of10Over20))));
+                             },
+                             [](float x) { return dbToGain(x); });
+    }
+
+    inline void gainToDb(const float *gain, float *db, size_t numValues)
+    {
+        detail::applyToArray(gain, db, numValues,
+                             [](auto x)
+                             {
+                                 // log2 clamps to the smallest normal, which is far below the floor
+                                 const auto y = SIMD_MM(mul_ps)(log2(x), SIMD_MM(set1_ps)(detail::twentyLog10Of2));
+                                 return SIMD_MM(max_ps)(y, SIMD_MM(set1_ps)(minusInfinityDb));
+                             },
+                             [](float x) { return gainToDb(x); });
+    }
+
+    inline void sinCycles(const float *cycles, float *output, size_t numValues)
+    {
+        detail::applyToArray(cycles, output, numValues,
+                             [](auto x) { return sinCycles(x); },
+                             [](float x) { return sinCycles(x); });
+    }
+
+    inline void tanh(const float *input, float *output, size_t numValues)
+    {
+        detail::applyToArray(input, output, numValues,
+                             [](auto x) { return tanh(x); },
+                             [](float x) { return tanh(x); });
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+// A parameter change at a sample position within the current block
+struct ParameterEvent
+{
+    int paramIndex = 0;
+    float value = 0.0f;
+    int sampleOffset = 0;
+};
+
+/**
+ * Lock-free single-producer, single-consumer queue of parameter events.
+ * Neither side allocates or blocks: events pushed to a full queue are dropped.
+ */
+template <int Capacity>
+class ParameterEventQueue
+{
+    public:
+        ParameterEventQueue() = default;
+
+        bool push(const ParameterEvent &event)
+        {
+            const auto scope = fifo.write(1);
+            if (scope.blockSize1 > 0)
+            {
+                events[static_cast<size_t>(scope.startIndex1)] = event;
+                return true;
+            }
+            if (scope.blockSize2 > 0)
+            {
+                events[static_cast<size_t>(scope.startIndex2)] = event;
+                return true;
+            }
+            return false;
+        }
+
+        bool pop(ParameterEvent &event)
+        {
+            const auto scope = fifo.read(1);
+            if (scope.blockSize1 > 0)
+            {
+                event = events[static_cast<size_t>(scope.startIndex1)];
+                return true;
+            }
+            if (scope.blockSize2 > 0)
+            {
+                event = events[static_cast<size_t>(scope.startIndex2)];
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        juce::AbstractFifo fifo {Capacity};
+        std::array<ParameterEvent, Capacity> events;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterEventQueue)
+};
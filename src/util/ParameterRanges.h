@@ -2,6 +2,8 @@
 
 #include <juce_dsp/juce_dsp.h>
 #include "util/TempoSyncUtils.h"
+#include "util/FastMath.h"
+#include <algorithm>
 
 // Functions to convert between 0-1 and the actual range for ranges that are inverted
 static constexpr auto invertedConvertFrom0To1Func = [](float start, float end, float value)
@@ -23,11 +25,11 @@ static constexpr auto invertedSnapToLegalValueFunction = [](float start, float e
 
 static constexpr auto convertFrom0To1LogFunc = [](float start, float end, float normalised, float logBase)
 {
-    return start + (std::pow(2.0f, normalised * logBase) - 1.0f) * (end - start) / (std::pow(2.0f, logBase) - 1.0f);
+    return start + (FastMath::exp2(normalised * logBase) - 1.0f) * (end - start) / (FastMath::exp2(logBase) - 1.0f);
 };
 static constexpr auto convertTo0To1LogFunc = [](float start, float end, float value, float logBase)
 {
-    return (std::log(((value - start) * (std::pow(2.0f, 2.0f) - 1.0f) / (end - start)) + 1.0f) / std::log(logBase)) / 2.0f;
+    return (FastMath::log2(((value - start) * (4.0f - 1.0f) / (end - start)) + 1.0f) / FastMath::log2(logBase)) / 2.0f;
 };
 
 namespace ParameterRanges
@@ -196,6 +198,39 @@ namespace ParameterRanges
         return -static_cast<float>(rhythm.tempoFactor);
     }
 
+    // Stretch to 0-1: the top half is continuous, the bottom half holds the quantised rhythms
+    inline float convertStretchTo0To1(float end, float value)
+    {
+        if (value >= centreStretch) {
+            // Values above center: map center-max to 0.5-1.0
+            return 0.5f + 0.5f * (value - centreStretch) / (end - centreStretch);
+        } else {
+            // For negative values, find the closest rhythm in our array
+            float absValue = std::abs(value);
+
+            // Find the rhythm with the closest tempo factor to our value
+            size_t closestIndex = 0;
+            float closestDiff = std::numeric_limits<float>::max();
+
+            for (size_t i = 0; i < TempoSyncUtils::rhythms.size(); ++i) {
+                float diff = std::abs(static_cast<float>(TempoSyncUtils::rhythms[i].tempoFactor) - absValue);
+                if (diff < closestDiff) {
+                    closestDiff = diff;
+                    closestIndex = i;
+                }
+            }
+
+            // Inverting the formula from getRhythmForParam:
+            // idx = (rhythms.size() - 1) * std::pow(param01, 1.5f)
+            // param01 = std::pow(idx / (rhythms.size() - 1), 1.0f/1.5f)
+            float param01 = std::pow(static_cast<float>(closestIndex) /
+                                     static_cast<float>(TempoSyncUtils::rhythms.size() - 1),
+                                     1.0f / 1.5f);
+
+            return param01 * 0.5f; // Scale to 0-0.5 range
+        }
+    }
+
     // Universe controls
     inline const juce::NormalisableRange<float> stretchRange(minStretch, maxStretch,
         // Convert from normalized 0-1 to actual value
@@ -211,36 +246,7 @@ namespace ParameterRanges
             }
         },
         // Convert from actual value to normalized 0-1
-        [](float start, float end, float value) {
-            if (value >= centreStretch) {
-                // Values above center: map center-max to 0.5-1.0
-                return 0.5f + 0.5f * (value - centreStretch) / (end - centreStretch);
-            } else {
-                // For negative values, find the closest rhythm in our array
-                float absValue = std::abs(value);
-
-                // Find the rhythm with the closest tempo factor to our value
-                size_t closestIndex = 0;
-                float closestDiff = std::numeric_limits<float>::max();
-
-                for (size_t i = 0; i < TempoSyncUtils::rhythms.size(); ++i) {
-                    float diff = std::abs(static_cast<float>(TempoSyncUtils::rhythms[i].tempoFactor) - absValue);
-                    if (diff < closestDiff) {
-                        closestDiff = diff;
-                        closestIndex = i;
-                    }
-                }
-
-                // Inverting the formula from getRhythmForParam:
-                // idx = (rhythms.size() - 1) * std::pow(param01, 1.5f)
-                // param01 = std::pow(idx / (rhythms.size() - 1), 1.0f/1.5f)
-                float param01 = std::pow(static_cast<float>(closestIndex) /
-                                         static_cast<float>(TempoSyncUtils::rhythms.size() - 1),
-                                         1.0f / 1.5f);
-
-                return param01 * 0.5f; // Scale to 0-0.5 range
-            }
-        },
+        [](float start, float end, float value) { return convertStretchTo0To1(end, value); },
         // Snap to legal value function
         [](float start, float end, float value) {
             // Always snap to exact quantized values in bottom half (negative values)
@@ -310,6 +316,75 @@ namespace ParameterRanges
     inline const juce::NormalisableRange<float> dryWetRange(minDryWet, maxDryWet, 0.01f);
     inline const juce::NormalisableRange<float> delayDuckRange(minDelayDuckLevel, maxDelayDuckLevel, 0.01f);
 
+    ////////////////////////// MAPPINGS ///////////////////////////////
+    // Closed-form copies of the ranges read on the audio and timer threads, without the
+    // std::function dispatch of NormalisableRange. They follow the NormalisableRange
+    // conversions step for step, so the results are identical (checked in tests/ParameterMappings.cpp)
+
+    // A plain linear range
+    struct LinearMapping
+    {
+        float start = 0.0f;
+        float end = 1.0f;
+
+        constexpr float normalise(float value) const
+        {
+            return std::clamp((value - start) / (end - start), 0.0f, 1.0f);
+        }
+
+        constexpr float denormalise(float proportion) const
+        {
+            return start + (end - start) * std::clamp(proportion, 0.0f, 1.0f);
+        }
+    };
+
+    // A range with a (non-symmetric) skew, as made by rangeWithSkewForCentre
+    struct SkewedMapping
+    {
+        float start = 0.0f;
+        float end = 1.0f;
+        float skew = 1.0f;
+
+        explicit SkewedMapping(const juce::NormalisableRange<float> &range)
+            : start(range.start), end(range.end), skew(range.skew)
+        {
+            jassert(!range.symmetricSkew);
+        }
+
+        float normalise(float value) const
+        {
+            const auto proportion = std::clamp((value - start) / (end - start), 0.0f, 1.0f);
+            return (skew == 1.0f) ? proportion : std::pow(proportion, skew);
+        }
+
+        float denormalise(float proportion) const
+        {
+            proportion = std::clamp(proportion, 0.0f, 1.0f);
+            if (!juce::approximatelyEqual(skew, 1.0f) && proportion > 0.0f)
+            {
+                proportion = std::exp(std::log(proportion) / skew);
+            }
+            return start + (end - start) * proportion;
+        }
+    };
+
+    // The stretch range: linear in its top half, a rhythm search below the centre
+    struct StretchMapping
+    {
+        float normalise(float value) const
+        {
+            return std::clamp(convertStretchTo0To1(maxStretch, value), 0.0f, 1.0f);
+        }
+    };
+
+    inline constexpr LinearMapping scarcityAbundanceMapping {minScarcityAbundance, maxScarcityAbundance};
+    inline constexpr LinearMapping treeDensityMapping {minTreeDensity, maxTreeDensity};
+    inline constexpr LinearMapping dryWetMapping {minDryWet, maxDryWet};
+    inline constexpr LinearMapping delayDuckMapping {minDelayDuckLevel, maxDelayDuckLevel};
+    inline constexpr StretchMapping stretchMapping {};
+    inline const SkewedMapping entanglementMapping {entanglementRange};
+    inline const SkewedMapping growthRateMapping {growthRateRange};
+
     // Utility functions
     inline float normalizeParameter(const juce::NormalisableRange<float>& range, float value)
     {
@@ -12,4 +12,11 @@ namespace Utils
         param.reset(fs, rampTimeSec);
         param.setTargetValue(targetValue);
     }
+
+    // Absolute peak level of a block, across all channels
+    inline float getPeakLevel(const juce::dsp::AudioBlock<float> &block)
+    {
+        const auto range = block.findMinAndMax();
+        return juce::jmax(-range.getStart(), range.getEnd());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "util/AliasTable.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <vector>
+
+TEST_CASE ("Alias table draws in proportion to the weights", "[alias]")
+{
+    using Catch::Matchers::WithinAbs;
+
+    const std::vector<float> weights {0.5f, 0.0f, 3.0f, 1.0f, 0.25f, 0.0f, 2.0f, 0.25f, -1.0f};
+    AliasTable table;
+    REQUIRE (table.build(weights));
+    CHECK (table.size() == weights.size());
+    CHECK_THAT (table.getTotalWeight(), WithinAbs(7.0, 1.0e-6));
+
+    juce::Random random(1234);
+    constexpr int numDraws = 200000;
+    std::vector<int> counts(weights.size(), 0);
+    for (int i = 0; i < numDraws; ++i)
+    {
+        ++counts[static_cast<size_t>(table.sample(random))];
+    }
+
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        const auto expected = juce::jmax(0.0f, weights[i]) / table.getTotalWeight();
+        if (expected == 0.0f)
+        {
+            // Zero and negative weights are never drawn
+            CHECK (counts[i] == 0);
+        }
+        else
+        {
+            CHECK_THAT (static_cast<double>(counts[i]) / numDraws, WithinAbs(expected, 0.005));
+        }
+    }
+}
+
+TEST_CASE ("Alias table without a positive weight is empty", "[alias]")
+{
+    AliasTable table;
+    REQUIRE (table.build({1.0f, 2.0f}));
+    CHECK_FALSE (table.build({0.0f, -1.0f, 0.0f}));
+    CHECK (table.isEmpty());
+    CHECK_FALSE (table.build({}));
+}
@@ -0,0 +1,191 @@
+#include "helpers/test_helpers.h"
+#include <Mycelia.h>
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+    #include <dlfcn.h>
+    #include <pthread.h>
+#endif
+
+/* Audio thread safety checks
+ *
+ * The global allocation functions (and, on Linux, pthread_mutex_lock) are replaced for the
+ * whole test binary. They only count calls made on a thread while it is inside a guarded
+ * processBlock call, so the message thread, the control scheduler and Catch2 itself are free
+ * to allocate and lock as usual.
+ *
+ * Offline the control timers run inline at the start of each block, so everything they do
+ * (topology changes, freeze captures) is held to the same rules as the processing itself.
+ */
+namespace
+{
+    thread_local bool audioThreadGuarded = false;
+    std::atomic<int> audioThreadAllocations {0};
+    std::atomic<int> audioThreadLocks {0};
+
+    struct AudioThreadGuard
+    {
+        AudioThreadGuard() { audioThreadGuarded = true; }
+        ~AudioThreadGuard() { audioThreadGuarded = false; }
+    };
+
+    bool isCheckedCall()
+    {
+        return audioThreadGuarded;
+    }
+
+    void *allocate(std::size_t size)
+    {
+        if (isCheckedCall())
+        {
+            ++audioThreadAllocations;
+        }
+
+        if (auto *ptr = std::malloc(size == 0 ? 1 : size))
+        {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void *ptr) noexcept
+    {
+        if (isCheckedCall() && ptr != nullptr)
+        {
+            ++audioThreadAllocations;
+        }
+        std::free(ptr);
+    }
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { deallocate(ptr); }
+
+#if defined(__linux__)
+namespace
+{
+    using MutexLockFunction = int (*)(pthread_mutex_t *);
+
+    // Looked up lazily without a function-local static, whose guard could itself take a mutex
+    std::atomic<MutexLockFunction> realMutexLock {nullptr};
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    auto lockFunction = realMutexLock.load();
+    if (lockFunction == nullptr)
+    {
+        lockFunction = reinterpret_cast<MutexLockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realMutexLock = lockFunction;
+    }
+
+    if (isCheckedCall())
+    {
+        ++audioThreadLocks;
+    }
+    return lockFunction(mutex);
+}
+#endif
+
+TEST_CASE ("processBlock neither allocates nor locks", "[realtime]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 400;
+
+    Mycelia plugin;
+
+    SECTION ("Realtime")
+    {
+        plugin.setNonRealtime(false);
+    }
+
+    SECTION ("Offline")
+    {
+        plugin.setNonRealtime(true);
+    }
+
+    plugin.prepareToPlay(sampleRate, blockSize);
+
+    const auto numChannels = plugin.getTotalNumOutputChannels();
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    midi.ensureSize(4096);
+
+    juce::Random random(1234);
+    const auto &parameters = plugin.getParameters();
+
+    auto fillBlock = [&](int blockIndex)
+    {
+        // Noise bursts with silent gaps, so the silence gate opens and closes
+        buffer.clear();
+        if ((blockIndex / 16) % 4 != 3)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                }
+            }
+        }
+
+        // Bursts of MIDI CCs at random positions in the block
+        midi.clear();
+        for (int cc = 0; cc < 20; ++cc)
+        {
+            midi.addEvent(juce::MidiMessage::controllerEvent(1, cc, random.nextInt(128)), random.nextInt(blockSize));
+        }
+        midi.addEvent(juce::MidiMessage::midiClock(), random.nextInt(blockSize));
+    };
+
+    auto automateParameters = [&]()
+    {
+        // Host automation of a few parameters per block (the APVTS notifies its listeners here)
+        for (int i = 0; i < 4; ++i)
+        {
+            auto *parameter = parameters[random.nextInt(parameters.size())];
+            parameter->setValueNotifyingHost(random.nextFloat());
+        }
+    };
+
+    // Warm up, so any lazy first-use setup happens outside the checked blocks
+    for (int block = 0; block < 32; ++block)
+    {
+        fillBlock(block);
+        plugin.processBlock(buffer, midi);
+    }
+
+    audioThreadAllocations = 0;
+    audioThreadLocks = 0;
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        fillBlock(block);
+        automateParameters();
+
+        {
+            const AudioThreadGuard guard;
+            plugin.processBlock(buffer, midi);
+        }
+
+        // In realtime, give the control scheduler time to apply the changes between some of the blocks
+        if (block % 50 == 0)
+        {
+            juce::Thread::sleep(20);
+        }
+    }
+
+    CHECK(audioThreadAllocations.load() == 0);
+    CHECK(audioThreadLocks.load() == 0);
+
+    plugin.releaseResources();
+}
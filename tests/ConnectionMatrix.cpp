@@ -0,0 +1,137 @@
+#include "dsp/ConnectionMatrix.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <vector>
+
+namespace
+{
+    // Sparse positive weights, on an odd number of nodes so the product leaves a scalar tail
+    ConnectionMatrix makeMatrix(int numNodes, juce::Random &random)
+    {
+        ConnectionMatrix matrix;
+        matrix.resize(numNodes);
+        for (int target = 0; target < numNodes; ++target)
+        {
+            for (int source = 0; source < numNodes; ++source)
+            {
+                if (random.nextFloat() < 0.3f)
+                {
+                    matrix.set(target, source, random.nextFloat());
+                }
+            }
+        }
+        return matrix;
+    }
+
+    float sumColumn(const ConnectionMatrix &matrix, int source, int numTargets)
+    {
+        float sum = 0.0f;
+        for (int target = 0; target < numTargets; ++target)
+        {
+            sum += matrix.get(target, source);
+        }
+        return sum;
+    }
+}
+
+TEST_CASE ("Connection matrix keeps the outgoing sums", "[connections]")
+{
+    using Catch::Matchers::WithinAbs;
+
+    juce::Random random(1234);
+    constexpr int numNodes = 29;
+    auto matrix = makeMatrix(numNodes, random);
+
+    SECTION ("Sums follow every change")
+    {
+        matrix.set(3, 7, 0.5f);
+        matrix.set(11, 7, 0.0f);
+        for (int source = 0; source < numNodes; ++source)
+        {
+            CHECK_THAT (matrix.getOutgoingSum(source), WithinAbs(sumColumn(matrix, source, numNodes), 1.0e-5));
+        }
+    }
+
+    SECTION ("Sums do not drift over many changes")
+    {
+        // Many small changes, as the growth timer makes: the rounding of each must not pile up
+        for (int change = 0; change < 100000; ++change)
+        {
+            const auto target = random.nextInt(numNodes);
+            const auto source = random.nextInt(4);
+            matrix.set(target, source, matrix.get(target, source) + (random.nextFloat() - 0.5f) * 1.0e-3f);
+        }
+        for (int source = 0; source < numNodes; ++source)
+        {
+            CHECK_THAT (matrix.getOutgoingSum(source), WithinAbs(sumColumn(matrix, source, numNodes), 1.0e-5));
+        }
+    }
+
+    SECTION ("Normalising leaves the sum below one")
+    {
+        const auto before = sumColumn(matrix, 5, numNodes);
+        const auto weight = matrix.get(2, 5);
+        matrix.normaliseOutgoing(5, 0.1f);
+
+        CHECK_THAT (matrix.get(2, 5), WithinAbs(weight / (before + 0.1f), 1.0e-6));
+        CHECK_THAT (matrix.getOutgoingSum(5), WithinAbs(sumColumn(matrix, 5, numNodes), 1.0e-5));
+        CHECK (matrix.getOutgoingSum(5) < 1.0f);
+    }
+
+    SECTION ("Inactive nodes are left out")
+    {
+        constexpr int numActiveNodes = 16;
+        matrix.setNumActiveNodes(numActiveNodes);
+        const auto inactiveWeight = matrix.get(numActiveNodes + 1, 4);
+
+        CHECK_THAT (matrix.getOutgoingSum(4), WithinAbs(sumColumn(matrix, 4, numActiveNodes), 1.0e-5));
+        matrix.set(numActiveNodes + 2, 4, 0.75f);
+        CHECK_THAT (matrix.getOutgoingSum(4), WithinAbs(sumColumn(matrix, 4, numActiveNodes), 1.0e-5));
+
+        matrix.normaliseOutgoing(4, 0.1f);
+        CHECK (matrix.get(numActiveNodes + 1, 4) == inactiveWeight);
+
+        // Switching them back on counts them again
+        matrix.setNumActiveNodes(numNodes);
+        CHECK_THAT (matrix.getOutgoingSum(4), WithinAbs(sumColumn(matrix, 4, numNodes), 1.0e-5));
+    }
+}
+
+TEST_CASE ("Connection matrix flows match a direct sum", "[connections]")
+{
+    using Catch::Matchers::WithinAbs;
+
+    juce::Random random(5678);
+    constexpr int numNodes = 29;
+    const auto matrix = makeMatrix(numNodes, random);
+
+    std::vector<float> levels(numNodes);
+    for (auto &level : levels)
+    {
+        level = random.nextFloat();
+    }
+
+    for (const auto numNodesToMix : {numNodes, 16, 3})
+    {
+        std::vector<float> flows(numNodes, -1.0f);
+        matrix.multiply(levels.data(), flows.data(), numNodesToMix);
+
+        for (int target = 0; target < numNodes; ++target)
+        {
+            if (target >= numNodesToMix)
+            {
+                // Targets beyond the mix are not written
+                CHECK (flows[static_cast<size_t>(target)] == -1.0f);
+                continue;
+            }
+
+            float expected = 0.0f;
+            for (int source = 0; source < numNodesToMix; ++source)
+            {
+                expected += matrix.get(target, source) * levels[static_cast<size_t>(source)];
+            }
+            CHECK_THAT (flows[static_cast<size_t>(target)], WithinAbs(expected, 1.0e-5));
+        }
+    }
+}
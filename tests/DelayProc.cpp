@@ -0,0 +1,93 @@
+#include "dsp/DelayProc.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <cmath>
+
+namespace
+{
+    constexpr int numChannels = 2;
+    constexpr int blockSize = 200; // Not a multiple of the control interval
+
+    DelayProc::Parameters makeParameters(float delayMs)
+    {
+        DelayProc::Parameters params {};
+        params.delayMs = delayMs;
+        params.feedback = 0.5f;
+        params.growthRate = 50.0f;
+        params.baseDelayMs = 500.0f;
+        params.filterFreq = 1000.0f;
+        params.filterGainDb = 1.0f;
+        params.revTimeMs = 0.0f;
+        params.envParams = {150.0f, 25.0f, juce::dsp::BallisticsFilterLevelCalculationType::RMS};
+        params.compressorParams = {-20.0f, 4.0f, 10.0f, 100.0f, 6.0f, 0.0f, true};
+        params.useExternalSidechain = false;
+        return params;
+    }
+
+    void process(DelayProc &proc, juce::AudioBuffer<float> &buffer)
+    {
+        juce::dsp::AudioBlock<float> block(buffer);
+        proc.process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+}
+
+// Sleeping nodes (see DelayNodes) skip their silence rather than process it. Their output is
+// silent either way, and they must come out of it in the state processing would have left
+TEST_CASE ("Skipping silence leaves a delay node where processing it would", "[delay]")
+{
+    using Catch::Matchers::WithinAbs;
+
+    DelayProc processed, skipped;
+    for (auto *proc : {&processed, &skipped})
+    {
+        proc->prepare({48000.0, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)});
+        proc->setParameters(makeParameters(20.0f), true);
+
+        // A longer delay that is still ramping in when the input arrives
+        proc->setParameters(makeParameters(40.0f));
+    }
+
+    juce::AudioBuffer<float> silence(numChannels, blockSize);
+    for (int block = 0; block < 50; ++block)
+    {
+        silence.clear();
+        process(processed, silence);
+        skipped.skip(blockSize);
+    }
+
+    // Then the same noise burst, followed by its echoes
+    juce::Random random(1);
+    for (int block = 0; block < 20; ++block)
+    {
+        juce::AudioBuffer<float> expected(numChannels, blockSize);
+        expected.clear();
+        if (block == 0)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    expected.setSample(ch, i, random.nextFloat() - 0.5f);
+                }
+            }
+        }
+        juce::AudioBuffer<float> actual(expected);
+
+        process(processed, expected);
+        process(skipped, actual);
+
+        INFO ("Block " << block);
+        CHECK_THAT (skipped.getAge(), WithinAbs(processed.getAge(), 1.0e-4));
+        CHECK_THAT (skipped.getInputLevel(), WithinAbs(processed.getInputLevel(), 1.0e-4));
+        auto maxError = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                maxError = juce::jmax(maxError, std::abs(actual.getSample(ch, i) - expected.getSample(ch, i)));
+            }
+        }
+        CHECK (maxError < 1.0e-3f);
+    }
+}
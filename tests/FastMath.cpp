@@ -0,0 +1,105 @@
+#include "util/FastMath.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Largest error of a FastMath function against a reference, over evenly spaced arguments
+    template <typename Function, typename Reference>
+    double maxError(float start, float end, float step, Function function, Reference reference, bool relative)
+    {
+        double error = 0.0;
+        for (auto x = start; x < end; x += step)
+        {
+            const auto expected = reference(static_cast<double>(x));
+            const auto difference = std::abs(static_cast<double>(function(x)) - expected);
+            error = std::max(error, relative ? difference / std::abs(expected) : difference);
+        }
+        return error;
+    }
+
+    // Largest difference between an array kernel and libm
+    template <typename Kernel, typename Reference>
+    double maxArrayError(const std::vector<float> &input, Kernel kernel, Reference reference, bool relative)
+    {
+        std::vector<float> output(input.size());
+        kernel(input.data(), output.data(), input.size());
+
+        double error = 0.0;
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            const auto expected = reference(static_cast<double>(input[i]));
+            const auto difference = std::abs(static_cast<double>(output[i]) - expected);
+            error = std::max(error, (relative && expected != 0.0) ? difference / std::abs(expected) : difference);
+        }
+        return error;
+    }
+
+    // An odd length, so the kernels run their scalar tail as well
+    std::vector<float> makeArguments(float start, float end, size_t numValues)
+    {
+        std::vector<float> values(numValues | 1);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = start + (end - start) * static_cast<float>(i) / static_cast<float>(values.size());
+        }
+        return values;
+    }
+
+    double referenceDbToGain(double db) { return db > FastMath::minusInfinityDb ? std::pow(10.0, db / 20.0) : 0.0; }
+    double referenceGainToDb(double gain) { return gain > 0.0 ? std::max(static_cast<double>(FastMath::minusInfinityDb), 20.0 * std::log10(gain)) : FastMath::minusInfinityDb; }
+}
+
+TEST_CASE ("FastMath scalar functions stay close to libm", "[fastmath]")
+{
+    CHECK (maxError(-60.0f, 60.0f, 0.0073f, [](float x) { return FastMath::exp2(x); }, [](double x) { return std::exp2(x); }, true) < 5.0e-6);
+    CHECK (maxError(-20.0f, 20.0f, 0.0031f, [](float x) { return FastMath::exp(x); }, [](double x) { return std::exp(x); }, true) < 5.0e-6);
+    CHECK (maxError(1.0e-6f, 1.0e4f, 0.37f, [](float x) { return FastMath::log2(x); }, [](double x) { return std::log2(x); }, false) < 2.0e-6);
+    CHECK (maxError(1.0e-3f, 10.0f, 0.0007f, [](float x) { return FastMath::log(x); }, [](double x) { return std::log(x); }, false) < 2.0e-6);
+    CHECK (maxError(-20.0f, 20.0f, 0.0011f, [](float x) { return FastMath::sin(x); }, [](double x) { return std::sin(x); }, false) < 1.0e-5);
+    CHECK (maxError(-12.0f, 12.0f, 0.0011f, [](float x) { return FastMath::tanh(x); }, [](double x) { return std::tanh(x); }, false) < 5.0e-6);
+    CHECK (maxError(0.01f, 1.0f, 0.0003f, [](float x) { return FastMath::pow(x, 0.9f); }, [](double x) { return std::pow(x, 0.9); }, true) < 5.0e-6);
+}
+
+TEST_CASE ("FastMath decibel conversions match juce::Decibels", "[fastmath]")
+{
+    CHECK (maxError(-99.0f, 30.0f, 0.013f, [](float x) { return FastMath::dbToGain(x); }, referenceDbToGain, true) < 5.0e-6);
+    CHECK (maxError(1.0e-6f, 100.0f, 0.0097f, [](float x) { return FastMath::gainToDb(x); }, referenceGainToDb, false) < 2.0e-5);
+
+    // Silence maps to the floor and back
+    CHECK (FastMath::dbToGain(FastMath::minusInfinityDb) == 0.0f);
+    CHECK (FastMath::dbToGain(-120.0f) == 0.0f);
+    CHECK (FastMath::gainToDb(0.0f) == FastMath::minusInfinityDb);
+    CHECK (FastMath::gainToDb(-1.0f) == FastMath::minusInfinityDb);
+    CHECK (FastMath::gainToDb(1.0e-9f) == FastMath::minusInfinityDb);
+}
+
+TEST_CASE ("FastMath array kernels stay close to libm", "[fastmath]")
+{
+    CHECK (maxArrayError(makeArguments(-60.0f, 60.0f, 4000), [](auto... a) { FastMath::exp2(a...); }, [](double x) { return std::exp2(x); }, true) < 5.0e-6);
+    CHECK (maxArrayError(makeArguments(-120.0f, 30.0f, 4000), [](auto... a) { FastMath::dbToGain(a...); }, referenceDbToGain, true) < 5.0e-6);
+    CHECK (maxArrayError(makeArguments(-1.0f, 100.0f, 4000), [](auto... a) { FastMath::gainToDb(a...); }, referenceGainToDb, false) < 2.0e-5);
+    CHECK (maxArrayError(makeArguments(-3.0f, 3.0f, 4000), [](auto... a) { FastMath::sinCycles(a...); },
+                         [](double x) { return std::sin(2.0 * 3.14159265358979323846 * x); }, false) < 1.0e-5);
+    CHECK (maxArrayError(makeArguments(-12.0f, 12.0f, 4000), [](auto... a) { FastMath::tanh(a...); }, [](double x) { return std::tanh(x); }, false) < 5.0e-6);
+}
+
+TEST_CASE ("FastMath array kernels agree with the scalar functions", "[fastmath]")
+{
+    const auto input = makeArguments(-30.0f, 30.0f, 1001);
+    std::vector<float> output(input.size());
+
+    FastMath::tanh(input.data(), output.data(), input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        REQUIRE (std::abs(output[i] - FastMath::tanh(input[i])) < 1.0e-6f);
+    }
+
+    FastMath::exp2(input.data(), output.data(), input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        REQUIRE (std::abs(output[i] - FastMath::exp2(input[i])) <= 1.0e-6f * FastMath::exp2(input[i]));
+    }
+}
@@ -0,0 +1,74 @@
+#include "util/ParameterRanges.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // Values across (and a little beyond) a range, plus its ends and centre
+    std::vector<float> makeValues(float start, float end)
+    {
+        std::vector<float> values {start, end, 0.5f * (start + end)};
+        const auto margin = 0.1f * (end - start);
+        for (int i = 0; i <= 1000; ++i)
+        {
+            values.push_back(start - margin + (end - start + 2.0f * margin) * static_cast<float>(i) / 1000.0f);
+        }
+        return values;
+    }
+
+    template <typename Mapping>
+    void checkNormalise(const Mapping &mapping, const juce::NormalisableRange<float> &range)
+    {
+        for (auto value : makeValues(range.start, range.end))
+        {
+            INFO ("value " << value);
+            CHECK (mapping.normalise(value) == range.convertTo0to1(value));
+        }
+    }
+
+    template <typename Mapping>
+    void checkDenormalise(const Mapping &mapping, const juce::NormalisableRange<float> &range)
+    {
+        for (auto proportion : makeValues(0.0f, 1.0f))
+        {
+            INFO ("proportion " << proportion);
+            CHECK (mapping.denormalise(proportion) == range.convertFrom0to1(proportion));
+        }
+    }
+}
+
+TEST_CASE ("Closed-form mappings match their NormalisableRange", "[parameters]")
+{
+    using namespace ParameterRanges;
+
+    SECTION ("Linear")
+    {
+        checkNormalise(scarcityAbundanceMapping, scarcityAbundanceRange);
+        checkDenormalise(scarcityAbundanceMapping, scarcityAbundanceRange);
+        checkNormalise(treeDensityMapping, treeDensityRange);
+        checkDenormalise(treeDensityMapping, treeDensityRange);
+        checkNormalise(dryWetMapping, dryWetRange);
+        checkDenormalise(dryWetMapping, dryWetRange);
+        checkNormalise(delayDuckMapping, delayDuckRange);
+        checkDenormalise(delayDuckMapping, delayDuckRange);
+    }
+
+    SECTION ("Skewed")
+    {
+        checkNormalise(entanglementMapping, entanglementRange);
+        checkDenormalise(entanglementMapping, entanglementRange);
+        checkNormalise(growthRateMapping, growthRateRange);
+        checkDenormalise(growthRateMapping, growthRateRange);
+    }
+
+    SECTION ("Stretch")
+    {
+        checkNormalise(stretchMapping, stretchRange);
+    }
+}
+
+TEST_CASE ("Linear mappings are constant expressions", "[parameters]")
+{
+    static_assert(ParameterRanges::scarcityAbundanceMapping.normalise(0.0f) == 0.5f);
+    static_assert(ParameterRanges::treeDensityMapping.denormalise(0.25f) == 25.0f);
+    SUCCEED();
+}
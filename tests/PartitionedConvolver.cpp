@@ -0,0 +1,108 @@
+#include "dsp/PartitionedConvolver.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr int numBands = 2;
+    constexpr int numChannels = 2;
+
+    // Sparse taps across the direct taps, the head partitions and the later partitions, with
+    // one pair silent up to its third partition so some partitions are skipped
+    std::vector<juce::AudioBuffer<float>> makeResponses(int length, juce::Random &random)
+    {
+        std::vector<juce::AudioBuffer<float>> responses;
+        for (int in = 0; in < numBands; ++in)
+        {
+            juce::AudioBuffer<float> response(numBands, length);
+            response.clear();
+            for (int out = 0; out < numBands; ++out)
+            {
+                for (int i = (in == 0 && out == 1) ? 1100 : 0; i < length; i += 7)
+                {
+                    response.setSample(out, i, random.nextFloat() - 0.5f);
+                }
+            }
+            responses.push_back(std::move(response));
+        }
+        return responses;
+    }
+}
+
+TEST_CASE ("Partitioned convolution matches direct convolution", "[convolution]")
+{
+    constexpr int responseLength = 1700;
+    constexpr int numSamples = 3000;
+
+    juce::Random random(1);
+    const auto responses = makeResponses(responseLength, random);
+
+    PartitionedConvolver convolver;
+    convolver.prepare(numChannels);
+    convolver.setImpulseResponses(responses, numBands, responseLength);
+
+    std::vector<juce::AudioBuffer<float>> inputs;
+    for (int band = 0; band < numBands; ++band)
+    {
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+        inputs.push_back(std::move(input));
+    }
+
+    // Blocks that do not line up with the head blocks or the partitions
+    std::vector<juce::AudioBuffer<float>> outputs(numBands, juce::AudioBuffer<float>(numChannels, numSamples));
+    const int blockSizes[] = {37, 1, 512, 100, 700, 13, 64};
+    for (int pos = 0, block = 0; pos < numSamples; ++block)
+    {
+        const auto blockSize = juce::jmin(blockSizes[block % 7], numSamples - pos);
+        std::vector<juce::AudioBuffer<float>> buffers;
+        for (int band = 0; band < numBands; ++band)
+        {
+            buffers.emplace_back(numChannels, blockSize);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                buffers.back().copyFrom(ch, 0, inputs[band], ch, pos, blockSize);
+            }
+        }
+
+        convolver.process(BufferSpan(buffers), numBands);
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                outputs[band].copyFrom(ch, pos, buffers[band], ch, 0, blockSize);
+            }
+        }
+        pos += blockSize;
+    }
+
+    auto maxError = 0.0;
+    for (int out = 0; out < numBands; ++out)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto expected = 0.0;
+                for (int in = 0; in < numBands; ++in)
+                {
+                    for (int tap = 0; tap < juce::jmin(responseLength, i + 1); ++tap)
+                    {
+                        expected += static_cast<double>(responses[in].getSample(out, tap)) * inputs[in].getSample(ch, i - tap);
+                    }
+                }
+                maxError = juce::jmax(maxError, std::abs(expected - outputs[out].getSample(ch, i)));
+            }
+        }
+    }
+    CHECK (maxError < 1.0e-3);
+}
@@ -0,0 +1,191 @@
+#include "dsp/SimdKernels.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Every level this build and CPU can run
+    std::vector<const SimdKernels::Table *> getAvailableTables()
+    {
+        std::vector<const SimdKernels::Table *> tables;
+        for (size_t level = 0; level < SimdKernels::numLevels; ++level)
+        {
+            if (auto *table = SimdKernels::getTable(static_cast<SimdKernels::Level>(level)))
+            {
+                tables.push_back(table);
+            }
+        }
+        return tables;
+    }
+
+    // Odd lengths, so every vector width leaves a scalar tail
+    std::vector<float> makeNoise(int numSamples, int seed)
+    {
+        juce::Random random(seed);
+        std::vector<float> data(static_cast<size_t>(numSamples));
+        for (auto &sample : data)
+        {
+            sample = random.nextFloat() * 2.0f - 1.0f;
+        }
+        return data;
+    }
+
+    // The levels only differ in vector width and FMA contraction
+    bool nearlyEqual(float a, float b) { return std::abs(a - b) <= 1.0e-5f * juce::jmax(1.0f, std::abs(a), std::abs(b)); }
+
+    bool nearlyEqual(const std::vector<float> &a, const std::vector<float> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (!nearlyEqual(a[i], b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE ("SIMD kernel selection", "[simd]")
+{
+    const auto &initial = SimdKernels::get();
+
+    // The baseline is always there
+    REQUIRE (SimdKernels::getTable(SimdKernels::Level::baseline) != nullptr);
+    REQUIRE (SimdKernels::select(SimdKernels::Level::baseline));
+    CHECK (SimdKernels::getSelectedLevel() == SimdKernels::Level::baseline);
+
+    // A level that is missing is refused and leaves the selection alone
+    for (size_t level = 0; level < SimdKernels::numLevels; ++level)
+    {
+        const auto l = static_cast<SimdKernels::Level>(level);
+        if (SimdKernels::getTable(l) == nullptr)
+        {
+            CHECK_FALSE (SimdKernels::select(l));
+            CHECK (SimdKernels::getSelectedLevel() == SimdKernels::Level::baseline);
+        }
+    }
+
+    // The default is the best level available (unless MYCELIA_SIMD caps it)
+    SimdKernels::selectDefault();
+    INFO ("Selected " << SimdKernels::getLevelName(SimdKernels::getSelectedLevel()));
+    if (juce::SystemStats::getEnvironmentVariable("MYCELIA_SIMD", {}).isEmpty())
+    {
+        CHECK (&SimdKernels::get() == getAvailableTables().back());
+    }
+
+    SimdKernels::select(initial.level);
+}
+
+TEST_CASE ("SIMD kernel levels produce the same output", "[simd]")
+{
+    const auto tables = getAvailableTables();
+    const auto &reference = *tables.front();
+    constexpr int numSamples = 517;
+
+    for (auto *table : tables)
+    {
+        DYNAMIC_SECTION ("Level " << SimdKernels::getLevelName(table->level))
+        {
+            SECTION ("Routing mix")
+            {
+                const auto source = makeNoise(numSamples, 1);
+                auto expected = makeNoise(numSamples, 2);
+                auto actual = expected;
+                reference.addWithGain(expected.data(), source.data(), 0.37f, numSamples);
+                table->addWithGain(actual.data(), source.data(), 0.37f, numSamples);
+                CHECK (nearlyEqual(expected, actual));
+            }
+
+            SECTION ("Peak and level range")
+            {
+                const auto data = makeNoise(numSamples, 3);
+                CHECK (table->getPeak(data.data(), numSamples) == reference.getPeak(data.data(), numSamples));
+
+                for (auto squared : {false, true})
+                {
+                    float expectedMin = 0.0f, expectedMax = 0.0f, actualMin = 0.0f, actualMax = 0.0f;
+                    reference.getLevelRange(data.data(), numSamples, squared, expectedMin, expectedMax);
+                    table->getLevelRange(data.data(), numSamples, squared, actualMin, actualMax);
+                    CHECK (actualMin == expectedMin);
+                    CHECK (actualMax == expectedMax);
+                }
+            }
+
+            SECTION ("Gain ramp mix")
+            {
+                std::vector<std::vector<float>> bands;
+                std::vector<const float *> bandData;
+                for (int band = 0; band < SimdKernels::maxMixBands; ++band)
+                {
+                    bands.push_back(makeNoise(numSamples, 10 + band));
+                }
+                for (auto &band : bands)
+                {
+                    bandData.push_back(band.data());
+                }
+                const auto dry = makeNoise(numSamples, 20);
+                const SimdKernels::GainRamp bandRamps[] = {{1.0f, -0.001f}, {0.5f, 0.0005f}, {0.8f, 0.0f}, {0.2f, 0.0002f}};
+
+                for (int numBands = 0; numBands <= SimdKernels::maxMixBands; ++numBands)
+                {
+                    for (auto *dryData : {static_cast<const float *>(nullptr), dry.data()})
+                    {
+                        std::vector<float> expected(numSamples), actual(numSamples);
+                        reference.mixRamped(expected.data(), bandData.data(), bandRamps, numBands, {0.9f, -0.0001f}, dryData, {0.3f, 0.0001f}, numSamples);
+                        table->mixRamped(actual.data(), bandData.data(), bandRamps, numBands, {0.9f, -0.0001f}, dryData, {0.3f, 0.0001f}, numSamples);
+                        CHECK (nearlyEqual(expected, actual));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE ("SIMD reductions match the scalar loops", "[simd]")
+{
+    // Lengths around every vector width and unrolled step, so each part of the loops is covered
+    for (const auto numSamples : {1, 3, 4, 15, 16, 17, 63, 64, 65, 517})
+    {
+        auto data = makeNoise(numSamples, numSamples);
+        data[static_cast<size_t>(numSamples / 2)] = -0.999f;
+
+        auto peak = 0.0f;
+        float minLevel = std::abs(data[0]), maxLevel = minLevel;
+        float minSquare = data[0] * data[0], maxSquare = minSquare;
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            const auto level = std::abs(data[i]);
+            const auto square = data[i] * data[i];
+            peak = level > peak ? level : peak;
+            if (i > 0)
+            {
+                minLevel = level < minLevel ? level : minLevel;
+                maxLevel = level > maxLevel ? level : maxLevel;
+                minSquare = square < minSquare ? square : minSquare;
+                maxSquare = square > maxSquare ? square : maxSquare;
+            }
+        }
+
+        for (auto *table : getAvailableTables())
+        {
+            INFO ("Level " << SimdKernels::getLevelName(table->level) << ", " << numSamples << " samples");
+            CHECK (table->getPeak(data.data(), numSamples) == peak);
+
+            float min = 0.0f, max = 0.0f;
+            table->getLevelRange(data.data(), numSamples, false, min, max);
+            CHECK (min == minLevel);
+            CHECK (max == maxLevel);
+
+            table->getLevelRange(data.data(), numSamples, true, min, max);
+            CHECK (min == minSquare);
+            CHECK (max == maxSquare);
+        }
+    }
+}